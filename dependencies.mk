@@ -0,0 +1,283 @@
+fetch: src/fetch.cpp include/ef.gy/http.h include/ef.gy/server.h \
+ include/ef.gy/network.h include/ef.gy/cli.h include/ef.gy/version.h \
+ include/ef.gy/client.h
+server: src/server.cpp include/ef.gy/httpd.h include/ef.gy/http.h \
+ include/ef.gy/server.h include/ef.gy/network.h include/ef.gy/cli.h \
+ include/ef.gy/version.h include/ef.gy/client.h include/ef.gy/ircd.h \
+ include/ef.gy/irc.h
+test-case-big-integers: src/test-case/big-integers.cpp include/ef.gy/test-case.h \
+ include/ef.gy/big-integers.h include/ef.gy/numeric.h \
+ include/ef.gy/traits.h
+test-case-cf: src/test-case/cf.cpp include/ef.gy/test-case.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h include/ef.gy/traits.h \
+ include/ef.gy/continued-fractions.h
+test-case-colour-space-hsl: src/test-case/colour-space-hsl.cpp \
+ include/ef.gy/test-case.h include/ef.gy/colour-space-hsl.h \
+ include/ef.gy/colour-space-rgb.h include/ef.gy/vector.h \
+ include/ef.gy/numeric.h include/ef.gy/prng.h
+test-case-cube-mask: src/test-case/cube-mask.cpp include/ef.gy/test-case.h \
+ include/ef.gy/polytope.h include/ef.gy/euclidian.h \
+ include/ef.gy/matrix.h include/ef.gy/vector.h include/ef.gy/polar.h \
+ include/ef.gy/trigonometric.h include/ef.gy/complex.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h include/ef.gy/traits.h include/ef.gy/e.h \
+ include/ef.gy/factorial.h include/ef.gy/series.h \
+ include/ef.gy/sequence.h include/ef.gy/exponential.h \
+ include/ef.gy/range.h
+test-case-culling: src/test-case/culling.cpp include/ef.gy/test-case.h \
+ include/ef.gy/culling.h include/ef.gy/euclidian.h include/ef.gy/matrix.h \
+ include/ef.gy/vector.h include/ef.gy/parametric.h \
+ include/ef.gy/polytope.h include/ef.gy/polar.h \
+ include/ef.gy/trigonometric.h include/ef.gy/complex.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h include/ef.gy/traits.h include/ef.gy/e.h \
+ include/ef.gy/factorial.h include/ef.gy/series.h \
+ include/ef.gy/sequence.h include/ef.gy/exponential.h \
+ include/ef.gy/range.h include/ef.gy/render-svg.h include/ef.gy/painter.h \
+ include/ef.gy/projection.h include/ef.gy/transformation.h \
+ include/ef.gy/stream-svg.h
+test-case-e: src/test-case/e.cpp include/ef.gy/test-case.h \
+ include/ef.gy/primitive.h include/ef.gy/fractions.h \
+ include/ef.gy/big-integers.h include/ef.gy/numeric.h \
+ include/ef.gy/traits.h include/ef.gy/e.h include/ef.gy/factorial.h \
+ include/ef.gy/series.h include/ef.gy/sequence.h \
+ include/ef.gy/exponential.h
+test-case-euclidian: src/test-case/euclidian.cpp include/ef.gy/test-case.h \
+ include/ef.gy/euclidian.h include/ef.gy/matrix.h include/ef.gy/vector.h
+test-case-exponential: src/test-case/exponential.cpp include/ef.gy/test-case.h \
+ include/ef.gy/exponential.h include/ef.gy/traits.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h
+test-case-factorial: src/test-case/factorial.cpp include/ef.gy/test-case.h \
+ include/ef.gy/factorial.h
+test-case-factory: src/test-case/factory.cpp include/ef.gy/test-case.h \
+ include/ef.gy/factory.h include/ef.gy/parametric.h \
+ include/ef.gy/polytope.h include/ef.gy/euclidian.h \
+ include/ef.gy/matrix.h include/ef.gy/vector.h include/ef.gy/polar.h \
+ include/ef.gy/trigonometric.h include/ef.gy/complex.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h include/ef.gy/traits.h include/ef.gy/e.h \
+ include/ef.gy/factorial.h include/ef.gy/series.h \
+ include/ef.gy/sequence.h include/ef.gy/exponential.h \
+ include/ef.gy/range.h include/ef.gy/flame.h include/ef.gy/ifs.h \
+ include/ef.gy/projection.h include/ef.gy/transformation.h \
+ include/ef.gy/prng.h
+test-case-flame: src/test-case/flame.cpp include/ef.gy/test-case.h \
+ include/ef.gy/flame.h include/ef.gy/ifs.h include/ef.gy/polytope.h \
+ include/ef.gy/euclidian.h include/ef.gy/matrix.h include/ef.gy/vector.h \
+ include/ef.gy/polar.h include/ef.gy/trigonometric.h \
+ include/ef.gy/complex.h include/ef.gy/fractions.h \
+ include/ef.gy/big-integers.h include/ef.gy/numeric.h \
+ include/ef.gy/traits.h include/ef.gy/e.h include/ef.gy/factorial.h \
+ include/ef.gy/series.h include/ef.gy/sequence.h \
+ include/ef.gy/exponential.h include/ef.gy/range.h \
+ include/ef.gy/parametric.h include/ef.gy/projection.h \
+ include/ef.gy/transformation.h include/ef.gy/prng.h
+test-case-instances: src/test-case/instances.cpp include/ef.gy/test-case.h \
+ include/ef.gy/instances.h include/ef.gy/factory.h \
+ include/ef.gy/parametric.h include/ef.gy/polytope.h \
+ include/ef.gy/euclidian.h include/ef.gy/matrix.h include/ef.gy/vector.h \
+ include/ef.gy/polar.h include/ef.gy/trigonometric.h \
+ include/ef.gy/complex.h include/ef.gy/fractions.h \
+ include/ef.gy/big-integers.h include/ef.gy/numeric.h \
+ include/ef.gy/traits.h include/ef.gy/e.h include/ef.gy/factorial.h \
+ include/ef.gy/series.h include/ef.gy/sequence.h \
+ include/ef.gy/exponential.h include/ef.gy/range.h include/ef.gy/flame.h \
+ include/ef.gy/ifs.h include/ef.gy/projection.h \
+ include/ef.gy/transformation.h include/ef.gy/prng.h \
+ include/ef.gy/render-raster.h include/ef.gy/culling.h \
+ include/ef.gy/render-flame.h include/ef.gy/render-svg.h \
+ include/ef.gy/painter.h include/ef.gy/stream-svg.h
+test-case-json: src/test-case/json.cpp include/ef.gy/test-case.h \
+ include/ef.gy/render-json.h include/ef.gy/render.h \
+ include/ef.gy/stream-json.h include/ef.gy/json.h
+test-case-markov: src/test-case/markov.cpp include/ef.gy/test-case.h \
+ include/ef.gy/markov.h include/ef.gy/maybe.h
+test-case-matrix-expression: src/test-case/matrix-expression.cpp \
+ include/ef.gy/test-case.h include/ef.gy/matrix-expression.h \
+ include/ef.gy/matrix.h include/ef.gy/transformation.h \
+ include/ef.gy/euclidian.h include/ef.gy/vector.h
+test-case-matrix: src/test-case/matrix.cpp include/ef.gy/test-case.h \
+ include/ef.gy/matrix.h include/ef.gy/range.h
+test-case-maybe: src/test-case/maybe.cpp include/ef.gy/test-case.h \
+ include/ef.gy/maybe.h
+test-case-mesh-cache: src/test-case/mesh-cache.cpp include/ef.gy/test-case.h \
+ include/ef.gy/mesh-cache.h include/ef.gy/factory.h \
+ include/ef.gy/parametric.h include/ef.gy/polytope.h \
+ include/ef.gy/euclidian.h include/ef.gy/matrix.h include/ef.gy/vector.h \
+ include/ef.gy/polar.h include/ef.gy/trigonometric.h \
+ include/ef.gy/complex.h include/ef.gy/fractions.h \
+ include/ef.gy/big-integers.h include/ef.gy/numeric.h \
+ include/ef.gy/traits.h include/ef.gy/e.h include/ef.gy/factorial.h \
+ include/ef.gy/series.h include/ef.gy/sequence.h \
+ include/ef.gy/exponential.h include/ef.gy/range.h include/ef.gy/flame.h \
+ include/ef.gy/ifs.h include/ef.gy/projection.h \
+ include/ef.gy/transformation.h include/ef.gy/prng.h include/ef.gy/mesh.h
+test-case-mesh-export: src/test-case/mesh-export.cpp include/ef.gy/test-case.h \
+ include/ef.gy/mesh-export.h include/ef.gy/euclidian.h \
+ include/ef.gy/matrix.h include/ef.gy/vector.h include/ef.gy/parametric.h \
+ include/ef.gy/polytope.h include/ef.gy/polar.h \
+ include/ef.gy/trigonometric.h include/ef.gy/complex.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h include/ef.gy/traits.h include/ef.gy/e.h \
+ include/ef.gy/factorial.h include/ef.gy/series.h \
+ include/ef.gy/sequence.h include/ef.gy/exponential.h \
+ include/ef.gy/range.h
+test-case-mesh: src/test-case/mesh.cpp include/ef.gy/test-case.h \
+ include/ef.gy/mesh.h include/ef.gy/euclidian.h include/ef.gy/matrix.h \
+ include/ef.gy/vector.h include/ef.gy/prng.h include/ef.gy/parametric.h \
+ include/ef.gy/polytope.h include/ef.gy/polar.h \
+ include/ef.gy/trigonometric.h include/ef.gy/complex.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h include/ef.gy/traits.h include/ef.gy/e.h \
+ include/ef.gy/factorial.h include/ef.gy/series.h \
+ include/ef.gy/sequence.h include/ef.gy/exponential.h \
+ include/ef.gy/range.h
+test-case-painter: src/test-case/painter.cpp include/ef.gy/test-case.h \
+ include/ef.gy/painter.h include/ef.gy/parametric.h \
+ include/ef.gy/polytope.h include/ef.gy/euclidian.h \
+ include/ef.gy/matrix.h include/ef.gy/vector.h include/ef.gy/polar.h \
+ include/ef.gy/trigonometric.h include/ef.gy/complex.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h include/ef.gy/traits.h include/ef.gy/e.h \
+ include/ef.gy/factorial.h include/ef.gy/series.h \
+ include/ef.gy/sequence.h include/ef.gy/exponential.h \
+ include/ef.gy/range.h include/ef.gy/prng.h include/ef.gy/render-svg.h \
+ include/ef.gy/culling.h include/ef.gy/projection.h \
+ include/ef.gy/transformation.h include/ef.gy/stream-svg.h
+test-case-parallel: src/test-case/parallel.cpp include/ef.gy/test-case.h \
+ include/ef.gy/parallel.h include/ef.gy/polytope.h \
+ include/ef.gy/euclidian.h include/ef.gy/matrix.h include/ef.gy/vector.h \
+ include/ef.gy/polar.h include/ef.gy/trigonometric.h \
+ include/ef.gy/complex.h include/ef.gy/fractions.h \
+ include/ef.gy/big-integers.h include/ef.gy/numeric.h \
+ include/ef.gy/traits.h include/ef.gy/e.h include/ef.gy/factorial.h \
+ include/ef.gy/series.h include/ef.gy/sequence.h \
+ include/ef.gy/exponential.h include/ef.gy/range.h \
+ include/ef.gy/parametric.h include/ef.gy/ifs.h \
+ include/ef.gy/projection.h include/ef.gy/transformation.h \
+ include/ef.gy/prng.h include/ef.gy/flame.h
+test-case-parametric: src/test-case/parametric.cpp include/ef.gy/test-case.h \
+ include/ef.gy/parametric.h include/ef.gy/polytope.h \
+ include/ef.gy/euclidian.h include/ef.gy/matrix.h include/ef.gy/vector.h \
+ include/ef.gy/polar.h include/ef.gy/trigonometric.h \
+ include/ef.gy/complex.h include/ef.gy/fractions.h \
+ include/ef.gy/big-integers.h include/ef.gy/numeric.h \
+ include/ef.gy/traits.h include/ef.gy/e.h include/ef.gy/factorial.h \
+ include/ef.gy/series.h include/ef.gy/sequence.h \
+ include/ef.gy/exponential.h include/ef.gy/range.h
+test-case-pi: src/test-case/pi.cpp include/ef.gy/test-case.h \
+ include/ef.gy/primitive.h include/ef.gy/fractions.h \
+ include/ef.gy/big-integers.h include/ef.gy/numeric.h \
+ include/ef.gy/traits.h include/ef.gy/pi.h include/ef.gy/exponential.h \
+ include/ef.gy/series.h include/ef.gy/sequence.h
+test-case-polytope: src/test-case/polytope.cpp include/ef.gy/test-case.h \
+ include/ef.gy/polytope.h include/ef.gy/euclidian.h \
+ include/ef.gy/matrix.h include/ef.gy/vector.h include/ef.gy/polar.h \
+ include/ef.gy/trigonometric.h include/ef.gy/complex.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h include/ef.gy/traits.h include/ef.gy/e.h \
+ include/ef.gy/factorial.h include/ef.gy/series.h \
+ include/ef.gy/sequence.h include/ef.gy/exponential.h \
+ include/ef.gy/range.h include/ef.gy/parametric.h include/ef.gy/ifs.h \
+ include/ef.gy/projection.h include/ef.gy/transformation.h \
+ include/ef.gy/prng.h
+test-case-prng: src/test-case/prng.cpp include/ef.gy/test-case.h \
+ include/ef.gy/prng.h include/ef.gy/flame.h include/ef.gy/ifs.h \
+ include/ef.gy/polytope.h include/ef.gy/euclidian.h \
+ include/ef.gy/matrix.h include/ef.gy/vector.h include/ef.gy/polar.h \
+ include/ef.gy/trigonometric.h include/ef.gy/complex.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h include/ef.gy/traits.h include/ef.gy/e.h \
+ include/ef.gy/factorial.h include/ef.gy/series.h \
+ include/ef.gy/sequence.h include/ef.gy/exponential.h \
+ include/ef.gy/range.h include/ef.gy/parametric.h \
+ include/ef.gy/projection.h include/ef.gy/transformation.h
+test-case-projection: src/test-case/projection.cpp include/ef.gy/test-case.h \
+ include/ef.gy/render-svg.h include/ef.gy/culling.h \
+ include/ef.gy/euclidian.h include/ef.gy/matrix.h include/ef.gy/vector.h \
+ include/ef.gy/painter.h include/ef.gy/projection.h \
+ include/ef.gy/transformation.h include/ef.gy/stream-svg.h \
+ include/ef.gy/polytope.h include/ef.gy/polar.h \
+ include/ef.gy/trigonometric.h include/ef.gy/complex.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h include/ef.gy/traits.h include/ef.gy/e.h \
+ include/ef.gy/factorial.h include/ef.gy/series.h \
+ include/ef.gy/sequence.h include/ef.gy/exponential.h \
+ include/ef.gy/range.h include/ef.gy/prng.h
+test-case-range: src/test-case/range.cpp include/ef.gy/test-case.h \
+ include/ef.gy/range.h
+test-case-render-flame: src/test-case/render-flame.cpp include/ef.gy/test-case.h \
+ include/ef.gy/render-flame.h include/ef.gy/flame.h include/ef.gy/ifs.h \
+ include/ef.gy/polytope.h include/ef.gy/euclidian.h \
+ include/ef.gy/matrix.h include/ef.gy/vector.h include/ef.gy/polar.h \
+ include/ef.gy/trigonometric.h include/ef.gy/complex.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h include/ef.gy/traits.h include/ef.gy/e.h \
+ include/ef.gy/factorial.h include/ef.gy/series.h \
+ include/ef.gy/sequence.h include/ef.gy/exponential.h \
+ include/ef.gy/range.h include/ef.gy/parametric.h \
+ include/ef.gy/projection.h include/ef.gy/transformation.h \
+ include/ef.gy/prng.h
+test-case-render-raster: src/test-case/render-raster.cpp \
+ include/ef.gy/test-case.h include/ef.gy/parametric.h \
+ include/ef.gy/polytope.h include/ef.gy/euclidian.h \
+ include/ef.gy/matrix.h include/ef.gy/vector.h include/ef.gy/polar.h \
+ include/ef.gy/trigonometric.h include/ef.gy/complex.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h include/ef.gy/traits.h include/ef.gy/e.h \
+ include/ef.gy/factorial.h include/ef.gy/series.h \
+ include/ef.gy/sequence.h include/ef.gy/exponential.h \
+ include/ef.gy/range.h include/ef.gy/render-raster.h \
+ include/ef.gy/culling.h include/ef.gy/projection.h \
+ include/ef.gy/transformation.h include/ef.gy/render-flame.h \
+ include/ef.gy/flame.h include/ef.gy/ifs.h include/ef.gy/prng.h
+test-case-render-svg: src/test-case/render-svg.cpp include/ef.gy/test-case.h \
+ include/ef.gy/render-svg.h include/ef.gy/culling.h \
+ include/ef.gy/euclidian.h include/ef.gy/matrix.h include/ef.gy/vector.h \
+ include/ef.gy/painter.h include/ef.gy/projection.h \
+ include/ef.gy/transformation.h include/ef.gy/stream-svg.h \
+ include/ef.gy/polytope.h include/ef.gy/polar.h \
+ include/ef.gy/trigonometric.h include/ef.gy/complex.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h include/ef.gy/traits.h include/ef.gy/e.h \
+ include/ef.gy/factorial.h include/ef.gy/series.h \
+ include/ef.gy/sequence.h include/ef.gy/exponential.h \
+ include/ef.gy/range.h include/ef.gy/prng.h
+test-case-sexp: src/test-case/sexp.cpp include/ef.gy/test-case.h \
+ include/ef.gy/sexp.h include/ef.gy/maybe.h
+test-case-statistics: src/test-case/statistics.cpp include/ef.gy/test-case.h \
+ include/ef.gy/statistics.h include/ef.gy/maybe.h include/ef.gy/numeric.h
+test-case-std-optional: src/test-case/std-optional.cpp include/ef.gy/test-case.h
+test-case-tracer: src/test-case/tracer.cpp include/ef.gy/test-case.h \
+ include/ef.gy/tracer.h include/ef.gy/matrix.h
+test-case-transformation: src/test-case/transformation.cpp \
+ include/ef.gy/test-case.h include/ef.gy/transformation.h \
+ include/ef.gy/euclidian.h include/ef.gy/matrix.h include/ef.gy/vector.h
+test-case-trigonometric: src/test-case/trigonometric.cpp \
+ include/ef.gy/test-case.h include/ef.gy/trigonometric.h \
+ include/ef.gy/complex.h include/ef.gy/fractions.h \
+ include/ef.gy/big-integers.h include/ef.gy/numeric.h \
+ include/ef.gy/traits.h include/ef.gy/e.h include/ef.gy/factorial.h \
+ include/ef.gy/series.h include/ef.gy/sequence.h \
+ include/ef.gy/exponential.h include/ef.gy/range.h
+test-case-unit: src/test-case/unit.cpp include/ef.gy/test-case.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/numeric.h include/ef.gy/traits.h include/ef.gy/units.h \
+ include/ef.gy/exponential.h
+test-case-vector: src/test-case/vector.cpp include/ef.gy/test-case.h \
+ include/ef.gy/vector.h include/ef.gy/polar.h include/ef.gy/euclidian.h \
+ include/ef.gy/matrix.h include/ef.gy/trigonometric.h \
+ include/ef.gy/complex.h include/ef.gy/fractions.h \
+ include/ef.gy/big-integers.h include/ef.gy/numeric.h \
+ include/ef.gy/traits.h include/ef.gy/e.h include/ef.gy/factorial.h \
+ include/ef.gy/series.h include/ef.gy/sequence.h \
+ include/ef.gy/exponential.h
+test-case-xml: src/test-case/xml.cpp include/ef.gy/test-case.h \
+ include/ef.gy/render-xml.h include/ef.gy/render.h include/ef.gy/vector.h \
+ include/ef.gy/stream-xml.h include/ef.gy/xml.h \
+ include/ef.gy/colour-space-hsl.h include/ef.gy/colour-space-rgb.h \
+ include/ef.gy/numeric.h include/ef.gy/continued-fractions.h \
+ include/ef.gy/fractions.h include/ef.gy/big-integers.h \
+ include/ef.gy/traits.h
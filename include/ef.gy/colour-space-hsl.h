@@ -17,6 +17,11 @@
 #if !defined(EF_GY_COLOUR_SPACE_HSL_H)
 #define EF_GY_COLOUR_SPACE_HSL_H
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
 #include <ef.gy/colour-space-rgb.h>
 #include <ef.gy/numeric.h>
 
@@ -46,6 +51,16 @@ public:
   vector(const Q &pHue, const Q &pSaturation, const Q &pLightness)
       : std::array<Q, 3>({pHue, pSaturation, pLightness}), hue((*this)[0]),
         saturation((*this)[1]), lightness((*this)[2]) {}
+  vector(const vector &v)
+      : std::array<Q, 3>({v.hue, v.saturation, v.lightness}), hue((*this)[0]),
+        saturation((*this)[1]), lightness((*this)[2]) {}
+
+  vector &operator=(const vector &v) {
+    hue = v.hue;
+    saturation = v.saturation;
+    lightness = v.lightness;
+    return *this;
+  }
 
   Q &hue;
   Q &saturation;
@@ -71,7 +86,9 @@ public:
 
     Q C = max - min;
     Q h = Q(0);
-    if (max == v.red) {
+    if (C == math::numeric::zero()) {
+      h = Q(0);
+    } else if (max == v.red) {
       h = (v.green - v.blue) / C;
     } else if (max == v.green) {
       h = (v.blue - v.red) / C + Q(2);
@@ -81,6 +98,9 @@ public:
     while (h >= Q(6)) {
       h -= Q(6);
     }
+    if (h < math::numeric::zero()) {
+      h += Q(6);
+    }
 
     hue = h / Q(6);
     lightness = (max + min) / Q(2);
@@ -103,16 +123,17 @@ public:
 
     Q chroma = (Q(1) - a) * saturation;
     Q h = hue * Q(6);
-    Q b = h - Q(1);
+    Q b = h;
     while (b >= Q(2)) {
       b -= Q(2);
     }
+    b -= Q(1);
     if (b < math::numeric::zero()) {
       b = -b;
     }
 
     Q x = chroma * (Q(1) - b);
-    Q r1, g1, b1;
+    Q r1 = Q(0), g1 = Q(0), b1 = Q(0);
     if (h < Q(1)) {
       r1 = chroma;
       g1 = x;
@@ -128,7 +149,7 @@ public:
     } else if (h < Q(5)) {
       r1 = x;
       b1 = chroma;
-    } else if (h < Q(6)) {
+    } else {
       r1 = chroma;
       b1 = x;
     }
@@ -150,6 +171,18 @@ public:
       : std::array<Q, 4>({pHue, pSaturation, pLightness, pAlpha}),
         hue((*this)[0]), saturation((*this)[1]), lightness((*this)[2]),
         alpha((*this)[3]) {}
+  vector(const vector &v)
+      : std::array<Q, 4>({v.hue, v.saturation, v.lightness, v.alpha}),
+        hue((*this)[0]), saturation((*this)[1]), lightness((*this)[2]),
+        alpha((*this)[3]) {}
+
+  vector &operator=(const vector &v) {
+    hue = v.hue;
+    saturation = v.saturation;
+    lightness = v.lightness;
+    alpha = v.alpha;
+    return *this;
+  }
 
   Q &hue;
   Q &saturation;
@@ -159,7 +192,7 @@ public:
   vector(const vector<Q, 4, format::RGB> &v)
       : std::array<Q, 4>(), hue((*this)[0]), saturation((*this)[1]),
         lightness((*this)[2]), alpha((*this)[3]) {
-    vector<Q, 3, format::HSL> hv({v[0], v[1], v[2]});
+    vector<Q, 3, format::HSL> hv(vector<Q, 3, format::RGB>(v[0], v[1], v[2]));
     hue = hv.hue;
     saturation = hv.saturation;
     lightness = hv.lightness;
@@ -168,10 +201,268 @@ public:
 
   operator vector<Q, 4, format::RGB>(void) const {
     vector<Q, 3, format::RGB> rg =
-        vector<Q, 3, format::HSL>({hue, saturation, lightness});
+        vector<Q, 3, format::HSL>(hue, saturation, lightness);
     return {{rg[0], rg[1], rg[2], alpha}};
   }
 };
+
+/**\brief Bulk colour conversions
+ *
+ * Converting colours one vector at a time is fine for the odd colour, but
+ * colour maps and palettes need millions of them. The functions in here
+ * convert whole spans of colours, stored as contiguous, interleaved channels
+ * with an optional alpha channel that is copied as is. Colours are converted
+ * in blocks, without branches, so that the compiler can vectorise the loops.
+ */
+namespace colour {
+/**\brief Colours per block
+ *
+ * Number of colours that are converted at the same time.
+ */
+static constexpr const std::size_t block = 8;
+
+/**\brief Wrap hue
+ *
+ * Only uses truncation and arithmetic, which vectorises, unlike branches or
+ * selects other than minima and maxima.
+ *
+ * \tparam Q Base data type of the hue.
+ *
+ * \param[in] h A hue, as a fraction of a full circle; must fit in an int.
+ *
+ * \returns The hue, moved to [0,1).
+ */
+template <typename Q> static inline Q wrap(Q h) {
+  h -= Q(int(h)) - Q(1);
+  return h - Q(int(h));
+}
+
+/**\brief Convert block of HSL colours to RGB
+ *
+ * Each channel is the lightness plus or minus a piecewise linear function of
+ * the hue, scaled by the saturation; that function is built out of minima and
+ * maxima, so there are no branches.
+ *
+ * \tparam n     Number of channels; 4 with alpha, 3 without.
+ * \tparam lanes Number of colours to convert.
+ * \tparam Q     Base data type of the colours.
+ *
+ * \param[in]  hsl The colours to convert.
+ * \param[out] rgb Where to write the converted colours.
+ */
+template <std::size_t n, std::size_t lanes, typename Q>
+static inline void toRGB(const Q *hsl, Q *rgb) {
+  static_assert(n == 3 || n == 4, "colours must have 3 or 4 channels");
+  Q h[lanes], s[lanes], l[lanes], out[3][lanes];
+  for (std::size_t i = 0; i < lanes; i++) {
+    h[i] = hsl[i * n];
+    s[i] = hsl[i * n + 1];
+    l[i] = hsl[i * n + 2];
+  }
+  for (std::size_t i = 0; i < lanes; i++) {
+    h[i] = wrap(h[i]) * Q(12);
+    const Q m = l[i] < Q(1) - l[i] ? l[i] : Q(1) - l[i];
+    s[i] *= m;
+  }
+  for (std::size_t c = 0; c < 3; c++) {
+    const Q offset = Q((12 - 4 * c) % 12);
+    for (std::size_t i = 0; i < lanes; i++) {
+      Q k = h[i] + offset;
+      k -= Q(12) * Q(int(k / Q(12)));
+      const Q u = k - Q(3), v = Q(9) - k;
+      Q w = u < v ? u : v;
+      w = w < Q(1) ? w : Q(1);
+      w = w > Q(-1) ? w : Q(-1);
+      out[c][i] = l[i] - s[i] * w;
+    }
+  }
+  for (std::size_t i = 0; i < lanes; i++) {
+    rgb[i * n] = out[0][i];
+    rgb[i * n + 1] = out[1][i];
+    rgb[i * n + 2] = out[2][i];
+  }
+  for (std::size_t i = 0; n == 4 && i < lanes; i++) {
+    rgb[i * n + 3] = hsl[i * n + 3];
+  }
+}
+
+/**\brief Convert block of RGB colours to HSL
+ *
+ * The channels are normalised so that the largest one is exactly 1 and the
+ * smallest one is 0; truncating them then picks the hue sector without any
+ * branches, preferring red over green over blue like the HSL vectors do.
+ *
+ * \tparam n     Number of channels; 4 with alpha, 3 without.
+ * \tparam lanes Number of colours to convert.
+ * \tparam Q     Base data type of the colours.
+ *
+ * \param[in]  rgb The colours to convert.
+ * \param[out] hsl Where to write the converted colours.
+ */
+template <std::size_t n, std::size_t lanes, typename Q>
+static inline void toHSL(const Q *rgb, Q *hsl) {
+  static_assert(n == 3 || n == 4, "colours must have 3 or 4 channels");
+  const Q tiny = std::numeric_limits<Q>::min();
+  Q r[lanes], g[lanes], b[lanes], out[3][lanes];
+  for (std::size_t i = 0; i < lanes; i++) {
+    r[i] = rgb[i * n];
+    g[i] = rgb[i * n + 1];
+    b[i] = rgb[i * n + 2];
+  }
+  for (std::size_t i = 0; i < lanes; i++) {
+    const Q rg = r[i] > g[i] ? r[i] : g[i], rg_ = r[i] < g[i] ? r[i] : g[i];
+    const Q max = rg > b[i] ? rg : b[i], min = rg_ < b[i] ? rg_ : b[i];
+    const Q C = max - min;
+    const Q d = C > tiny ? C : tiny;
+    const Q x = (r[i] - min) / d, y = (g[i] - min) / d, z = (b[i] - min) / d;
+
+    const Q wr = Q(int(x));
+    const Q wg = Q(int(y)) * (Q(1) - wr);
+    const Q wb = Q(int(z)) * (Q(1) - wr) * (Q(1) - wg);
+    Q h = wr * (y - z) + wg * (z - x + Q(2)) + wb * (x - y + Q(4)) + Q(6);
+    h -= Q(6) * Q(int(h / Q(6)));
+
+    const Q l = (max + min) / Q(2);
+    Q a = Q(2) * (l < Q(1) - l ? l : Q(1) - l);
+    a = a > tiny ? a : tiny;
+    out[0][i] = h / Q(6);
+    out[1][i] = C / a;
+    out[2][i] = l;
+  }
+  for (std::size_t i = 0; i < lanes; i++) {
+    hsl[i * n] = out[0][i];
+    hsl[i * n + 1] = out[1][i];
+    hsl[i * n + 2] = out[2][i];
+  }
+  for (std::size_t i = 0; n == 4 && i < lanes; i++) {
+    hsl[i * n + 3] = rgb[i * n + 3];
+  }
+}
+
+/**\brief Convert HSL colours to RGB
+ *
+ * Converts a span of HSL or HSLA colours to RGB or RGBA colours; produces the
+ * same colours as the conversion operators of the HSL vectors, except that
+ * the hue is wrapped around instead of being expected in [0,1].
+ *
+ * \tparam n Number of channels; 4 with alpha, 3 without.
+ * \tparam Q Base data type of the colours.
+ *
+ * \param[in]  hsl     The colours to convert.
+ * \param[out] rgb     Where to write the converted colours; may be hsl.
+ * \param[in]  colours Number of colours to convert.
+ */
+template <std::size_t n = 3, typename Q>
+static void toRGB(const Q *hsl, Q *rgb, std::size_t colours) {
+  std::size_t i = 0;
+  for (; i + block <= colours; i += block, hsl += block * n, rgb += block * n) {
+    toRGB<n, block>(hsl, rgb);
+  }
+  for (; i < colours; i++, hsl += n, rgb += n) {
+    toRGB<n, 1>(hsl, rgb);
+  }
+}
+
+/**\brief Convert RGB colours to HSL
+ *
+ * Converts a span of RGB or RGBA colours to HSL or HSLA colours; produces the
+ * same colours as the HSL vector constructors.
+ *
+ * \tparam n Number of channels; 4 with alpha, 3 without.
+ * \tparam Q Base data type of the colours.
+ *
+ * \param[in]  rgb     The colours to convert.
+ * \param[out] hsl     Where to write the converted colours; may be rgb.
+ * \param[in]  colours Number of colours to convert.
+ */
+template <std::size_t n = 3, typename Q>
+static void toHSL(const Q *rgb, Q *hsl, std::size_t colours) {
+  std::size_t i = 0;
+  for (; i + block <= colours; i += block, rgb += block * n, hsl += block * n) {
+    toHSL<n, block>(rgb, hsl);
+  }
+  for (; i < colours; i++, rgb += n, hsl += n) {
+    toHSL<n, 1>(rgb, hsl);
+  }
+}
+
+/**\brief HSL to 8-bit RGB converter
+ *
+ * Converts HSL colours to 8 bits per channel, looking up the shape of the
+ * channels over the hue in a table instead of calculating it. The hue is
+ * rounded to one of 'hues' steps, so with the default of 1536 steps the
+ * result is within one of what toRGB() yields.
+ *
+ * \tparam Q    Base data type of the colours.
+ * \tparam hues Number of hues in the table.
+ */
+template <typename Q = float, std::size_t hues = 1536> class rgb8 {
+public:
+  /**\brief Construct with table
+   *
+   * Fills the lookup table; this is the expensive part, so converters should
+   * be reused.
+   */
+  rgb8(void) {
+    for (std::size_t i = 0; i < hues; i++) {
+      const Q hsl[3] = {Q(i) / Q(hues), Q(1), Q(0.5)};
+      Q rgb[3];
+      toRGB<3, 1>(hsl, rgb);
+      for (std::size_t c = 0; c < 3; c++) {
+        table[i][c] = (Q(1) - Q(2) * rgb[c]) * Q(255);
+      }
+    }
+    table[hues] = table[0];
+  }
+
+  /**\brief Convert colours
+   *
+   * Converts a span of HSL or HSLA colours to RGB or RGBA colours with 8 bits
+   * per channel, clamping the results to [0,255].
+   *
+   * \tparam n Number of channels; 4 with alpha, 3 without.
+   *
+   * \param[in]  hsl     The colours to convert.
+   * \param[out] rgb     Where to write the converted colours.
+   * \param[in]  colours Number of colours to convert.
+   */
+  template <std::size_t n = 3>
+  void operator()(const Q *hsl, std::uint8_t *rgb, std::size_t colours) const {
+    static_assert(n == 3 || n == 4, "colours must have 3 or 4 channels");
+    for (std::size_t i = 0; i < colours; i++, hsl += n, rgb += n) {
+      const Q l = hsl[2];
+      const Q a = hsl[1] * (l < Q(1) - l ? l : Q(1) - l);
+      const auto &w = table[std::size_t(wrap(hsl[0]) * Q(hues) + Q(0.5))];
+      for (std::size_t c = 0; c < 3; c++) {
+        rgb[c] = channel(l * Q(255) - a * w[c]);
+      }
+      if (n == 4) {
+        rgb[3] = channel(hsl[3] * Q(255));
+      }
+    }
+  }
+
+protected:
+  /**\brief Channel shapes
+   *
+   * Offset of each channel from the lightness for each hue, for a colour with
+   * full saturation and a lightness of 1/2, scaled to 8 bits; an extra entry
+   * at the end repeats the first hue, for hues that round up to 1.
+   */
+  std::array<std::array<Q, 3>, hues + 1> table;
+
+  /**\brief Round channel
+   *
+   * \param[in] v A channel value, scaled to [0,255].
+   *
+   * \returns v, rounded and clamped to 8 bits.
+   */
+  static std::uint8_t channel(Q v) {
+    v += Q(0.5);
+    return std::uint8_t(v < Q(0) ? Q(0) : v > Q(255) ? Q(255) : v);
+  }
+};
+};
 };
 };
 
@@ -0,0 +1,184 @@
+/**\file
+ * \brief Face culling
+ *
+ * Contains a culling stage for renderers with 2D output, which drops faces
+ * that would not be visible anyway before they are written out: faces that
+ * point away from the viewer and faces that are entirely outside of the
+ * view. It also counts the faces that it lets through and those it drops,
+ * so renderers can report how much work was saved in each frame.
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#if !defined(EF_GY_CULLING_H)
+#define EF_GY_CULLING_H
+
+#include <ef.gy/euclidian.h>
+#include <array>
+#include <cstddef>
+
+namespace efgy {
+namespace render {
+/**\brief Culling stage
+ *
+ * Decides whether projected faces are visible. Faces are given in image
+ * coordinates, with the y axis pointing down, as in SVG and raster images.
+ * Both tests are disabled by default, in which case all faces are emitted
+ * and only counted.
+ *
+ * Back-face culling uses the winding of the projected face, so it only makes
+ * sense for closed models whose faces are all wound the same way when seen
+ * from the outside.
+ *
+ * \tparam Q Base type for calculations.
+ */
+template <typename Q> class culling {
+public:
+  /**\brief Face winding
+   *
+   * The order in which the vertices of faces that point towards the viewer
+   * appear in the image.
+   */
+  enum winding {
+    /**\brief Both windings are visible; no back-face culling. */
+    any,
+    /**\brief Visible faces are wound clockwise. */
+    clockwise,
+    /**\brief Visible faces are wound counterclockwise. */
+    counterClockwise
+  };
+
+  /**\brief Default constructor
+   *
+   * Creates a culling stage that does not cull anything.
+   */
+  culling(void)
+      : front(any), frustum(false), emitted(0), backFacing(0), outside(0),
+        behind(0) {}
+
+  /**\brief Front face winding
+   *
+   * Faces with the opposite winding, and those that are seen edge-on, are
+   * culled, unless this is 'any'.
+   */
+  winding front;
+
+  /**\brief Cull against view?
+   *
+   * Whether to drop faces that are entirely outside of the view rectangle.
+   */
+  bool frustum;
+
+  /**\brief View rectangle
+   *
+   * The corners of the visible part of the image, with the smallest and
+   * largest coordinates respectively.
+   */
+  std::array<math::vector<Q, 2>, 2> view;
+
+  /**\brief Emitted faces
+   *
+   * Number of faces that passed all tests since the last reset().
+   */
+  std::size_t emitted;
+
+  /**\brief Back faces
+   *
+   * Number of faces that were culled because of their winding.
+   */
+  std::size_t backFacing;
+
+  /**\brief Faces outside the view
+   *
+   * Number of faces that were culled because they were outside of the view
+   * rectangle.
+   */
+  std::size_t outside;
+
+  /**\brief Faces behind the eye
+   *
+   * Number of faces that the renderer's projection rejected before they got
+   * to this stage; counted here so all the statistics are in one place.
+   */
+  std::size_t behind;
+
+  /**\brief Set view rectangle
+   *
+   * Sets the view rectangle and enables culling against it.
+   *
+   * \param[in] pMin The corner of the view with the smallest coordinates.
+   * \param[in] pMax The corner of the view with the largest coordinates.
+   */
+  void clip(const math::vector<Q, 2> &pMin, const math::vector<Q, 2> &pMax) {
+    view = {{pMin, pMax}};
+    frustum = true;
+  }
+
+  /**\brief Reset statistics
+   *
+   * Called by renderers at the start of every frame.
+   */
+  void reset(void) {
+    emitted = 0;
+    backFacing = 0;
+    outside = 0;
+    behind = 0;
+  }
+
+  /**\brief Culled faces
+   *
+   * \returns The number of faces that were dropped since the last reset().
+   */
+  std::size_t culled(void) const { return backFacing + outside + behind; }
+
+  /**\brief Test face
+   *
+   * Decides whether a face is visible and updates the statistics.
+   *
+   * \tparam q Number of vertices of the face.
+   *
+   * \param[in] V The vertices of the face, in image coordinates.
+   *
+   * \returns True if the face should be drawn.
+   */
+  template <std::size_t q>
+  bool operator()(const std::array<math::vector<Q, 2>, q> &V) {
+    if (front != any && q >= 3) {
+      Q area = Q(0);
+      for (std::size_t i = 0, j = q - 1; i < q; j = i++) {
+        area += V[j][0] * V[i][1] - V[i][0] * V[j][1];
+      }
+      if (front == counterClockwise ? !(area < Q(0)) : !(area > Q(0))) {
+        backFacing++;
+        return false;
+      }
+    }
+
+    if (frustum) {
+      for (std::size_t k = 0; k < 2; k++) {
+        bool below = true, above = true;
+        for (const auto &v : V) {
+          below = below && v[k] < view[0][k];
+          above = above && v[k] > view[1][k];
+        }
+        if (below || above) {
+          outside++;
+          return false;
+        }
+      }
+    }
+
+    emitted++;
+    return true;
+  }
+};
+}
+}
+
+#endif
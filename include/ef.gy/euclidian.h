@@ -23,6 +23,8 @@
 #include <ef.gy/vector.h>
 #include <array>
 #include <cmath>
+#include <type_traits>
+#include <utility>
 
 namespace efgy {
 namespace math {
@@ -113,6 +115,108 @@ constexpr math::vector<F, 3> crossProduct(const math::vector<F, 3> &a,
            a[0] * b[1] - a[1] * b[0]}};
 }
 
+/**\brief Calculate normal by Gaussian elimination
+ *
+ * Calculates the same vector as normal(), i.e. the vector n so that the
+ * dot product of n and any x is the determinant of the matrix with x as
+ * its first row and the input vectors as the remaining rows.
+ *
+ * The input vectors are reduced to an upper trapezoidal matrix U with
+ * complete pivoting; that only changes the determinant by the sign of the
+ * row and column permutations and leaves a vector z with z * U = 0 that
+ * can be read off with a single back substitution. Scaling z by the
+ * product of the pivots gives the normal.
+ *
+ * \tparam Q The base type for calculations; must be a floating point type.
+ * \tparam d The number of dimensions of the input vectors.
+ *
+ * \param[in] pV An array of (d-1) d-space vectors.
+ *
+ * \returns One of the vectors perpendicular to the given input vectors,
+ *          or the zero vector if the input vectors are linearly dependent.
+ */
+template <typename Q, unsigned int d>
+math::vector<Q, d>
+eliminationNormal(const std::array<math::vector<Q, d>, d - 1> &pV) {
+  math::matrix<Q, d - 1, d> u;
+  std::array<unsigned int, d> column;
+  Q sign = (d % 2) == 1 ? Q(1) : Q(-1);
+  Q pivots = Q(1);
+
+  for (unsigned int i = 0; i < (d - 1); i++) {
+    for (unsigned int j = 0; j < d; j++) {
+      u[i][j] = pV[i][j];
+    }
+  }
+
+  for (unsigned int j = 0; j < d; j++) {
+    column[j] = j;
+  }
+
+  for (unsigned int k = 0; k < (d - 1); k++) {
+    unsigned int pr = k, pc = k;
+    Q max = Q(0);
+
+    for (unsigned int i = k; i < (d - 1); i++) {
+      for (unsigned int j = k; j < d; j++) {
+        const Q a = std::fabs(u[i][j]);
+        if (a > max) {
+          max = a;
+          pr = i;
+          pc = j;
+        }
+      }
+    }
+
+    if (max == Q(0)) {
+      return math::vector<Q, d>();
+    }
+
+    if (pr != k) {
+      for (unsigned int j = 0; j < d; j++) {
+        std::swap(u[k][j], u[pr][j]);
+      }
+      sign = -sign;
+    }
+
+    if (pc != k) {
+      for (unsigned int i = 0; i < (d - 1); i++) {
+        std::swap(u[i][k], u[i][pc]);
+      }
+      std::swap(column[k], column[pc]);
+      sign = -sign;
+    }
+
+    pivots *= u[k][k];
+
+    for (unsigned int i = k + 1; i < (d - 1); i++) {
+      const Q l = u[i][k] / u[k][k];
+      for (unsigned int j = k + 1; j < d; j++) {
+        u[i][j] -= l * u[k][j];
+      }
+    }
+  }
+
+  std::array<Q, d> z;
+  z[d - 1] = Q(1);
+
+  for (unsigned int k = d - 1; k-- > 0;) {
+    Q s = u[k][d - 1];
+    for (unsigned int j = k + 1; j < (d - 1); j++) {
+      s += u[k][j] * z[j];
+    }
+    z[k] = -s / u[k][k];
+  }
+
+  math::vector<Q, d> rv;
+
+  for (unsigned int j = 0; j < d; j++) {
+    rv[column[j]] = sign * pivots * z[j];
+  }
+
+  return rv;
+}
+
 /**\brief Calculate normal
  *
  * Given any (d-1) d-space vectors, this function will calculate one of
@@ -121,10 +225,15 @@ constexpr math::vector<F, 3> crossProduct(const math::vector<F, 3> &a,
  * implicit Laplace expansion of a specially crafted matrix to calculate
  * the normal.
  *
- * \note We only calculate the first step of the Laplace expansion
- *       manually. However, since the matrix code's determinant()
- *       also uses a Laplace expansion at this point, the code will run
- *       very slowly with 10-space vectors or higher.
+ * For floating point types, the normal is calculated with a single
+ * Gaussian elimination of the input vectors instead, which only needs
+ * O(d^3) operations; see eliminationNormal(). The result is the same
+ * vector, including its length and orientation.
+ *
+ * \note For all other types we only calculate the first step of the
+ *       Laplace expansion manually. However, since the matrix code's
+ *       determinant() also uses a Laplace expansion at this point, the
+ *       code will run very slowly with 10-space vectors or higher.
  *
  * \tparam Q The base type for calculations
  * \tparam d The number of dimensions of the input vectors.
@@ -138,6 +247,10 @@ constexpr math::vector<F, 3> crossProduct(const math::vector<F, 3> &a,
  */
 template <typename Q, unsigned int d>
 math::vector<Q, d> normal(const std::array<math::vector<Q, d>, d - 1> &pV) {
+  if constexpr (std::is_floating_point<Q>::value) {
+    return eliminationNormal(pV);
+  }
+
   math::matrix<Q, d, d> pM;
   std::array<math::vector<Q, d>, d> baseVectors;
 
@@ -199,6 +312,44 @@ normal(const std::array<math::vector<Q, 3>, 2> &pV) {
   return crossProduct(pV[0], pV[1]);
 }
 
+/**\brief Calculate face normals
+ *
+ * Calculates the normals of a sequence of faces, each of which is given by
+ * at least d vertices; the normal of a face is the normal of the edges from
+ * its first vertex to the next (d-1) vertices, which is how the renderers
+ * calculate the normal of a polygon. This works like std::transform(), so
+ * the results can be written to a preallocated buffer or a back inserter.
+ *
+ * \tparam Q        The base type for calculations.
+ * \tparam d        The number of dimensions of the vertices.
+ * \tparam iterator Input iterator over the faces.
+ * \tparam output   Output iterator for the normals.
+ *
+ * \param[in]  begin  The first face.
+ * \param[in]  end    Past the last face.
+ * \param[out] result Where to write the normals to.
+ *
+ * \returns The output iterator, past the last normal.
+ */
+template <typename Q, unsigned int d, typename iterator, typename output>
+output normals(iterator begin, iterator end, output result) {
+  std::array<math::vector<Q, d>, d - 1> edges;
+
+  for (; begin != end; ++begin, ++result) {
+    const auto &face = *begin;
+
+    for (unsigned int i = 0; i < (d - 1); i++) {
+      for (unsigned int j = 0; j < d; j++) {
+        edges[i][j] = face[i + 1][j] - face[0][j];
+      }
+    }
+
+    *result = normal<Q, d>(edges);
+  }
+
+  return result;
+}
+
 /**\brief Calculate perpendicular vector (2-space)
  *
  * Given any one 2D real-space vector, this function will return one of
@@ -25,10 +25,12 @@
 #include <ef.gy/parametric.h>
 #include <ef.gy/flame.h>
 
+#include <array>
 #include <set>
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <utility>
 
 namespace efgy {
 namespace geometry {
@@ -268,6 +270,13 @@ public:
  * A helper for geometry::with, which provides a ::with method that has
  * the type already specified as a template argument.
  *
+ * Which depth and render depth combinations the model supports is
+ * worked out at compile time, and stored in a table of pointers to
+ * func::apply for each combination, indexed by the depth and render
+ * depth; invalid combinations have a null pointer. Requests for a
+ * specific depth and render depth are thus answered with a single
+ * lookup.
+ *
  * \tparam Q      Base data type for calculations
  * \tparam func   The function to call.
  * \tparam T      Model template, e.g. efgy::geometry::cube
@@ -283,139 +292,120 @@ template <
     typename format>
 class model {
 public:
+  /**\brief Functor argument type
+   *
+   * The same for all depths and render depths.
+   */
+  using argument = typename func<Q, T, d, e, format>::argument;
+
+  /**\brief Functor return type
+   *
+   * The same for all depths and render depths.
+   */
+  using output = typename func<Q, T, d, e, format>::output;
+
   /**\brief Call func with parameters
    *
-   * Calls func::pass(arg) or func::apply(arg), depending on
-   * whether the function can resolve the conundrum posed by the
-   * dimensionality parameters.
+   * Calls func::apply(arg) for every supported combination of depth
+   * and render depth, up to d and e, that matches the target
+   * dimensions; a target of 0 matches any number of dimensions.
+   * Combinations are visited with the depth going down first, then
+   * the render depth.
    *
    * \param[out] arg   The argument to func::...().
    * \param[in]  dims  The target number of model dimensions.
    * \param[in]  rdims The target number of render dimensions.
    * \param[in]  tag   The vector format tag instance to use.
    *
-   * \returns The return value of either func::pass or
-   *          func::apply, depending on whether the call
-   *          'succeeded'.
+   * \returns The return value of func::pass, after all calls to
+   *          func::apply.
    */
-  constexpr static typename func<Q, T, d, e, format>::output
-  with(typename func<Q, T, d, e, format>::argument arg,
-       const std::size_t &dims, const std::size_t &rdims, const format &tag) {
-    return d < T<Q, d>::dimensions::modelDimensionMinimum
-               ? func<Q, T, d, e, format>::pass(arg)
-               : (T<Q, d>::dimensions::modelDimensionMaximum > 0) &&
-                     (d > T<Q, d>::dimensions::modelDimensionMaximum)
-               ? model<Q, func, T, d - 1, e, format>::with(arg, dims, rdims,
-                                                           tag)
-               : e < T<Q, d>::renderDepth
-               ? model<Q, func, T, d - 1, e, format>::with(arg, dims, rdims,
-                                                           tag)
-               : 0 == rdims
-               ? (0 == dims ? func<Q, T, d, e, format>::apply(arg, tag),
-                  model<Q, func, T, d, e - 1, format>::with(arg, dims, rdims,
-                                                            tag),
-                  model<Q, func, T, d - 1, e, format>::with(arg, dims, rdims,
-                                                            tag)
-: d == dims
-                      ? func<Q, T, d, e, format>::apply(arg, tag),
-                  model<Q, func, T, d, e - 1, format>::with(arg, dims, rdims,
-                                                            tag)
-: d < dims
-                      ? func<Q, T, d, e, format>::pass(arg)
-                      : model<Q, func, T, d - 1, e, format>::with(arg, dims,
-                                                                  rdims, tag))
-               : e == rdims
-               ? (0 == dims ? func<Q, T, d, e, format>::apply(arg, tag),
-                  model<Q, func, T, d - 1, e, format>::with(arg, dims, rdims,
-                                                            tag)
-: d == dims
-                      ? func<Q, T, d, e, format>::apply(arg, tag),
-                  model<Q, func, T, d, e - 1, format>::with(arg, dims, rdims,
-                                                            tag)
-: d < dims
-                      ? func<Q, T, d, e, format>::pass(arg)
-                      : model<Q, func, T, d - 1, e, format>::with(arg, dims,
-                                                                  rdims, tag))
-               : e < rdims
-               ? func<Q, T, d, e, format>::pass(arg)
-               : model<Q, func, T, d, e - 1, format>::with(arg, dims, rdims,
-                                                           tag);
+  static output with(argument arg, const std::size_t &dims,
+                     const std::size_t &rdims, const format &tag) {
+    if (dims > d || rdims > e) {
+      return func<Q, T, d, e, format>::pass(arg);
+    }
+
+    const std::size_t dmin = dims > 0 ? dims : 1;
+    const std::size_t emin = rdims > 0 ? rdims : 1;
+
+    for (std::size_t md = dims > 0 ? dims : d; md >= dmin; md--) {
+      for (std::size_t me = rdims > 0 ? rdims : e; me >= emin; me--) {
+        const function f = table[md * (e + 1) + me];
+        if (f) {
+          f(arg, tag);
+        }
+      }
+    }
+
+    return func<Q, T, d, e, format>::pass(arg);
   }
-};
 
-/**\brief Model factory helper; e=1 fix point
- *
- * The model factory helper, geometry::model, works by calling itself
- * recursively with different template parameters. This is one of these
- * parameters' fix points, which prevents an infinite template
- * recursion.
- *
- * \tparam Q      Base data type for calculations
- * \tparam func   The function to call.
- * \tparam T      Model template, e.g. efgy::geometry::cube
- * \tparam d      Model depth, e.g. 4 for a tesseract
- * \tparam format Vector coordinate format to work in.
- */
-template <
-    typename Q, template <typename, template <class, std::size_t> class,
-                          std::size_t, std::size_t, typename> class func,
-    template <class, std::size_t> class T, std::size_t d, typename format>
-class model<Q, func, T, d, 1, format> {
-public:
-  /**\brief Call func with parameters; e=1 fix point
+protected:
+  /**\brief Pointer to func::apply
    *
-   * This is a fix point stub of the model::with() method; all
-   * arguments but the first are ignored and this fix point will
-   * simply return the result of applying func's pass method to
-   * the first argument.
+   * The type of the table entries.
+   */
+  using function = output (*)(argument, const format &);
+
+  /**\brief Is combination supported?
    *
-   * \param[in] arg The argument that is passed to the functor.
+   * \tparam md Model depth.
+   * \tparam me Model render depth.
    *
-   * \returns func::pass(arg).
+   * \returns True if the model supports the given depth and can be
+   *          rendered with the given render depth.
    */
-  constexpr static typename func<Q, T, d, 1, format>::output
-  with(typename func<Q, T, d, 1, format>::argument arg, const std::size_t &,
-       const std::size_t &, const format &) {
-    return func<Q, T, d, 1, format>::pass(arg);
+  template <std::size_t md, std::size_t me>
+  static constexpr bool supported(void) {
+    if constexpr (md == 0 || me < 2) {
+      return false;
+    } else {
+      using dimensions = typename T<Q, md>::dimensions;
+      return md >= dimensions::modelDimensionMinimum &&
+             (dimensions::modelDimensionMaximum == 0 ||
+              md <= dimensions::modelDimensionMaximum) &&
+             me >= T<Q, md>::renderDepth;
+    }
   }
-};
 
-/**\brief Model factory helper; d=0 fix point
- *
- * The model factory helper, geometry::model, works by calling itself
- * recursively with different template parameters. This is one of these
- * parameters' fix points, which prevents an infinite template
- * recursion.
- *
- * \tparam Q      Base data type for calculations
- * \tparam func   The function to call.
- * \tparam T      Model template, e.g. efgy::geometry::cube
- * \tparam e      Model render depth, e.g. >= 4 when rendering a
- *                tesseract
- * \tparam format Vector coordinate format to work in.
- */
-template <
-    typename Q, template <typename, template <class, std::size_t> class,
-                          std::size_t, std::size_t, typename> class func,
-    template <class, std::size_t> class T, std::size_t e, typename format>
-class model<Q, func, T, 0, e, format> {
-public:
-  /**\brief Call func with parameters; d=1 fix point
+  /**\brief Table entry
    *
-   * This is a fix point stub of the model::with() method; all
-   * arguments but the first are ignored and this fix point will
-   * simply return the result of applying func's pass method to
-   * the first argument.
+   * \tparam i Index of the entry; the depth times (e+1), plus the
+   *           render depth.
    *
-   * \param[in] arg The argument that is passed to the functor.
+   * \returns func::apply for the combination, or a null pointer if it
+   *          is not supported.
+   */
+  template <std::size_t i> static constexpr function entry(void) {
+    constexpr const std::size_t md = i / (e + 1);
+    constexpr const std::size_t me = i % (e + 1);
+    if constexpr (supported<md, me>()) {
+      return func<Q, T, md, me, format>::apply;
+    } else {
+      return nullptr;
+    }
+  }
+
+  /**\brief Build table
+   *
+   * \tparam i Indices of all the table entries.
    *
-   * \returns func::pass(arg).
+   * \returns The table of func::apply pointers.
    */
-  constexpr static typename func<Q, T, 0, e, format>::output
-  with(typename func<Q, T, 0, e, format>::argument arg, const std::size_t &,
-       const std::size_t &, const format &) {
-    return func<Q, T, 0, e, format>::pass(arg);
+  template <std::size_t... i>
+  static constexpr std::array<function, (d + 1) * (e + 1)>
+  build(std::index_sequence<i...>) {
+    return {{entry<i>()...}};
   }
+
+  /**\brief Dispatch table
+   *
+   * Pointers to func::apply for each supported combination of depth
+   * and render depth.
+   */
+  static constexpr const std::array<function, (d + 1) * (e + 1)> table =
+      build(std::make_index_sequence<(d + 1) * (e + 1)>());
 };
 
 /**\brief Call template function with class type
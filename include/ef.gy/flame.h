@@ -19,6 +19,10 @@
 #define EF_GY_FLAME_H
 
 #include <ef.gy/ifs.h>
+#include <ef.gy/prng.h>
+#include <array>
+#include <cmath>
+#include <functional>
 
 namespace efgy {
 namespace geometry {
@@ -26,53 +30,291 @@ namespace transformation {
 /**\brief Fractal flame transformation
  *
  * These transformations are based on the 'Fractal Flame Algorithm' paper by
- * Scott Draves and Eric Reckase.
- *
- * \todo This implementation is still incomplete, and currently only implements
- *     the first 19 variations (up to "exponential"), so this could do with some
- *     extra love.
+ * Scott Draves and Eric Reckase, and implement all of the 49 variations
+ * described there. The first 19 variations (up to "exponential") have been
+ * generalised to higher dimensions; the remaining ones work in the plane of
+ * the first two coordinates and leave all other coordinates alone.
  *
  * \see http://flam3.com/flame_draves.pdf for the original paper.
  */
 template <typename Q, std::size_t d> class flame : public affine<Q, d> {
 public:
-  flame(std::size_t pDepth = d) : depth(pDepth) {}
+  flame(std::size_t pDepth = d) : depth(pDepth) {
+    for (std::size_t i = 0; i < coefficients; i++) {
+      coefficient[i] = Q(0);
+      for (auto &q : parameter[i]) {
+        q = Q(0);
+      }
+    }
+
+    // "blob": high, low, waves
+    parameter[23][0] = Q(1);
+    parameter[23][1] = Q(0.5);
+    parameter[23][2] = Q(5);
+    // "pdj": a, b, c, d
+    parameter[24][0] = Q(1);
+    parameter[24][1] = Q(2);
+    parameter[24][2] = Q(1.5);
+    parameter[24][3] = Q(0.5);
+    // "fan2": x, y
+    parameter[25][0] = Q(0.5);
+    parameter[25][1] = Q(1);
+    // "rings2": val
+    parameter[26][0] = Q(0.5);
+    // "perspective": angle, distance
+    parameter[30][0] = Q(0.5);
+    parameter[30][1] = Q(2);
+    // "julian" and "juliascope": power, distance
+    parameter[32][0] = parameter[33][0] = Q(3);
+    parameter[32][1] = parameter[33][1] = Q(1);
+    // "radial blur": angle
+    parameter[36][0] = Q(0.5);
+    // "pie": slices, rotation, thickness
+    parameter[37][0] = Q(6);
+    parameter[37][2] = Q(0.5);
+    // "ngon": power, sides, corners, circle
+    parameter[38][0] = Q(2);
+    parameter[38][1] = Q(5);
+    parameter[38][2] = Q(0.3);
+    parameter[38][3] = Q(1);
+    // "curl": c1, c2
+    parameter[39][0] = Q(0.5);
+    parameter[39][1] = Q(0.2);
+    // "rectangles": x, y
+    parameter[40][0] = Q(0.5);
+    parameter[40][1] = Q(0.5);
+  }
 
   using affine<Q, d>::matrix;
 
+  /**\brief Apply transformation
+   *
+   * Some variations need random numbers; these are taken from a generator
+   * that is keyed with the input vector, so the result only depends on the
+   * input.
+   *
+   * \param[in] pV The vector to transform.
+   *
+   * \returns The transformed vector.
+   */
   math::vector<Q, d> operator*(const math::vector<Q, d> &pV) const {
-    const math::vector<Q, d> V = affine<Q, d>(*this) * pV;
-    math::vector<Q, d> rv = V * coefficient[0];
+    std::uint64_t key = 0;
+    for (const auto &v : pV) {
+      key = prng::splitmix::mix(key ^ std::hash<Q>()(v));
+    }
+    prng::splitmix rng(key);
+    return (*this)(pV, rng);
+  }
+
+  /**\brief Apply transformation with random number generator
+   *
+   * Takes exactly 'randomNumbers' numbers from the generator, whichever
+   * variations are in use, so callers can tell where in the sequence a
+   * generator is.
+   *
+   * \param[in]     pV  The vector to transform.
+   * \param[in,out] rng Random number generator for the variations.
+   *
+   * \returns The transformed vector.
+   */
+  math::vector<Q, d> operator()(const math::vector<Q, d> &pV,
+                                prng::splitmix &rng) const {
+    const schedule active(*this);
+    const shared point(*this, pV, active, rng);
+    math::vector<Q, d> rv = point.V * coefficient[0];
 
-    for (int i : range<int>(1, coefficients, false)) {
-      rv = rv + apply(i, V);
+    for (std::size_t k = 0; k < active.count; k++) {
+      rv = rv + apply(active.variation[k], point);
     }
 
     return rv;
   }
 
-  static const std::size_t coefficients = 19;
+  /**\brief Apply transformation to a sequence of vectors
+   *
+   * Transforms vectors in blocks: the list of variations with nonzero
+   * coefficients is worked out once, the quantities that variations share,
+   * such as the angle and the distance to the origin, are calculated once per
+   * vector, and then each active variation is applied to the whole block. The
+   * results are exactly the same as transforming the vectors one at a time
+   * with the same generator.
+   *
+   * \tparam input  Input iterator type for vectors.
+   * \tparam output Output iterator type for vectors.
+   *
+   * \param[in]     begin Start of the vectors to transform.
+   * \param[in]     end   End of the vectors to transform.
+   * \param[out]    out   Where to write the transformed vectors to.
+   * \param[in,out] rng   Random number generator for the variations.
+   *
+   * \returns An iterator past the last vector that was written.
+   */
+  template <class input, class output>
+  output operator()(input begin, input end, output out,
+                    prng::splitmix &rng) const {
+    const schedule active(*this);
+    std::array<shared, block> points;
+    std::array<math::vector<Q, d>, block> result;
+
+    while (begin != end) {
+      std::size_t n = 0;
+      for (; (n < block) && (begin != end); n++, begin++) {
+        points[n] = shared(*this, *begin, active, rng);
+        result[n] = points[n].V * coefficient[0];
+      }
+
+      for (std::size_t k = 0; k < active.count; k++) {
+        const std::size_t f = active.variation[k];
+        for (std::size_t i = 0; i < n; i++) {
+          result[i] = result[i] + apply(f, points[i]);
+        }
+      }
+
+      for (std::size_t i = 0; i < n; i++, out++) {
+        *out = result[i];
+      }
+    }
+
+    return out;
+  }
+
+  static const std::size_t coefficients = 49;
   Q coefficient[coefficients];
 
+  /**\brief Number of general variations
+   *
+   * The first 19 variations, up to "exponential", work in any number of
+   * dimensions. Random flames only pick from these, so that they look the
+   * same as they did before the planar variations were added; set the other
+   * coefficients explicitly to use those.
+   */
+  static constexpr const std::size_t generalCoefficients = 19;
+
+  /**\brief Variation parameters
+   *
+   * Extra parameters for those variations that have them, e.g. the number of
+   * slices for "pie"; see the paper for which variation uses which. The
+   * constructor sets these to reasonable defaults.
+   */
+  Q parameter[coefficients][4];
+
+  /**\brief Random numbers per transformation
+   *
+   * How many numbers every transformation takes from the random number
+   * generator.
+   */
+  static constexpr const std::size_t randomNumbers = 6;
+
 protected:
-  math::vector<Q, d> apply(std::size_t f, const math::vector<Q, d> &V) const {
+  /**\brief Block size
+   *
+   * Number of vectors that are transformed together.
+   */
+  static constexpr const std::size_t block = 64;
+
+  /**\brief Active variations
+   *
+   * Lists the variations with positive coefficients, other than "linear",
+   * and which of the angles they need.
+   */
+  class schedule {
+  public:
+    schedule(const flame &f) : count(0), theta(false), angle(false),
+                               phi(false) {
+      for (std::size_t i = 1; i < coefficients; i++) {
+        if (f.coefficient[i] > Q(0)) {
+          variation[count++] = i;
+          theta = theta || ((i >= 5) && (i <= 13));
+          angle = angle || (i == 22) || (i == 23) || (i == 25);
+          phi = phi || (i == 32) || (i == 33) || (i == 36) || (i == 38);
+        }
+      }
+    }
+
+    std::size_t variation[coefficients];
+    std::size_t count;
+    bool theta;
+    bool angle;
+    bool phi;
+  };
+
+  /**\brief Shared per-vector quantities
+   *
+   * The affinely transformed input vector and everything calculated from it
+   * that more than one variation needs, along with the random numbers for
+   * the transformation.
+   */
+  class shared {
+  public:
+    shared(void) {}
+
+    shared(const flame &f, const math::vector<Q, d> &pV,
+           const schedule &active, prng::splitmix &rng)
+        : V(static_cast<const affine<Q, d> &>(f) * pV),
+          r2(math::lengthSquared(V)), r(sqrt(r2)),
+          theta(active.theta ? Q(atan(V[0] / V[1])) : Q(0)),
+          angle(active.angle ? Q(atan2(V[0], V[1])) : Q(0)),
+          phi(active.phi ? Q(atan2(V[1], V[0])) : Q(0)) {
+      for (auto &p : psi) {
+        p = rng.template uniform<Q>();
+      }
+      const auto bits = rng();
+      omega = Q(bits & 1) * Q(M_PI);
+      lambda = (bits & 2) ? Q(1) : Q(-1);
+    }
+
+    /**\brief Affinely transformed input */
+    math::vector<Q, d> V;
+
+    /**\brief Squared distance to the origin */
+    Q r2;
+
+    /**\brief Distance to the origin */
+    Q r;
+
+    /**\brief atan(x/y), as used by the first 19 variations */
+    Q theta;
+
+    /**\brief Angle with the y axis, atan2(x,y) */
+    Q angle;
+
+    /**\brief Angle with the x axis, atan2(y,x) */
+    Q phi;
+
+    /**\brief Uniform random numbers in [0,1) */
+    Q psi[5];
+
+    /**\brief Either 0 or pi, at random */
+    Q omega;
+
+    /**\brief Either -1 or 1, at random */
+    Q lambda;
+  };
+
+  math::vector<Q, d> apply(std::size_t f, const shared &point) const {
     math::vector<Q, d> rv;
 
     if (coefficient[f] <= Q(0)) {
       return rv;
     }
 
-    // The commented variables are in the Fractal Flame
-    // paper, but won't be used until the remaining
-    // variations are implemented
+    const math::vector<Q, d> &V = point.V;
+    const Q &theta = point.theta;
+    const Q &r2 = point.r2;
+    const Q &r = point.r;
+    const Q &omega = point.omega;
+    const Q &x = V[0];
+    const Q &y = V[1];
+    const Q *p = parameter[f];
+    const Q *psi = point.psi;
+    const Q &v = coefficient[f];
 
-    const Q theta = atan(V[0] / V[1]);
-    // const Q phi   = atan(V[1]/V[0]);
-    const Q r2 = math::lengthSquared(V);
-    const Q r = sqrt(r2);
-    const Q omega = Q(std::rand() % 2) * Q(M_PI);
-    // const Q delta = (std::rand() % 2) == 1 ? Q(1) : Q(-1);
-    // const Q psi   = Q(std::rand() % 10000) / Q(10000);
+    // Variations beyond "exponential" only set the first two coordinates.
+    const auto plane = [&rv, &V](const Q &a, const Q &b) {
+      rv = V;
+      rv[0] = a;
+      rv[1] = b;
+    };
 
     switch (f) {
     case 0: // "linear"
@@ -114,12 +356,16 @@ protected:
         switch (i % 4) {
         case 0:
           rv[i] = sin(theta + r);
+          break;
         case 1:
           rv[i] = cos(theta - r);
-        case 3:
+          break;
+        case 2:
           rv[i] = sin(theta - r);
-        case 4:
+          break;
+        case 3:
           rv[i] = cos(theta + r);
+          break;
         }
       rv = rv * r;
       break;
@@ -276,7 +522,7 @@ protected:
       break;
     case 16: // "fisheye"
       for (std::size_t i : range<std::size_t>(0, depth, depth, false))
-        rv[i] = V[(d - i)];
+        rv[i] = V[(d - 1 - i)];
       rv = rv * Q(2) / (r + Q(1));
       break;
     case 17: // "popcorn"
@@ -295,6 +541,154 @@ protected:
         }
       rv = rv * Q(exp(V[0] - Q(1)));
       break;
+    case 19: // "power"
+    {
+      const Q k = pow(r, x / r);
+      plane(k * y / r, k * x / r);
+    } break;
+    case 20: // "cosine"
+      plane(cos(Q(M_PI) * x) * cosh(y), -sin(Q(M_PI) * x) * sinh(y));
+      break;
+    case 21: // "rings"
+    {
+      const Q c2 = matrix[d][0] * matrix[d][0] + Q(1e-10);
+      const Q k = fmod(r + c2, Q(2) * c2) - c2 + r * (Q(1) - c2);
+      plane(k * y / r, k * x / r);
+    } break;
+    case 22: // "fan"
+    {
+      const Q t = Q(M_PI) * (matrix[d][0] * matrix[d][0] + Q(1e-10));
+      const Q a = point.angle + (fmod(point.angle + matrix[d][1], t) > t / Q(2)
+                                     ? -t / Q(2)
+                                     : t / Q(2));
+      plane(r * cos(a), r * sin(a));
+    } break;
+    case 23: // "blob"
+    {
+      const Q k =
+          r * (p[1] + (p[0] - p[1]) / Q(2) * (sin(p[2] * point.angle) + Q(1)));
+      plane(k * x / r, k * y / r);
+    } break;
+    case 24: // "pdj"
+      plane(sin(p[0] * y) - cos(p[1] * x), sin(p[2] * x) - cos(p[3] * y));
+      break;
+    case 25: // "fan2"
+    {
+      const Q t1 = Q(M_PI) * (p[0] * p[0] + Q(1e-10));
+      const Q t2 = point.angle + p[1] - t1 * trunc((point.angle + p[1]) / t1);
+      const Q a = point.angle + (t2 > t1 / Q(2) ? -t1 / Q(2) : t1 / Q(2));
+      plane(r * sin(a), r * cos(a));
+    } break;
+    case 26: // "rings2"
+    {
+      const Q q = p[0] * p[0] + Q(1e-10);
+      const Q k = r - Q(2) * q * trunc((r + q) / (Q(2) * q)) + r * (Q(1) - q);
+      plane(k * x / r, k * y / r);
+    } break;
+    case 27: // "eyefish"
+      plane(Q(2) / (r + Q(1)) * x, Q(2) / (r + Q(1)) * y);
+      break;
+    case 28: // "bubble"
+      plane(Q(4) / (r2 + Q(4)) * x, Q(4) / (r2 + Q(4)) * y);
+      break;
+    case 29: // "cylinder"
+      plane(sin(x), y);
+      break;
+    case 30: // "perspective"
+    {
+      const Q k = p[1] / (p[1] - y * sin(p[0]));
+      plane(k * x, k * y * cos(p[0]));
+    } break;
+    case 31: // "noise"
+      plane(psi[0] * x * cos(Q(2 * M_PI) * psi[1]),
+            psi[0] * y * sin(Q(2 * M_PI) * psi[1]));
+      break;
+    case 32: // "julian"
+    case 33: // "juliascope"
+    {
+      const Q n = trunc(fabs(p[0]) * psi[0]);
+      const Q a = ((f == 33 ? point.lambda : Q(1)) * point.phi +
+                   Q(2 * M_PI) * n) / p[0];
+      const Q k = pow(r, p[1] / p[0]);
+      plane(k * cos(a), k * sin(a));
+    } break;
+    case 34: // "blur"
+      plane(psi[0] * cos(Q(2 * M_PI) * psi[1]),
+            psi[0] * sin(Q(2 * M_PI) * psi[1]));
+      break;
+    case 35: // "gaussian"
+    {
+      const Q g = psi[0] + psi[1] + psi[2] + psi[3] - Q(2);
+      plane(g * cos(Q(2 * M_PI) * psi[4]), g * sin(Q(2 * M_PI) * psi[4]));
+    } break;
+    case 36: // "radial blur"
+    {
+      const Q a = p[0] * Q(M_PI / 2);
+      const Q t1 = v * (psi[0] + psi[1] + psi[2] + psi[3] - Q(2));
+      const Q t2 = point.phi + t1 * sin(a);
+      const Q t3 = t1 * cos(a) - Q(1);
+      plane((r * cos(t2) + t3 * x) / v, (r * sin(t2) + t3 * y) / v);
+    } break;
+    case 37: // "pie"
+    {
+      const Q slice = trunc(psi[0] * p[0] + Q(0.5));
+      const Q a = p[1] + Q(2 * M_PI) / p[0] * (slice + psi[1] * p[2]);
+      plane(psi[2] * cos(a), psi[2] * sin(a));
+    } break;
+    case 38: // "ngon"
+    {
+      const Q b = Q(2 * M_PI) / p[1];
+      const Q t3 = point.phi - b * floor(point.phi / b);
+      const Q t4 = t3 > b / Q(2) ? t3 : t3 - b;
+      const Q k = (p[2] * (Q(1) / cos(t4) - Q(1)) + p[3]) / pow(r, p[0]);
+      plane(k * x, k * y);
+    } break;
+    case 39: // "curl"
+    {
+      const Q t1 = Q(1) + p[0] * x + p[1] * (x * x - y * y);
+      const Q t2 = p[0] * y + Q(2) * p[1] * x * y;
+      const Q k = Q(1) / (t1 * t1 + t2 * t2);
+      plane(k * (x * t1 + y * t2), k * (y * t1 - x * t2));
+    } break;
+    case 40: // "rectangles"
+      plane(p[0] * (Q(2) * floor(x / p[0]) + Q(1)) - x,
+            p[1] * (Q(2) * floor(y / p[1]) + Q(1)) - y);
+      break;
+    case 41: // "arch"
+    {
+      const Q a = psi[0] * Q(M_PI) * v;
+      plane(sin(a), sin(a) * sin(a) / cos(a));
+    } break;
+    case 42: // "tangent"
+      plane(sin(x) / cos(y), tan(y));
+      break;
+    case 43: // "square"
+      plane(psi[0] - Q(0.5), psi[1] - Q(0.5));
+      break;
+    case 44: // "rays"
+    {
+      const Q k = v * tan(psi[0] * Q(M_PI) * v) / r2;
+      plane(k * cos(x), k * sin(y));
+    } break;
+    case 45: // "blade"
+    {
+      const Q a = psi[0] * r * v;
+      plane(x * (cos(a) + sin(a)), x * (cos(a) - sin(a)));
+    } break;
+    case 46: // "secant"
+      plane(x, Q(1) / (v * cos(v * r)));
+      break;
+    case 47: // "twintrian"
+    {
+      const Q a = psi[0] * r * v;
+      const Q t = log10(sin(a) * sin(a)) + cos(a);
+      plane(x * t, x * (t - Q(M_PI) * sin(a)));
+    } break;
+    case 48: // "cross"
+    {
+      const Q k = sqrt(Q(1) / ((x * x - y * y) * (x * x - y * y)));
+      plane(k * x, k * y);
+    } break;
     default:
       return rv;
     }
@@ -312,16 +706,16 @@ public:
     std::mt19937 PRNG((typename std::mt19937::result_type)pSeed);
 
     matrix =
-        randomAffine<Q, d>(pParameter, 0).matrix;
+        randomAffine<Q, d>(pParameter, pSeed).matrix;
 
-    for (std::size_t i = 0; i < coefficients; i++) {
+    for (std::size_t i = 0; i < generalCoefficients; i++) {
       coefficient[i] = Q(PRNG() % 10000) / Q(10000);
     }
 
     for (std::size_t nonzero = pParameter.flameCoefficients + 1;
          nonzero > pParameter.flameCoefficients;) {
       nonzero = 0;
-      for (std::size_t i = 0; i < coefficients; i++) {
+      for (std::size_t i = 0; i < generalCoefficients; i++) {
         if (coefficient[i] > Q(0.)) {
           nonzero++;
         } else if (coefficient[i] < Q(0.)) {
@@ -330,17 +724,17 @@ public:
       }
 
       if (nonzero > pParameter.flameCoefficients) {
-        coefficient[(PRNG() % coefficients)] = Q(0.);
+        coefficient[(PRNG() % generalCoefficients)] = Q(0.);
       }
     }
 
     Q coefficientsum = coefficient[0];
 
-    for (std::size_t i = 1; i < coefficients; i++) {
+    for (std::size_t i = 1; i < generalCoefficients; i++) {
       coefficientsum = coefficientsum + coefficient[i];
     }
 
-    for (std::size_t i = 0; i < coefficients; i++) {
+    for (std::size_t i = 0; i < generalCoefficients; i++) {
       coefficient[i] = coefficient[i] / coefficientsum;
     }
   }
@@ -348,9 +742,14 @@ public:
   using flame<Q, d>::matrix;
   using flame<Q, d>::coefficient;
   using flame<Q, d>::coefficients;
+  using flame<Q, d>::generalCoefficients;
+
+  using usedParameters =
+      parameterFlags<false, false, false, false, false, false, false, true,
+                     true, true>;
 
 protected:
-  const unsigned long long &seed;
+  const unsigned long long seed;
 };
 }
 
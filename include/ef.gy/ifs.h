@@ -15,11 +15,13 @@
 #include <ef.gy/polytope.h>
 #include <ef.gy/parametric.h>
 #include <ef.gy/projection.h>
+#include <ef.gy/prng.h>
 #include <cmath>
 #include <vector>
 #include <cstdlib>
 #include <random>
 #include <algorithm>
+#include <type_traits>
 
 namespace efgy {
 namespace geometry {
@@ -31,6 +33,10 @@ public:
     updateMatrix();
   }
 
+  using usedParameters =
+      parameterFlags<false, false, false, false, false, false, false, true,
+                     true>;
+
   void updateMatrix(void) {
     std::mt19937 PRNG((typename std::mt19937::result_type)seed);
 
@@ -98,6 +104,7 @@ public:
   using translation = transformation::affine<Q, renderDepth>;
   using dimensions = dimensions<2, 0>;
   static constexpr const char *id(void) { return "sierpinski-gasket"; }
+  using usedParameters = parameterFlags<false, false, false, false, true>;
 
   using scale = transformation::scale<Q, renderDepth>;
   using translate = transformation::translation<Q, renderDepth>;
@@ -139,6 +146,7 @@ public:
   using translation = transformation::affine<Q, renderDepth>;
   using dimensions = dimensions<2, 3>;
   static constexpr const char *id(void) { return "sierpinski-carpet"; }
+  using usedParameters = parameterFlags<false, false, false, false, true>;
 
   using scale = transformation::scale<Q, renderDepth>;
   using translate = transformation::translation<Q, renderDepth>;
@@ -208,6 +216,9 @@ public:
   using translation = trans<Q, renderDepth>;
   using dimensions = dimensions<2, 0>;
   static constexpr const char *id(void) { return name; }
+  using usedParameters = combinedParameterFlags<
+      parameterFlags<false, false, false, false, true, true, true>,
+      typename gen<Q, renderDepth>::usedParameters>;
 
   static std::vector<translation> functions(const parameters<Q> &parameter) {
     std::vector<translation> rv = {};
@@ -253,6 +264,9 @@ public:
 
   using generator = gen<Q, depth, renderDepth>;
   using translation = typename generator::translation;
+  using usedParameters =
+      combinedParameterFlags<typename basePrimitive::usedParameters,
+                             typename generator::usedParameters>;
 
   using parent::parent;
 
@@ -264,19 +278,29 @@ public:
                 const std::vector<translation> &pFunctions)
       : functions(pFunctions),
         base(pParameter, format()),
-        basePosition(base.begin()), iterations(0),
+        basePosition(base.begin()), position(0), iterations(0),
         totalIterations(pParameter.iterations),
-        limit(std::pow<Q>(functions.size(), pParameter.iterations)) {}
+        limit(std::pow<Q>(functions.size(), pParameter.iterations)),
+        seed(pParameter.seed), digits(totalIterations, 0) {
+      if constexpr (composable) {
+        prefix.resize(totalIterations + 1);
+        compose(0);
+      }
+    }
 
     iterator(const iterator &it)
       : functions(it.functions),
         base(it.base),
         basePosition(base.begin()),
+        position(it.position),
         iterations(it.iterations),
         totalIterations(it.totalIterations),
-        limit(it.limit)
+        limit(it.limit),
+        seed(it.seed),
+        digits(it.digits),
+        prefix(it.prefix)
     {
-      basePosition = base.begin();
+      basePosition = geometry::skip(base.begin(), position);
     }
 
     iterator &end(void) {
@@ -284,14 +308,64 @@ public:
       return *this;
     }
 
+    /**\brief Skip faces
+     *
+     * Moves the iterator forward by the given number of faces without
+     * calculating the faces in between: the function indices are simply the
+     * digits of the target's iteration count, so only the prefixes need to be
+     * composed anew.
+     *
+     * \param[in] faces Number of faces to skip.
+     *
+     * \returns A reference to this iterator.
+     */
+    iterator &skip(std::size_t faces) {
+      const std::size_t baseSize = base.size();
+      const std::size_t target =
+          (isEnd() ? limit * baseSize : iterations * baseSize + position) +
+          faces;
+
+      iterations = target / baseSize;
+      position = target % baseSize;
+      basePosition = geometry::skip(base.begin(), position);
+
+      if (isEnd()) {
+        iterations = limit;
+        position = 0;
+        basePosition = base.begin();
+        return *this;
+      }
+
+      std::size_t n = iterations;
+      for (std::size_t i = totalIterations; i > 0; i--) {
+        digits[i - 1] = n % functions.size();
+        n /= functions.size();
+      }
+
+      if constexpr (composable) {
+        compose(0);
+      }
+
+      return *this;
+    }
+
     const face operator*(void) const {
       auto f = *basePosition;
       face g;
       auto o = g.begin();
+      auto rng = prng::splitmix(seed).stream(iterations).stream(position);
       for (auto &p : f) {
-        *o = p;
-        for (const auto &i : iteration()) {
-          *o = functions[i] * (*o);
+        if constexpr (composable) {
+          *o = prefix[totalIterations] * p;
+        } else {
+          *o = p;
+          for (const auto &i : digits) {
+            if constexpr (randomised) {
+              *o = functions[i](*o, rng);
+            } else {
+              *o = functions[i] * (*o);
+            }
+          }
         }
         o++;
       }
@@ -301,11 +375,14 @@ public:
     iterator &operator++(void) {
       if (basePosition != base.end()) {
         basePosition++;
+        position++;
       }
 
       if (basePosition == base.end()) {
         basePosition = base.begin();
+        position = 0;
         iterations++;
+        advance();
       }
 
       return *this;
@@ -338,19 +415,93 @@ public:
     baseIterator basePosition;
     std::vector<translation> functions;
 
+    /**\brief Index of basePosition
+     *
+     * Number of faces of the base primitive before the current one, so that
+     * copies of the iterator can restore their position in their own copy of
+     * the base primitive.
+     */
+    std::size_t position;
+
     std::size_t iterations;
     std::size_t totalIterations;
     std::size_t limit;
 
-    std::vector<std::size_t> iteration(void) const {
-      std::vector<std::size_t> rv = {};
-      std::size_t n = iterations;
-      for (std::size_t i = 0; i < totalIterations; i++) {
-        rv.push_back(n % functions.size());
-        n /= functions.size();
+    /**\brief PRNG seed
+     *
+     * Functions that need random numbers get them from a stream of this seed
+     * that is specific to the current face, so faces come out the same no
+     * matter how the iterator got to them.
+     */
+    std::uint64_t seed;
+
+    /**\brief Do the functions take a random number generator?
+     *
+     * True for e.g. fractal flame transformations.
+     */
+    static constexpr const bool randomised =
+        std::is_invocable<const translation &,
+                          const math::vector<Q, renderDepth> &,
+                          prng::splitmix &>::value;
+
+    /**\brief Can the functions be composed?
+     *
+     * Affine functions can be multiplied together to form a single affine
+     * function, which is not true for e.g. fractal flame variations.
+     */
+    static constexpr const bool composable =
+        std::is_same<translation, transformation::affine<Q, renderDepth>>::value;
+
+    /**\brief Current function indices
+     *
+     * The digits of 'iterations' in base 'functions.size()', most
+     * significant digit first. The function with the index in the first
+     * digit is applied first.
+     */
+    std::vector<std::size_t> digits;
+
+    /**\brief Composed prefix transformations
+     *
+     * Element i is the composition of the functions selected by the first i
+     * digits, so the last element transforms base vertices to their final
+     * position with a single affine application. Only used if the functions
+     * are composable.
+     */
+    std::vector<transformation::affine<Q, renderDepth>> prefix;
+
+    /**\brief Update composed prefixes
+     *
+     * Recalculates the prefix transformations after the digits at 'from' and
+     * later positions have changed.
+     *
+     * \param[in] from First digit that has changed.
+     */
+    void compose(std::size_t from) {
+      for (std::size_t i = from; i < totalIterations; i++) {
+        prefix[i + 1] = prefix[i] * functions[digits[i]];
+      }
+    }
+
+    /**\brief Advance to next function sequence
+     *
+     * Increments the digits like an odometer and recomposes only those
+     * prefixes that have changed, which is a single composition most of the
+     * time; this walks the function tree depth-first.
+     */
+    void advance(void) {
+      if (isEnd() || (totalIterations == 0)) {
+        return;
+      }
+
+      std::size_t i = totalIterations - 1;
+      while ((++digits[i] == functions.size()) && (i > 0)) {
+        digits[i] = 0;
+        i--;
+      }
+
+      if constexpr (composable) {
+        compose(i);
       }
-      std::reverse(rv.begin(), rv.end());
-      return rv;
     }
   };
 
@@ -0,0 +1,119 @@
+/**\file
+ * \brief Common template instances
+ *
+ * Everything in libefgy is a template, so every translation unit that uses
+ * e.g. the model factory or the renderers instantiates the same vectors,
+ * matrices, models and renderers all over again. Including this header
+ * declares the most commonly used instances as extern templates, so the
+ * compiler does not emit them; instead, they are linked in from the optional
+ * library that is built with 'make library'. The library consists of one
+ * object for each base type and depth, compiled with separate sections for
+ * each function, so linking with --gc-sections only keeps what is used.
+ *
+ * Covered are the float, double and long double instances of vectors and
+ * matrices for 2 to 7 dimensions, along with the affine, projective and
+ * flame transformations, projections, cubes, the Sierpinski gasket and
+ * carpet, random affine IFSs, random flames, the parametric surfaces and the
+ * SVG and raster renderers in those dimensions, plus the 8x8 matrices that
+ * projective transformations in 7 dimensions use. Each instance is defined
+ * in exactly one of the library's objects. The OpenGL renderer is not
+ * covered, as the library should not depend on OpenGL.
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#if !defined(EF_GY_INSTANCES_H)
+#define EF_GY_INSTANCES_H
+
+#include <ef.gy/factory.h>
+#include <ef.gy/projection.h>
+#include <ef.gy/render-raster.h>
+#include <ef.gy/render-svg.h>
+
+/**\brief Instances for one depth
+ *
+ * \param K Either 'extern template' or 'template'.
+ * \param Q Base data type.
+ * \param d Number of dimensions.
+ */
+#define EF_GY_INSTANCES_DEPTH(K, Q, d)                                         \
+  K class efgy::math::vector<Q, d>;                                            \
+  K class efgy::math::matrix<Q, d, d>;                                         \
+  K class efgy::geometry::transformation::affine<Q, d>;                        \
+  K class efgy::geometry::transformation::projective<Q, d>;                    \
+  K class efgy::geometry::transformation::flame<Q, d>;                         \
+  K class efgy::geometry::polytope<Q, d, efgy::geometry::generators::cube>;    \
+  K class efgy::geometry::ifs<Q, d, efgy::geometry::cube,                      \
+                             efgy::geometry::generators::gasket>;              \
+  K class efgy::geometry::ifs<Q, d, efgy::geometry::cube,                      \
+                             efgy::geometry::generators::carpet>;              \
+  K class efgy::geometry::ifs<Q, d, efgy::geometry::cube,                      \
+                             efgy::geometry::generators::randomAffine>;        \
+  K class efgy::geometry::ifs<Q, d, efgy::geometry::extendedPlane,             \
+                             efgy::geometry::generators::randomFlame>;
+
+/**\brief Instances for one rendering depth
+ *
+ * \param K Either 'extern template' or 'template'.
+ * \param Q Base data type.
+ * \param d Number of dimensions; at least 3.
+ */
+#define EF_GY_INSTANCES_RENDER(K, Q, d)                                        \
+  K class efgy::geometry::projection<Q, d>;                                    \
+  K class efgy::render::svg<Q, d>;                                             \
+  K class efgy::render::raster<Q, d>;
+
+/**\brief Instances that do not depend on the depth
+ *
+ * \param K Either 'extern template' or 'template'.
+ * \param Q Base data type.
+ */
+#define EF_GY_INSTANCES_COMMON(K, Q)                                           \
+  K class efgy::math::matrix<Q, 8, 8>;                                         \
+  K class efgy::render::svg<Q, 2>;                                             \
+  K class efgy::render::raster<Q, 2>;                                          \
+  K class efgy::geometry::parameters<Q>;                                       \
+  K class efgy::geometry::parametric<Q, 2, efgy::geometry::formula::plane>;    \
+  K class efgy::geometry::parametric<Q, 2, efgy::geometry::formula::sphere>;   \
+  K class efgy::geometry::parametric<Q, 2, efgy::geometry::formula::torus>;    \
+  K class efgy::geometry::parametric<Q, 2,                                     \
+                                     efgy::geometry::formula::cliffordTorus>;  \
+  K class efgy::geometry::parametric<Q, 2,                                     \
+                                     efgy::geometry::formula::moebiusStrip>;   \
+  K class efgy::geometry::parametric<Q, 2,                                     \
+                                     efgy::geometry::formula::kleinBagel>;     \
+  K class efgy::geometry::parametric<Q, 2,                                     \
+                                     efgy::geometry::formula::kleinBottle>;    \
+  K class efgy::geometry::parametric<Q, 2,                                     \
+                                     efgy::geometry::formula::dinisSurface>;
+
+/**\brief All instances for one base type
+ *
+ * \param K Either 'extern template' or 'template'.
+ * \param Q Base data type.
+ */
+#define EF_GY_INSTANCES(K, Q)                                                  \
+  EF_GY_INSTANCES_COMMON(K, Q)                                                 \
+  EF_GY_INSTANCES_DEPTH(K, Q, 2)                                               \
+  EF_GY_INSTANCES_DEPTH(K, Q, 3)                                               \
+  EF_GY_INSTANCES_RENDER(K, Q, 3)                                              \
+  EF_GY_INSTANCES_DEPTH(K, Q, 4)                                               \
+  EF_GY_INSTANCES_RENDER(K, Q, 4)                                              \
+  EF_GY_INSTANCES_DEPTH(K, Q, 5)                                               \
+  EF_GY_INSTANCES_RENDER(K, Q, 5)                                              \
+  EF_GY_INSTANCES_DEPTH(K, Q, 6)                                               \
+  EF_GY_INSTANCES_RENDER(K, Q, 6)                                              \
+  EF_GY_INSTANCES_DEPTH(K, Q, 7)                                               \
+  EF_GY_INSTANCES_RENDER(K, Q, 7)
+
+EF_GY_INSTANCES(extern template, float)
+EF_GY_INSTANCES(extern template, double)
+EF_GY_INSTANCES(extern template, long double)
+
+#endif
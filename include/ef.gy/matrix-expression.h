@@ -0,0 +1,529 @@
+/**\file
+ * \brief Lazily evaluated matrix expressions
+ *
+ * Expression templates for math::matrix. The plain matrix operators always
+ * return a fully calculated matrix, so an expression like A*B*C + D creates
+ * a temporary for every operator and walks through memory once per operator.
+ * Wrapping one of the operands with expression::lazy() instead builds a tree
+ * of expression nodes, which is only evaluated when it is assigned to a
+ * matrix. Element-wise operations are then fused into a single pass over the
+ * result, and chains of products are multiplied in the cheapest order, which
+ * is calculated at compile time.
+ *
+ * Leaf nodes only keep references to the matrices they were created from, so
+ * expressions should be evaluated before those matrices go out of scope.
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#if !defined(EF_GY_MATRIX_EXPRESSION_H)
+#define EF_GY_MATRIX_EXPRESSION_H
+
+#include <ef.gy/matrix.h>
+#include <array>
+#include <tuple>
+#include <type_traits>
+
+namespace efgy {
+namespace math {
+/**\brief Matrix expression templates
+ *
+ * Contains the node types of lazily evaluated matrix expressions, as well as
+ * the operators that combine them. Use lazy() to create an expression from a
+ * matrix, and assign the expression to a matrix to evaluate it.
+ */
+namespace expression {
+/**\brief Expression node base
+ *
+ * Every expression node derives from this class, which provides the
+ * dimensions of the node and the conversion to a concrete matrix.
+ *
+ * \tparam Q       Data type of the matrix cells.
+ * \tparam n       Number of rows in the result.
+ * \tparam m       Number of columns in the result.
+ * \tparam derived The actual node type.
+ */
+template <typename Q, std::size_t n, std::size_t m, class derived>
+class node {
+public:
+  using value_type = Q;
+  static constexpr const std::size_t rows = n;
+  static constexpr const std::size_t columns = m;
+
+  /**\brief Evaluate expression
+   *
+   * Calculates the value of the expression into a new matrix.
+   *
+   * \returns The value of the expression.
+   */
+  operator math::matrix<Q, n, m>(void) const {
+    math::matrix<Q, n, m> r;
+    static_cast<const derived &>(*this).evaluate(r);
+    return r;
+  }
+};
+
+/**\brief Is T an expression node?
+ *
+ * \tparam T The type to test.
+ */
+template <class T, class = void> class isNode : public std::false_type {};
+
+template <class T>
+class isNode<T, std::void_t<typename T::value_type,
+                            decltype(T::rows), decltype(T::columns)>>
+    : public std::is_base_of<
+          node<typename T::value_type, T::rows, T::columns, T>, T> {};
+
+/**\brief Fill matrix with element-wise expression
+ *
+ * Used by all nodes that can calculate individual cells cheaply; walks
+ * through the target once, in storage order.
+ *
+ * \param[in]  e The node to evaluate.
+ * \param[out] r Where to write the cells to.
+ */
+template <typename Q, std::size_t n, std::size_t m, class E>
+void fill(const E &e, math::matrix<Q, n, m> &r) {
+  Q *c = r.data();
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t j = 0; j < m; j++) {
+      *c++ = e(i, j);
+    }
+  }
+}
+
+/**\brief Reference to a matrix
+ *
+ * Leaf node that refers to an existing matrix.
+ */
+template <typename Q, std::size_t n, std::size_t m>
+class terminal : public node<Q, n, m, terminal<Q, n, m>> {
+public:
+  constexpr terminal(const math::matrix<Q, n, m> &pMatrix) : source(pMatrix) {}
+
+  Q operator()(const std::size_t &i, const std::size_t &j) const {
+    return source.data()[i * m + j];
+  }
+
+  void evaluate(math::matrix<Q, n, m> &r) const { r = source; }
+
+  const math::matrix<Q, n, m> &value(void) const { return source; }
+
+protected:
+  const math::matrix<Q, n, m> &source;
+};
+
+/**\brief Calculated matrix
+ *
+ * Leaf node that holds a matrix by value; used for the intermediate results
+ * of products that are part of an element-wise expression.
+ */
+template <typename Q, std::size_t n, std::size_t m>
+class evaluated : public node<Q, n, m, evaluated<Q, n, m>> {
+public:
+  evaluated(void) = default;
+
+  Q operator()(const std::size_t &i, const std::size_t &j) const {
+    return result.data()[i * m + j];
+  }
+
+  void evaluate(math::matrix<Q, n, m> &r) const { r = result; }
+
+  const math::matrix<Q, n, m> &value(void) const { return result; }
+
+  math::matrix<Q, n, m> result;
+};
+
+/**\brief Generated matrix
+ *
+ * Leaf node for a ghost matrix; cells are calculated by the ghost matrix's
+ * generator whenever they are needed, so the ghost matrix is never stored.
+ */
+template <typename Q, std::size_t n, std::size_t m,
+          template <typename, std::size_t, std::size_t> class gen>
+class generated : public node<Q, n, m, generated<Q, n, m, gen>> {
+public:
+  constexpr generated(const ghost::matrix<Q, n, m, gen> &pMatrix)
+      : source(pMatrix) {}
+
+  Q operator()(const std::size_t &i, const std::size_t &j) const {
+    return source.generator(i, j);
+  }
+
+  void evaluate(math::matrix<Q, n, m> &r) const { fill(*this, r); }
+
+protected:
+  const ghost::matrix<Q, n, m, gen> &source;
+};
+
+/**\brief Identity matrix
+ *
+ * Leaf node for ghost matrices with an identity generator. These are removed
+ * from products entirely, at compile time.
+ */
+template <typename Q, std::size_t n>
+class identity : public node<Q, n, n, identity<Q, n>> {
+public:
+  Q operator()(const std::size_t &i, const std::size_t &j) const {
+    return i == j ? Q(1) : Q(0);
+  }
+
+  void evaluate(math::matrix<Q, n, n> &r) const { fill(*this, r); }
+};
+
+template <class T> class isIdentity : public std::false_type {};
+
+template <typename Q, std::size_t n>
+class isIdentity<identity<Q, n>> : public std::true_type {};
+
+/**\brief Cell-wise sum
+ */
+class sum {
+public:
+  template <typename Q> static Q apply(const Q &a, const Q &b) { return a + b; }
+};
+
+/**\brief Cell-wise difference
+ */
+class difference {
+public:
+  template <typename Q> static Q apply(const Q &a, const Q &b) { return a - b; }
+};
+
+/**\brief Element-wise operation
+ *
+ * Combines the cells of two nodes with the same dimensions; evaluating this
+ * node calculates each cell of the result exactly once, without temporaries.
+ *
+ * \tparam op The operation to apply, e.g. sum or difference.
+ * \tparam L  The left-hand side node.
+ * \tparam R  The right-hand side node.
+ */
+template <class op, class L, class R>
+class elementwise
+    : public node<typename L::value_type, L::rows, L::columns,
+                  elementwise<op, L, R>> {
+public:
+  using Q = typename L::value_type;
+
+  static_assert(L::rows == R::rows && L::columns == R::columns,
+                "element-wise operations need operands of the same size");
+
+  elementwise(const L &pA, const R &pB) : a(pA), b(pB) {}
+
+  Q operator()(const std::size_t &i, const std::size_t &j) const {
+    return op::apply(a(i, j), b(i, j));
+  }
+
+  void evaluate(math::matrix<Q, L::rows, L::columns> &r) const {
+    fill(*this, r);
+  }
+
+protected:
+  const L a;
+  const R b;
+};
+
+/**\brief Scalar quotient
+ *
+ * Divides all cells of a node by the same value.
+ *
+ * \tparam L The node to divide.
+ */
+template <class L>
+class quotient
+    : public node<typename L::value_type, L::rows, L::columns, quotient<L>> {
+public:
+  using Q = typename L::value_type;
+
+  quotient(const L &pA, const Q &pB) : a(pA), b(pB) {}
+
+  Q operator()(const std::size_t &i, const std::size_t &j) const {
+    return a(i, j) / b;
+  }
+
+  void evaluate(math::matrix<Q, L::rows, L::columns> &r) const {
+    fill(*this, r);
+  }
+
+protected:
+  const L a;
+  const Q b;
+};
+
+/**\brief Matrix chain ordering
+ *
+ * Calculates the cheapest order in which to multiply a chain of matrices,
+ * with the classic dynamic programming algorithm. Matrix i in the chain has
+ * dimensions[i] rows and dimensions[i+1] columns. The result holds the
+ * position of the outermost split for every sub-chain from i to j at
+ * index i * count + j.
+ *
+ * \tparam count Number of matrices in the chain.
+ *
+ * \param[in] dimensions The dimensions of all the matrices in the chain.
+ *
+ * \returns A table with the best split for every sub-chain.
+ */
+template <std::size_t count>
+constexpr std::array<std::size_t, count * count>
+order(const std::array<std::size_t, count + 1> &dimensions) {
+  std::array<unsigned long long, count * count> cost{};
+  std::array<std::size_t, count * count> split{};
+
+  for (std::size_t l = 1; l < count; l++) {
+    for (std::size_t i = 0; i + l < count; i++) {
+      const std::size_t j = i + l;
+      cost[i * count + j] = ~0ull;
+      for (std::size_t k = i; k < j; k++) {
+        const unsigned long long c =
+            cost[i * count + k] + cost[(k + 1) * count + j] +
+            (unsigned long long)(dimensions[i]) * dimensions[k + 1] *
+                dimensions[j + 1];
+        if (c < cost[i * count + j]) {
+          cost[i * count + j] = c;
+          split[i * count + j] = k;
+        }
+      }
+    }
+  }
+
+  return split;
+}
+
+/**\brief Chain of matrix products
+ *
+ * All the factors in a sequence of products are collected in a single node,
+ * so that the association order can be chosen freely when evaluating. Each
+ * factor is either a terminal or an evaluated node, so that it has a matrix
+ * to pass to math::multiply().
+ *
+ * \tparam Q     Data type of the matrix cells.
+ * \tparam terms The factors of the product, in order.
+ */
+template <typename Q, class... terms>
+class product
+    : public node<Q, std::tuple_element<0, std::tuple<terms...>>::type::rows,
+                  std::tuple_element<sizeof...(terms) - 1,
+                                     std::tuple<terms...>>::type::columns,
+                  product<Q, terms...>> {
+public:
+  static constexpr const std::size_t count = sizeof...(terms);
+  static constexpr const std::array<std::size_t, count + 1> dimensions = {
+      {std::tuple_element<0, std::tuple<terms...>>::type::rows,
+       terms::columns...}};
+  static constexpr const std::array<std::size_t, count * count> split =
+      order<count>(dimensions);
+
+  product(const std::tuple<terms...> &pFactors) : factors(pFactors) {}
+
+  void evaluate(
+      math::matrix<Q, dimensions[0], dimensions[count]> &r) const {
+    if constexpr (count == 1) {
+      r = std::get<0>(factors).value();
+    } else {
+      evaluate<0, count - 1>(r);
+    }
+  }
+
+  const std::tuple<terms...> factors;
+
+protected:
+  /**\brief Multiply sub-chain
+   *
+   * Multiplies the factors from i to j, inclusive, splitting the chain as
+   * determined by order().
+   *
+   * \tparam i The first factor to multiply.
+   * \tparam j The last factor to multiply.
+   *
+   * \param[out] r Where to write the product to.
+   */
+  template <std::size_t i, std::size_t j>
+  void evaluate(math::matrix<Q, dimensions[i], dimensions[j + 1]> &r) const {
+    constexpr const std::size_t k = split[i * count + j];
+
+    if constexpr ((k == i) && (k + 1 == j)) {
+      multiply(std::get<i>(factors).value(), std::get<j>(factors).value(), r);
+    } else if constexpr (k == i) {
+      math::matrix<Q, dimensions[k + 1], dimensions[j + 1]> b;
+      evaluate<k + 1, j>(b);
+      multiply(std::get<i>(factors).value(), b, r);
+    } else if constexpr (k + 1 == j) {
+      math::matrix<Q, dimensions[i], dimensions[k + 1]> a;
+      evaluate<i, k>(a);
+      multiply(a, std::get<j>(factors).value(), r);
+    } else {
+      math::matrix<Q, dimensions[i], dimensions[k + 1]> a;
+      math::matrix<Q, dimensions[k + 1], dimensions[j + 1]> b;
+      evaluate<i, k>(a);
+      evaluate<k + 1, j>(b);
+      multiply(a, b, r);
+    }
+  }
+};
+
+/**\brief Product node for a tuple of factors
+ *
+ * \tparam Q Data type of the matrix cells.
+ * \tparam T A std::tuple with the factors of the product.
+ */
+template <typename Q, class T> class chain;
+
+template <typename Q, class... terms> class chain<Q, std::tuple<terms...>> {
+public:
+  using type = product<Q, terms...>;
+};
+
+/**\brief Create expression from matrix
+ *
+ * Starts a lazily evaluated expression; any operator that has the result of
+ * this function as one of its operands creates another expression node.
+ *
+ * \param[in] pMatrix The matrix to wrap.
+ *
+ * \returns An expression node for the matrix.
+ */
+template <typename Q, std::size_t n, std::size_t m>
+constexpr terminal<Q, n, m> lazy(const math::matrix<Q, n, m> &pMatrix) {
+  return terminal<Q, n, m>(pMatrix);
+}
+
+/**\brief Create expression from ghost matrix
+ *
+ * Ghost matrices with an identity generator turn into identity nodes, which
+ * vanish from products; all others are evaluated on demand.
+ *
+ * \param[in] pMatrix The ghost matrix to wrap.
+ *
+ * \returns An expression node for the ghost matrix.
+ */
+template <typename Q, std::size_t n, std::size_t m,
+          template <typename, std::size_t, std::size_t> class gen>
+constexpr auto lazy(const ghost::matrix<Q, n, m, gen> &pMatrix) {
+  if constexpr ((n == m) && ghost::isIdentity<gen>::value) {
+    return identity<Q, n>();
+  } else {
+    return generated<Q, n, m, gen>(pMatrix);
+  }
+}
+
+template <class T, typename std::enable_if<isNode<T>::value, int>::type = 0>
+constexpr const T &lazy(const T &e) {
+  return e;
+}
+
+/**\brief Product factors of a node
+ *
+ * Returns the factors of a product node, or a single factor for any other
+ * node. Nodes that do not refer to a matrix are evaluated here.
+ *
+ * \param[in] e The node to split into factors.
+ *
+ * \returns A tuple of terminal and evaluated nodes.
+ */
+template <class T> auto factors(const T &e) {
+  using Q = typename T::value_type;
+
+  if constexpr (std::is_same<T, terminal<Q, T::rows, T::columns>>::value ||
+                std::is_same<T, evaluated<Q, T::rows, T::columns>>::value) {
+    return std::make_tuple(e);
+  } else {
+    evaluated<Q, T::rows, T::columns> r;
+    e.evaluate(r.result);
+    return std::make_tuple(r);
+  }
+}
+
+template <typename Q, class... terms>
+const std::tuple<terms...> &factors(const product<Q, terms...> &e) {
+  return e.factors;
+}
+
+/**\brief Operand of an element-wise node
+ *
+ * Products are evaluated before they are used in an element-wise operation,
+ * as calculating individual cells of a product is expensive.
+ *
+ * \param[in] e The node to use as an operand.
+ *
+ * \returns Either the node itself or its value.
+ */
+template <class T> const T &operand(const T &e) { return e; }
+
+template <typename Q, class... terms>
+auto operand(const product<Q, terms...> &e) {
+  constexpr const std::size_t n = product<Q, terms...>::rows;
+  constexpr const std::size_t m = product<Q, terms...>::columns;
+  evaluated<Q, n, m> r;
+  e.evaluate(r.result);
+  return r;
+}
+
+/**\brief Is the argument usable in an expression?
+ *
+ * Operators are only defined if at least one of the operands is an expression
+ * node and the other is either a node, a matrix or a ghost matrix.
+ */
+template <class A, class B>
+using isOperation = std::integral_constant<
+    bool, (isNode<A>::value || isNode<B>::value) &&
+              isNode<typename std::decay<decltype(
+                  lazy(std::declval<A>()))>::type>::value &&
+              isNode<typename std::decay<decltype(
+                  lazy(std::declval<B>()))>::type>::value>;
+
+template <class A, class B,
+          typename std::enable_if<isOperation<A, B>::value, int>::type = 0>
+auto operator+(const A &a, const B &b) {
+  auto l = operand(lazy(a));
+  auto r = operand(lazy(b));
+  return elementwise<sum, decltype(l), decltype(r)>(l, r);
+}
+
+template <class A, class B,
+          typename std::enable_if<isOperation<A, B>::value, int>::type = 0>
+auto operator-(const A &a, const B &b) {
+  auto l = operand(lazy(a));
+  auto r = operand(lazy(b));
+  return elementwise<difference, decltype(l), decltype(r)>(l, r);
+}
+
+template <class A, class B,
+          typename std::enable_if<isOperation<A, B>::value, int>::type = 0>
+auto operator*(const A &a, const B &b) {
+  using L = typename std::decay<decltype(lazy(a))>::type;
+  using R = typename std::decay<decltype(lazy(b))>::type;
+  using Q = typename L::value_type;
+
+  static_assert(L::columns == R::rows,
+                "left-hand side of a product must have as many columns as the "
+                "right-hand side has rows");
+
+  if constexpr (isIdentity<L>::value) {
+    return R(lazy(b));
+  } else if constexpr (isIdentity<R>::value) {
+    return L(lazy(a));
+  } else {
+    auto f = std::tuple_cat(factors(lazy(a)), factors(lazy(b)));
+    return typename chain<Q, decltype(f)>::type(f);
+  }
+}
+
+template <class A, typename std::enable_if<isNode<A>::value, int>::type = 0>
+auto operator/(const A &a, const typename A::value_type &b) {
+  auto l = operand(a);
+  return quotient<decltype(l)>(l, b);
+}
+}
+}
+}
+
+#endif
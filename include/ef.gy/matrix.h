@@ -18,8 +18,10 @@
 #define EF_GY_MATRIX_H
 
 #include <array>
+#include <cmath>
 #include <iostream>
 #include <iterator>
+#include <type_traits>
 
 namespace efgy {
 namespace math {
@@ -102,16 +104,92 @@ protected:
 };
 }
 
+/**\brief Strided view of matrix cells
+ *
+ * A row or a column of a matrix, without copying any of the cells. Rows have a
+ * step of 1, columns have a step of the number of columns in the matrix, so
+ * accessing an element is a single multiply-add on a pointer.
+ *
+ * \tparam T     Cell type, possibly const-qualified.
+ * \tparam count Number of cells in the view.
+ * \tparam step  Distance between two consecutive cells in memory.
+ */
+template <typename T, std::size_t count, std::size_t step> class slice {
+public:
+  /**\brief Iterator over the cells of a slice
+   *
+   * Keeps the first cell of the slice and an index, so that the end
+   * iterator of a column never points past the end of the matrix.
+   */
+  class iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename std::remove_cv<T>::type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+    constexpr iterator(T *pFirst, std::size_t pPosition)
+        : first(pFirst), position(pPosition) {}
+
+    T &operator*(void) const { return first[position * step]; }
+    T &operator[](const std::ptrdiff_t &b) const {
+      return first[(position + b) * step];
+    }
+
+    iterator &operator++(void) {
+      position++;
+      return *this;
+    }
+
+    iterator &operator--(void) {
+      position--;
+      return *this;
+    }
+
+    constexpr iterator operator+(const std::ptrdiff_t &b) const {
+      return iterator(first, position + b);
+    }
+
+    constexpr std::ptrdiff_t operator-(const iterator &b) const {
+      return std::ptrdiff_t(position) - std::ptrdiff_t(b.position);
+    }
+
+    constexpr bool operator==(const iterator &b) const {
+      return position == b.position;
+    }
+    constexpr bool operator!=(const iterator &b) const {
+      return position != b.position;
+    }
+    constexpr bool operator<(const iterator &b) const {
+      return position < b.position;
+    }
+
+  protected:
+    T *first;
+    std::size_t position;
+  };
+
+  constexpr slice(T *pFirst) : first(pFirst) {}
+
+  T &operator[](const std::size_t &i) const { return first[i * step]; }
+
+  iterator begin(void) const { return iterator(first, 0); }
+  iterator end(void) const { return iterator(first, count); }
+  constexpr std::size_t size(void) const { return count; }
+
+protected:
+  T *first;
+};
+
 template <typename Q, std::size_t n, std::size_t m> class matrix;
 
 template <typename Q, std::size_t n, std::size_t m>
 matrix<Q, n, m> operator+(const matrix<Q, n, m> &a, const matrix<Q, n, m> &b) {
   matrix<Q, n, m> r;
 
-  for (std::size_t i = 0; i < n; i++) {
-    for (std::size_t j = 0; j < m; j++) {
-      r[i][j] = a[i][j] + b[i][j];
-    }
+  for (std::size_t i = 0; i < n * m; i++) {
+    r.data()[i] = a.data()[i] + b.data()[i];
   }
 
   return r;
@@ -121,29 +199,141 @@ template <typename Q, std::size_t n, std::size_t m>
 matrix<Q, n, m> operator-(const matrix<Q, n, m> &a, const matrix<Q, n, m> &b) {
   matrix<Q, n, m> r;
 
-  for (std::size_t i = 0; i < n; i++) {
-    for (std::size_t j = 0; j < m; j++) {
-      r[i][j] = a[i][j] - b[i][j];
-    }
+  for (std::size_t i = 0; i < n * m; i++) {
+    r.data()[i] = a.data()[i] - b.data()[i];
   }
 
   return r;
 }
 
-template <typename Q, std::size_t n, std::size_t m, std::size_t p>
-matrix<Q, n, p> operator*(const matrix<Q, n, m> &a, const matrix<Q, m, p> &b) {
-  matrix<Q, n, p> r;
+/**\brief Matrix multiplication kernels
+ *
+ * Implementation details of the matrix product; use operator* or
+ * math::multiply() instead of calling these directly.
+ */
+namespace kernel {
+/**\brief Register tile height
+ *
+ * Number of rows of the result that are computed at the same time.
+ */
+static constexpr const std::size_t tileRows = 4;
 
+/**\brief Register tile width
+ *
+ * Number of columns of the result that are computed at the same time; with
+ * tileRows this gives the number of accumulators held in registers.
+ */
+static constexpr const std::size_t tileColumns = 4;
+
+/**\brief Cache block depth
+ *
+ * Number of products summed up per pass over a tile, so that the parts of
+ * both operands in use stay in the L1 cache for large matrices.
+ */
+static constexpr const std::size_t blockDepth = 64;
+
+/**\brief Textbook matrix product
+ *
+ * The plain i-j-k loop. Used for cell types that are not plain arithmetic
+ * types, as it never needs a zero element and always sums up products in
+ * the same order, which matters for e.g. the numeric tracer.
+ */
+template <typename Q, std::size_t n, std::size_t m, std::size_t p>
+void textbook(const Q *a, const Q *b, Q *r) {
   for (std::size_t i = 0; i < n; i++) {
     for (std::size_t j = 0; j < p; j++) {
-      r[i][j] = a[i][0] * b[0][j];
-        
+      Q s = a[i * m] * b[j];
+
       for (std::size_t k = 1; k < m; k++) {
-        r[i][j] += a[i][k] * b[k][j];
+        s += a[i * m + k] * b[k * p + j];
       }
+
+      r[i * p + j] = s;
     }
   }
+}
+
+/**\brief Cache-blocked, register-tiled matrix product
+ *
+ * Computes the result in tiles of tileRows x tileColumns cells, each of
+ * which is accumulated in local variables while streaming through blockDepth
+ * rows of b at a time. The tile dimensions are compile-time constants, so
+ * the compiler is free to keep the accumulators in (vector) registers.
+ */
+template <typename Q, std::size_t n, std::size_t m, std::size_t p>
+void blocked(const Q *a, const Q *b, Q *r) {
+  for (std::size_t i = 0; i < n * p; i++) {
+    r[i] = Q(0);
+  }
+
+  for (std::size_t k0 = 0; k0 < m; k0 += blockDepth) {
+    const std::size_t k1 = k0 + blockDepth < m ? k0 + blockDepth : m;
 
+    for (std::size_t i0 = 0; i0 < n; i0 += tileRows) {
+      const std::size_t ni = n - i0 < tileRows ? n - i0 : tileRows;
+
+      for (std::size_t j0 = 0; j0 < p; j0 += tileColumns) {
+        const std::size_t nj = p - j0 < tileColumns ? p - j0 : tileColumns;
+
+        Q acc[tileRows][tileColumns] = {};
+
+        if ((ni == tileRows) && (nj == tileColumns)) {
+          for (std::size_t k = k0; k < k1; k++) {
+            const Q *bk = b + k * p + j0;
+            for (std::size_t i = 0; i < tileRows; i++) {
+              const Q aik = a[(i0 + i) * m + k];
+              for (std::size_t j = 0; j < tileColumns; j++) {
+                acc[i][j] += aik * bk[j];
+              }
+            }
+          }
+        } else {
+          for (std::size_t k = k0; k < k1; k++) {
+            const Q *bk = b + k * p + j0;
+            for (std::size_t i = 0; i < ni; i++) {
+              const Q aik = a[(i0 + i) * m + k];
+              for (std::size_t j = 0; j < nj; j++) {
+                acc[i][j] += aik * bk[j];
+              }
+            }
+          }
+        }
+
+        for (std::size_t i = 0; i < ni; i++) {
+          for (std::size_t j = 0; j < nj; j++) {
+            r[(i0 + i) * p + j0 + j] += acc[i][j];
+          }
+        }
+      }
+    }
+  }
+}
+}
+
+/**\brief Multiply matrices into existing storage
+ *
+ * Calculates a * b and writes the result to r, without any temporaries. The
+ * result must not alias either of the operands. Arithmetic cell types use the
+ * blocked kernel, anything else uses the textbook algorithm.
+ *
+ * \param[in]  a The left-hand side of the product.
+ * \param[in]  b The right-hand side of the product.
+ * \param[out] r Where to write the product to.
+ */
+template <typename Q, std::size_t n, std::size_t m, std::size_t p>
+void multiply(const matrix<Q, n, m> &a, const matrix<Q, m, p> &b,
+              matrix<Q, n, p> &r) {
+  if constexpr (std::is_arithmetic<Q>::value) {
+    kernel::blocked<Q, n, m, p>(a.data(), b.data(), r.data());
+  } else {
+    kernel::textbook<Q, n, m, p>(a.data(), b.data(), r.data());
+  }
+}
+
+template <typename Q, std::size_t n, std::size_t m, std::size_t p>
+matrix<Q, n, p> operator*(const matrix<Q, n, m> &a, const matrix<Q, m, p> &b) {
+  matrix<Q, n, p> r;
+  multiply(a, b, r);
   return r;
 }
 
@@ -151,16 +341,25 @@ template <typename Q, std::size_t n, std::size_t m>
 matrix<Q, n, m> operator/(const matrix<Q, n, m> &a, const Q &b) {
   matrix<Q, n, m> r;
 
-  for (std::size_t i = 0; i < n; i++) {
-    for (std::size_t j = 0; j < m; j++) {
-      r[i][j] = a[i][j] / b;
-    }
+  for (std::size_t i = 0; i < n * m; i++) {
+    r.data()[i] = a.data()[i] / b;
   }
 
   return r;
 }
 
 namespace ghost {
+/**\brief Is gen an identity generator?
+ *
+ * Allows code that works with ghost matrices, e.g. matrix expressions, to
+ * skip identity matrices entirely. Specialise this for generators that always
+ * produce identity matrices.
+ *
+ * \tparam gen The generator to test.
+ */
+template <template <typename, std::size_t, std::size_t> class gen>
+class isIdentity : public std::false_type {};
+
 template <typename Q, std::size_t n, std::size_t m,
           template<typename, std::size_t, std::size_t> class gen>
 class matrix {
@@ -202,14 +401,30 @@ public:
  * This template is used to store and calculate with matrices of arbitrary but
  * fixed and finite sizes.
  *
+ * Cells are stored in a single, contiguous array in row-major order, with a
+ * stride of 'm' cells between two rows. Indexing with [i][j] goes through a
+ * row view, which resolves to a single pointer offset, and iterating over the
+ * cells is a plain pointer walk.
+ *
  * \tparam Q The data type for individual matrix cells.
  * \tparam n Number of rows in the matrix.
  * \tparam m Number of columns in the matrix.
  */
 template <typename Q, std::size_t n, std::size_t m>
-class matrix : public std::array<std::array<Q, m>, n> {
+class matrix {
 public:
-  using iterator = iterator::matrix<Q, m, matrix>;
+  using iterator = Q *;
+  using const_iterator = const Q *;
+  using row = slice<Q, m, 1>;
+  using constRow = slice<const Q, m, 1>;
+  using column = slice<Q, n, m>;
+  using constColumn = slice<const Q, n, m>;
+
+  /**\brief Row stride
+   *
+   * Distance between the first cells of two consecutive rows.
+   */
+  static constexpr const std::size_t stride = m;
 
   /**\brief Default constructor
    *
@@ -265,31 +480,48 @@ public:
   template<typename it>
   matrix(const it &pBegin, const it &pEnd) {
     it k = pBegin;
-    for (std::size_t i = 0; i < n; i++) {
-      for (std::size_t j = 0; j < m; i++) {
-        if (k != pEnd) {
-          (*this)[i][j] = *k;
-          k++;
-        } else {
-          (*this)[i][j] = Q();
-        }
+    for (std::size_t i = 0; i < n * m; i++) {
+      if (k != pEnd) {
+        cells[i] = *k;
+        k++;
+      } else {
+        cells[i] = Q();
       }
     }
   }
 
-  matrix<Q, n, m> &operator=(const matrix<Q, n, m> &b) {
-    for (std::size_t i = 0; i < n; i++) {
-      for (std::size_t j = 0; j < m; j++) {
-        (*this)[i][j] = b[i][j];
-      }
-    }
+  matrix(const matrix &b) = default;
+  matrix &operator=(const matrix &b) = default;
 
-    return *this;
+  row operator[](const std::size_t &i) { return row(cells.data() + i * m); }
+  constRow operator[](const std::size_t &i) const {
+    return constRow(cells.data() + i * m);
   }
 
-  iterator begin(void) const { return iterator(*this, 0); }
-  iterator end(void) const { return iterator(*this, n * m); }
+  column operator()(const std::size_t &j) { return column(cells.data() + j); }
+  constColumn operator()(const std::size_t &j) const {
+    return constColumn(cells.data() + j);
+  }
+
+  /**\brief Raw cell storage
+   *
+   * \returns A pointer to the first of the n * m cells, in row-major order.
+   */
+  Q *data(void) { return cells.data(); }
+  const Q *data(void) const { return cells.data(); }
+
+  iterator begin(void) { return cells.data(); }
+  iterator end(void) { return cells.data() + n * m; }
+  const_iterator begin(void) const { return cells.data(); }
+  const_iterator end(void) const { return cells.data() + n * m; }
   constexpr std::size_t size(void) const { return n; }
+
+protected:
+  /**\brief Matrix cells
+   *
+   * All the cells of the matrix, row after row.
+   */
+  std::array<Q, n * m> cells;
 };
 
 /**\brief Write matrix contents to stream.
@@ -309,7 +541,18 @@ template <typename Q, std::size_t n, std::size_t m, typename C>
   return stream;
 }
 
+namespace decomposition {
+template <typename Q, std::size_t d> class lu;
+}
+
+template <typename Q, std::size_t d>
+decomposition::lu<Q, d> lu(const matrix<Q, d, d> &pM);
+
 template <typename Q, std::size_t d> Q determinant(const matrix<Q, d, d> &pM) {
+  if constexpr (std::is_floating_point<Q>::value && (d > 3)) {
+    return lu(pM).determinant();
+  }
+
   Q rv;
 
   for (std::size_t i = 0; i < d; i++) {
@@ -398,6 +641,326 @@ template <typename Q> matrix<Q, 3, 3> invert(const matrix<Q, 3, 3> &pM) {
 
   return rv / determinant(pM);
 }
+
+/**\brief Matrix decompositions
+ *
+ * Contains the results of factorising a matrix into a product of matrices
+ * with a simpler structure. These need to compare cells with zero and divide
+ * by cells, so they only work for field-like cell types; QR decompositions
+ * additionally need a square root.
+ */
+namespace decomposition {
+/**\brief LU decomposition with partial pivoting
+ *
+ * Holds the factors of P * A = L * U, where P is a permutation matrix, L is a
+ * lower triangular matrix with a unit diagonal and U is an upper triangular
+ * matrix. Both triangles are stored in a single matrix, as the diagonal of L
+ * need not be stored.
+ *
+ * Once the decomposition has been calculated, which takes O(d^3) operations,
+ * determinants cost O(d) and solving a linear system costs O(d^2) per column.
+ *
+ * \tparam Q The data type for individual matrix cells.
+ * \tparam d Number of rows and columns in the decomposed matrix.
+ */
+template <typename Q, std::size_t d> class lu {
+public:
+  /**\brief Combined factors
+   *
+   * U on and above the diagonal, L below the diagonal.
+   */
+  matrix<Q, d, d> factors;
+
+  /**\brief Row permutation
+   *
+   * Row i of P * A is row permutation[i] of A.
+   */
+  std::array<std::size_t, d> permutation;
+
+  /**\brief Permutation parity
+   *
+   * True if P is made up of an even number of row swaps.
+   */
+  bool even;
+
+  /**\brief Is the decomposed matrix singular?
+   *
+   * If this is set, then determinant() is zero, and solve() and inverse() do
+   * not produce meaningful results.
+   */
+  bool singular;
+
+  /**\brief Lower triangular factor
+   *
+   * \returns L, with the unit diagonal filled in.
+   */
+  matrix<Q, d, d> lower(void) const {
+    matrix<Q, d, d> rv;
+
+    for (std::size_t i = 0; i < d; i++) {
+      for (std::size_t j = 0; j < d; j++) {
+        rv[i][j] = i > j ? factors[i][j] : (i == j ? Q(1) : Q(0));
+      }
+    }
+
+    return rv;
+  }
+
+  /**\brief Upper triangular factor
+   *
+   * \returns U.
+   */
+  matrix<Q, d, d> upper(void) const {
+    matrix<Q, d, d> rv;
+
+    for (std::size_t i = 0; i < d; i++) {
+      for (std::size_t j = 0; j < d; j++) {
+        rv[i][j] = i <= j ? factors[i][j] : Q(0);
+      }
+    }
+
+    return rv;
+  }
+
+  /**\brief Determinant of the decomposed matrix
+   *
+   * \returns The product of the diagonal of U, with the sign of P.
+   */
+  Q determinant(void) const {
+    Q rv = even ? Q(1) : Q(-1);
+
+    for (std::size_t i = 0; i < d; i++) {
+      rv *= factors[i][i];
+    }
+
+    return rv;
+  }
+
+  /**\brief Solve linear system
+   *
+   * Calculates X in A * X = B, by forward substitution with L and then back
+   * substitution with U.
+   *
+   * \tparam m Number of columns in B.
+   *
+   * \param[in] b The right-hand side of the system.
+   *
+   * \returns The solution of the system.
+   */
+  template <std::size_t m> matrix<Q, d, m> solve(const matrix<Q, d, m> &b) const {
+    matrix<Q, d, m> x;
+
+    for (std::size_t i = 0; i < d; i++) {
+      for (std::size_t j = 0; j < m; j++) {
+        Q s = b[permutation[i]][j];
+        for (std::size_t k = 0; k < i; k++) {
+          s -= factors[i][k] * x[k][j];
+        }
+        x[i][j] = s;
+      }
+    }
+
+    for (std::size_t i = d; i-- > 0;) {
+      for (std::size_t j = 0; j < m; j++) {
+        Q s = x[i][j];
+        for (std::size_t k = i + 1; k < d; k++) {
+          s -= factors[i][k] * x[k][j];
+        }
+        x[i][j] = s / factors[i][i];
+      }
+    }
+
+    return x;
+  }
+
+  /**\brief Inverse of the decomposed matrix
+   *
+   * \returns The solution of A * X = I.
+   */
+  matrix<Q, d, d> inverse(void) const {
+    matrix<Q, d, d> identity;
+
+    for (std::size_t i = 0; i < d; i++) {
+      for (std::size_t j = 0; j < d; j++) {
+        identity[i][j] = i == j ? Q(1) : Q(0);
+      }
+    }
+
+    return solve(identity);
+  }
+};
+
+/**\brief QR decomposition
+ *
+ * Holds the factors of A = Q * R, where Q is an orthogonal matrix and R is an
+ * upper triangular matrix, as calculated with Householder reflections.
+ *
+ * \tparam Q The data type for individual matrix cells.
+ * \tparam n Number of rows in the decomposed matrix.
+ * \tparam m Number of columns in the decomposed matrix.
+ */
+template <typename Q, std::size_t n, std::size_t m> class qr {
+public:
+  /**\brief Orthogonal factor
+   */
+  matrix<Q, n, n> q;
+
+  /**\brief Upper triangular factor
+   */
+  matrix<Q, n, m> r;
+};
+}
+
+/**\brief Calculate LU decomposition
+ *
+ * Decomposes a square matrix with Gaussian elimination; in each column, the
+ * row with the largest pivot is swapped into place to keep the elimination
+ * numerically stable.
+ *
+ * \param[in] pM The matrix to decompose.
+ *
+ * \returns The decomposition of pM.
+ */
+template <typename Q, std::size_t d>
+decomposition::lu<Q, d> lu(const matrix<Q, d, d> &pM) {
+  decomposition::lu<Q, d> rv;
+  matrix<Q, d, d> &f = rv.factors;
+
+  f = pM;
+  rv.even = true;
+  rv.singular = false;
+
+  for (std::size_t i = 0; i < d; i++) {
+    rv.permutation[i] = i;
+  }
+
+  for (std::size_t k = 0; k < d; k++) {
+    std::size_t p = k;
+    Q max = f[k][k] < Q(0) ? -f[k][k] : f[k][k];
+
+    for (std::size_t i = k + 1; i < d; i++) {
+      const Q a = f[i][k] < Q(0) ? -f[i][k] : f[i][k];
+      if (a > max) {
+        max = a;
+        p = i;
+      }
+    }
+
+    if (max == Q(0)) {
+      rv.singular = true;
+      continue;
+    }
+
+    if (p != k) {
+      for (std::size_t j = 0; j < d; j++) {
+        const Q t = f[k][j];
+        f[k][j] = f[p][j];
+        f[p][j] = t;
+      }
+      const std::size_t t = rv.permutation[k];
+      rv.permutation[k] = rv.permutation[p];
+      rv.permutation[p] = t;
+      rv.even = !rv.even;
+    }
+
+    for (std::size_t i = k + 1; i < d; i++) {
+      const Q l = f[i][k] / f[k][k];
+      f[i][k] = l;
+      for (std::size_t j = k + 1; j < d; j++) {
+        f[i][j] -= l * f[k][j];
+      }
+    }
+  }
+
+  return rv;
+}
+
+/**\brief Calculate QR decomposition
+ *
+ * Decomposes a matrix by applying one Householder reflection per column, to
+ * zero out all cells below the diagonal; Q is the product of these
+ * reflections.
+ *
+ * \param[in] pM The matrix to decompose.
+ *
+ * \returns The decomposition of pM.
+ */
+template <typename Q, std::size_t n, std::size_t m>
+decomposition::qr<Q, n, m> qr(const matrix<Q, n, m> &pM) {
+  using std::sqrt;
+
+  decomposition::qr<Q, n, m> rv;
+  std::array<Q, n> v;
+
+  rv.r = pM;
+
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t j = 0; j < n; j++) {
+      rv.q[i][j] = i == j ? Q(1) : Q(0);
+    }
+  }
+
+  for (std::size_t k = 0; (k < m) && (k + 1 < n); k++) {
+    Q norm = Q(0);
+    for (std::size_t i = k; i < n; i++) {
+      norm += rv.r[i][k] * rv.r[i][k];
+    }
+    norm = sqrt(norm);
+
+    if (norm == Q(0)) {
+      continue;
+    }
+
+    const Q alpha = rv.r[k][k] > Q(0) ? -norm : norm;
+    Q vv = Q(0);
+    for (std::size_t i = k; i < n; i++) {
+      v[i] = rv.r[i][k] - (i == k ? alpha : Q(0));
+      vv += v[i] * v[i];
+    }
+
+    if (vv == Q(0)) {
+      continue;
+    }
+
+    for (std::size_t j = 0; j < m; j++) {
+      Q s = Q(0);
+      for (std::size_t i = k; i < n; i++) {
+        s += v[i] * rv.r[i][j];
+      }
+      s = Q(2) * s / vv;
+      for (std::size_t i = k; i < n; i++) {
+        rv.r[i][j] -= s * v[i];
+      }
+    }
+
+    for (std::size_t i = 0; i < n; i++) {
+      Q s = Q(0);
+      for (std::size_t j = k; j < n; j++) {
+        s += rv.q[i][j] * v[j];
+      }
+      s = Q(2) * s / vv;
+      for (std::size_t j = k; j < n; j++) {
+        rv.q[i][j] -= s * v[j];
+      }
+    }
+  }
+
+  return rv;
+}
+
+/**\brief Invert matrix
+ *
+ * Inverts a square matrix of any size using its LU decomposition. The 3x3
+ * case keeps using the closed-form solution.
+ *
+ * \param[in] pM The matrix to invert; must not be singular.
+ *
+ * \returns The inverse of pM.
+ */
+template <typename Q, std::size_t d>
+matrix<Q, d, d> invert(const matrix<Q, d, d> &pM) {
+  return lu(pM).inverse();
+}
 }
 }
 
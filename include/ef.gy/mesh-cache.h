@@ -0,0 +1,447 @@
+/**\file
+ * \brief Mesh cache
+ *
+ * Contains a cache for the indexed meshes of the models in the model factory,
+ * so that requesting the same model with the same parameters again, e.g. in
+ * a server or when rendering the same scene repeatedly, does not need to
+ * generate the model all over again.
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#if !defined(EF_GY_MESH_CACHE_H)
+#define EF_GY_MESH_CACHE_H
+
+#include <ef.gy/factory.h>
+#include <ef.gy/mesh.h>
+#include <array>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace efgy {
+namespace geometry {
+/**\brief Mesh cache
+ *
+ * Holds the indexed meshes of recently used models, up to a maximum number of
+ * bytes; when that is exceeded, the meshes that were used least recently are
+ * thrown away. Meshes are identified by the model's ID, depth and render
+ * depth, the vector format and those parameters that the model actually
+ * uses, so e.g. cubes with different precisions share a mesh.
+ *
+ * Meshes are handed out as shared pointers to constant data, so they stay
+ * valid after they are evicted, for as long as they are used. The cache may
+ * be used from several threads at the same time; meshes are generated
+ * outside of the lock, so a slow model does not hold up other requests.
+ *
+ * \tparam Q     Base data type for calculations and vertex buffers.
+ * \tparam index Type of the index buffer elements.
+ */
+template <typename Q, typename index = unsigned int> class meshCache {
+public:
+  /**\brief Cached mesh
+   *
+   * The buffers of an indexed mesh, as created by meshBuilder.
+   */
+  class mesh {
+  public:
+    /**\brief Vertex buffer
+     *
+     * Vertex coordinates, followed by the normal and the IFS index, for
+     * each vertex in turn.
+     */
+    std::vector<Q> vertices;
+
+    /**\brief Triangle indices
+     *
+     * Three vertex indices per triangle.
+     */
+    std::vector<index> triangles;
+
+    /**\brief Line indices
+     *
+     * Two vertex indices per line.
+     */
+    std::vector<index> lines;
+
+    /**\brief Vertex size
+     *
+     * The number of vertex buffer elements per vertex.
+     */
+    std::size_t stride;
+
+    /**\brief Memory use
+     *
+     * \returns The number of bytes used by the buffers.
+     */
+    std::size_t bytes(void) const {
+      return vertices.size() * sizeof(Q) +
+             (triangles.size() + lines.size()) * sizeof(index);
+    }
+  };
+
+  /**\brief Shared mesh
+   *
+   * What the cache hands out.
+   */
+  using pointer = std::shared_ptr<const mesh>;
+
+  /**\brief Factory request
+   *
+   * The argument for the functor::mesh factory functor: the cache and
+   * parameters to use, and the mesh that was found.
+   */
+  class request {
+  public:
+    /**\brief Construct with cache and parameters
+     *
+     * \param[in] pCache     The cache to look up meshes in.
+     * \param[in] pParameter The parameters to create models with.
+     */
+    request(meshCache &pCache, const parameters<Q> &pParameter)
+        : cache(pCache), parameter(pParameter) {}
+
+    /**\brief Mesh cache
+     *
+     * The cache to look up meshes in.
+     */
+    meshCache &cache;
+
+    /**\brief Model parameters
+     *
+     * The parameters to create models with.
+     */
+    const parameters<Q> &parameter;
+
+    /**\brief Result
+     *
+     * The mesh of the model that matched the request, if any; if several
+     * models matched, that of the last one.
+     */
+    pointer result;
+  };
+
+  /**\brief Construct with memory cap
+   *
+   * \param[in] pCapacity Maximum number of bytes of mesh data to hold.
+   */
+  meshCache(std::size_t pCapacity = std::size_t(64) << 20)
+      : capacity(pCapacity), used(0), hitCount(0), missCount(0),
+        evictionCount(0) {}
+
+  /**\brief Get mesh
+   *
+   * Looks up the mesh of a model, and generates it if it is not in the
+   * cache yet. Meshes that are larger than the memory cap on their own are
+   * generated every time.
+   *
+   * \tparam T      Model template, e.g. efgy::geometry::cube
+   * \tparam d      Model depth, e.g. 4 for a tesseract
+   * \tparam e      Model render depth, e.g. >= 4 when rendering a
+   *                tesseract
+   * \tparam format Vector coordinate format to work in.
+   *
+   * \param[in] parameter The parameters to create the model with.
+   * \param[in] tag       The vector format tag instance to use.
+   *
+   * \returns The mesh of the model.
+   */
+  template <template <class, std::size_t> class T, std::size_t d,
+            std::size_t e, typename format>
+  pointer get(const parameters<Q> &parameter, const format &tag = format()) {
+    const key k = identify<T<Q, d>>(d, e, tag.id(), parameter);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      const auto it = entries.find(k);
+      if (it != entries.end()) {
+        hitCount++;
+        recent.splice(recent.begin(), recent, it->second);
+        return it->second->second;
+      }
+      missCount++;
+    }
+
+    autoAdapt<Q, e, T<Q, d>, format> model(parameter, tag);
+    meshBuilder<Q, index> builder;
+    builder.add(model);
+
+    auto m = std::make_shared<mesh>();
+    m->vertices = std::move(builder.vertices);
+    m->triangles = std::move(builder.triangles);
+    m->lines = std::move(builder.lines);
+    m->stride = builder.stride;
+    m->vertices.shrink_to_fit();
+    m->triangles.shrink_to_fit();
+    m->lines.shrink_to_fit();
+    const pointer rv = m;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = entries.find(k);
+    if (it != entries.end()) {
+      recent.splice(recent.begin(), recent, it->second);
+      return it->second->second;
+    }
+    if (rv->bytes() <= capacity) {
+      recent.emplace_front(k, rv);
+      entries.emplace(k, recent.begin());
+      used += rv->bytes();
+      evict();
+    }
+    return rv;
+  }
+
+  /**\brief Set memory cap
+   *
+   * Changes the maximum number of bytes of mesh data to hold, evicting
+   * meshes if necessary.
+   *
+   * \param[in] pCapacity Maximum number of bytes of mesh data to hold.
+   */
+  void limit(std::size_t pCapacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = pCapacity;
+    evict();
+  }
+
+  /**\brief Remove everything
+   *
+   * Throws away all meshes; the statistics are kept.
+   */
+  void clear(void) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    recent.clear();
+    used = 0;
+  }
+
+  /**\brief Number of meshes
+   *
+   * \returns The number of meshes in the cache.
+   */
+  std::size_t size(void) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+  }
+
+  /**\brief Memory use
+   *
+   * \returns The number of bytes of mesh data in the cache.
+   */
+  std::size_t bytes(void) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return used;
+  }
+
+  /**\brief Cache hits
+   *
+   * \returns The number of requests that were answered from the cache.
+   */
+  std::size_t hits(void) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hitCount;
+  }
+
+  /**\brief Cache misses
+   *
+   * \returns The number of requests that had to generate a mesh.
+   */
+  std::size_t misses(void) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return missCount;
+  }
+
+  /**\brief Evictions
+   *
+   * \returns The number of meshes that were thrown away to stay within the
+   *     memory cap.
+   */
+  std::size_t evictions(void) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return evictionCount;
+  }
+
+protected:
+  /**\brief Cache key
+   *
+   * Identifies a model; parameters that the model does not use are set to
+   * zero, so they do not make a difference.
+   */
+  class key {
+  public:
+    /**\brief Model ID, followed by the format ID */
+    std::string id;
+    /**\brief Model depth and render depth */
+    std::array<std::size_t, 2> depth;
+    /**\brief Radius, secondary radius, constant and precision */
+    std::array<Q, 4> reals;
+    /**\brief Iterations, functions, seed, rotation flags, flame
+     * coefficients and vertex limit */
+    std::array<unsigned long long, 7> integers;
+
+    bool operator==(const key &b) const {
+      return id == b.id && depth == b.depth && reals == b.reals &&
+             integers == b.integers;
+    }
+  };
+
+  /**\brief Key hash
+   *
+   * Mixes the hashes of all the fields of a key.
+   */
+  class hash {
+  public:
+    std::size_t operator()(const key &k) const {
+      std::size_t h = std::hash<std::string>()(k.id);
+      const auto mix = [&h](std::size_t v) {
+        h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+      };
+      for (const auto &v : k.depth) {
+        mix(v);
+      }
+      for (const auto &v : k.reals) {
+        mix(std::hash<Q>()(v));
+      }
+      for (const auto &v : k.integers) {
+        mix(std::hash<unsigned long long>()(v));
+      }
+      return h;
+    }
+  };
+
+  /**\brief Identify model
+   *
+   * \tparam model The model type.
+   *
+   * \param[in] d         Model depth.
+   * \param[in] e         Model render depth.
+   * \param[in] format    ID of the vector format.
+   * \param[in] parameter The parameters to create the model with.
+   *
+   * \returns The cache key for the model.
+   */
+  template <class model>
+  static key identify(std::size_t d, std::size_t e, const char *format,
+                      const parameters<Q> &parameter) {
+    using used = typename model::usedParameters;
+    key k;
+    k.id = std::string(model::id()) + "@" + format;
+    k.depth = {{d, e}};
+    k.reals = {{used::radius ? parameter.radius : Q(0),
+                used::radius2 ? parameter.radius2 : Q(0),
+                used::constant ? parameter.constant : Q(0),
+                used::precision ? parameter.precision : Q(0)}};
+    k.integers = {
+        {used::iterations ? parameter.iterations : 0ull,
+         used::functions ? parameter.functions : 0ull,
+         used::seed ? parameter.seed : 0ull,
+         used::preRotate ? parameter.preRotate : 0ull,
+         used::postRotate ? parameter.postRotate : 0ull,
+         used::flameCoefficients ? parameter.flameCoefficients : 0ull,
+         parameter.vertexLimit}};
+    return k;
+  }
+
+  /**\brief Evict meshes
+   *
+   * Throws away the least recently used meshes until the cache is within
+   * its memory cap. Must be called with the lock held.
+   */
+  void evict(void) {
+    while (used > capacity && !recent.empty()) {
+      used -= recent.back().second->bytes();
+      entries.erase(recent.back().first);
+      recent.pop_back();
+      evictionCount++;
+    }
+  }
+
+  /**\brief Memory cap
+   *
+   * Maximum number of bytes of mesh data to hold.
+   */
+  std::size_t capacity;
+
+  /**\brief Memory use
+   *
+   * Number of bytes of mesh data in the cache.
+   */
+  std::size_t used;
+
+  /**\brief Statistics
+   *
+   * Number of hits, misses and evictions since the cache was created.
+   */
+  std::size_t hitCount, missCount, evictionCount;
+
+  /**\brief Meshes by use
+   *
+   * All meshes in the cache, the most recently used one first.
+   */
+  std::list<std::pair<key, pointer>> recent;
+
+  /**\brief Meshes by key
+   *
+   * Where to find each mesh in the list of meshes by use.
+   */
+  std::unordered_map<key, typename std::list<std::pair<key, pointer>>::iterator,
+                     hash> entries;
+
+  /**\brief Lock
+   *
+   * Protects all of the above.
+   */
+  mutable std::mutex mutex;
+};
+
+namespace functor {
+/**\brief Geometry factory functor: look up meshes in a cache
+ *
+ * Gets the indexed mesh of the matching model from a mesh cache, which only
+ * generates the model if it was not requested with the same parameters
+ * recently.
+ *
+ * \tparam Q      Base data type for calculations
+ * \tparam T      Model template, e.g. efgy::geometry::cube
+ * \tparam d      Model depth, e.g. 4 for a tesseract
+ * \tparam e      Model render depth, e.g. >= 4 when rendering a
+ *                tesseract
+ * \tparam format Vector coordinate format to work in.
+ */
+template <typename Q, template <class, std::size_t> class T, std::size_t d,
+          std::size_t e, typename format>
+class mesh : public symmetric<typename meshCache<Q>::request> {
+public:
+  using typename symmetric<typename meshCache<Q>::request>::argument;
+  using typename symmetric<typename meshCache<Q>::request>::output;
+
+  /**\brief Look up mesh
+   *
+   * Sets the request's result to the mesh of the model.
+   *
+   * \param[out] out The request to answer.
+   * \param[in]  tag The vector format tag instance to use.
+   *
+   * \returns out, after setting its result.
+   */
+  static output apply(argument out, const format &tag) {
+    out.result = out.cache.template get<T, d, e>(out.parameter, tag);
+    return out;
+  }
+};
+}
+}
+}
+
+#endif
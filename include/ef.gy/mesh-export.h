@@ -0,0 +1,327 @@
+/**\file
+ * \brief Mesh file export
+ *
+ * Contains exporters that write models to the common PLY, STL and OBJ mesh
+ * file formats. The exporters work directly on a model's face iterator and
+ * write through a fixed size buffer, so the mesh never has to be in memory
+ * as a whole and the size of a model is only limited by the file formats.
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ * \see http://paulbourke.net/dataformats/ply/ for the PLY format.
+ * \see http://www.fabbers.com/tech/STL_Format for the STL format.
+ * \see http://paulbourke.net/dataformats/obj/ for the OBJ format.
+ */
+
+#if !defined(EF_GY_MESH_EXPORT_H)
+#define EF_GY_MESH_EXPORT_H
+
+#include <ef.gy/euclidian.h>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace efgy {
+namespace geometry {
+/**\brief Buffered binary output
+ *
+ * Collects data in a fixed size buffer and writes it to a stream whenever the
+ * buffer is full, which is a lot faster than writing every value to the
+ * stream on its own. Numbers are written in little endian byte order, which
+ * is what both the binary PLY and the STL formats use.
+ */
+class writeBuffer {
+public:
+  /**\brief Construct with stream
+   *
+   * \param[out] pStream The stream to write to.
+   */
+  writeBuffer(std::ostream &pStream) : stream(pStream), used(0) {}
+
+  /**\brief Flush on destruction
+   *
+   * Writes whatever is still in the buffer.
+   */
+  ~writeBuffer(void) { flush(); }
+
+  /**\brief Write bytes
+   *
+   * \param[in] data   The bytes to write.
+   * \param[in] length The number of bytes to write.
+   */
+  void write(const char *data, std::size_t length) {
+    while (length > 0) {
+      if (used == buffer.size()) {
+        flush();
+      }
+      const std::size_t n = std::min(length, buffer.size() - used);
+      std::memcpy(buffer.data() + used, data, n);
+      used += n;
+      data += n;
+      length -= n;
+    }
+  }
+
+  /**\brief Write string
+   *
+   * \param[in] s The string to write, without its terminating zero.
+   */
+  void write(const std::string &s) { write(s.data(), s.size()); }
+
+  /**\brief Write number
+   *
+   * \tparam T Type of the number.
+   *
+   * \param[in] v The number to write, in little endian byte order.
+   */
+  template <typename T> void put(const T &v) {
+    char b[sizeof(T)];
+    std::memcpy(b, &v, sizeof(T));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    std::reverse(b, b + sizeof(T));
+#endif
+    write(b, sizeof(T));
+  }
+
+  /**\brief Write number as text
+   *
+   * \param[in] v The number to write, in the shortest form that reads back
+   *              as the same value.
+   */
+  template <typename T> void text(const T &v) {
+    if (buffer.size() - used < 32) {
+      flush();
+    }
+    const auto r =
+        std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), v);
+    used = r.ptr - buffer.data();
+  }
+
+  /**\brief Write buffer contents
+   *
+   * Writes everything in the buffer to the stream and empties the buffer.
+   */
+  void flush(void) {
+    stream.write(buffer.data(), used);
+    used = 0;
+  }
+
+protected:
+  std::ostream &stream;
+  std::array<char, 1 << 16> buffer;
+  std::size_t used;
+};
+
+/**\brief Cartesian face coordinates
+ *
+ * \tparam e The number of coordinates to produce.
+ *
+ * \param[in] v A face vertex.
+ *
+ * \returns The first 'e' coordinates of the vertex, padded with zeroes.
+ */
+template <std::size_t e, typename Q, unsigned int d, typename format>
+static inline std::array<float, e>
+coordinates(const math::vector<Q, d, format> &v) {
+  const math::vector<Q, d> c = v;
+  std::array<float, e> r{};
+  for (std::size_t i = 0; i < e && i < d; i++) {
+    r[i] = float(c[i]);
+  }
+  return r;
+}
+
+/**\brief Write binary PLY file
+ *
+ * Writes the vertices of all of a model's faces, followed by the faces as
+ * lists of indices; as the faces do not share vertices, the faces can be
+ * written without looking at the model again. Vertices have one 'float'
+ * property per coordinate.
+ *
+ * The vertex and face counts in the header are based on the model's size; if
+ * the model ends up producing fewer faces, the stream's failbit is set.
+ *
+ * \tparam model The model type.
+ *
+ * \param[out] stream The stream to write to.
+ * \param[in]  m      The model to write.
+ *
+ * \returns The number of faces that were written.
+ */
+template <typename model>
+static inline std::size_t ply(std::ostream &stream, model &m) {
+  constexpr const std::size_t d = model::renderDepth;
+  constexpr const std::size_t q = model::faceVertices;
+  static const char *names[] = {"x", "y", "z", "w"};
+
+  const std::size_t faces = m.size();
+  writeBuffer out(stream);
+
+  out.write("ply\nformat binary_little_endian 1.0\ncomment " +
+            std::string(model::id()) + "\nelement vertex " +
+            std::to_string(faces * q) + "\n");
+  for (std::size_t i = 0; i < d; i++) {
+    out.write("property float " +
+              (i < 4 ? std::string(names[i]) : "c" + std::to_string(i)) +
+              "\n");
+  }
+  out.write("element face " + std::to_string(faces) +
+            "\nproperty list uchar uint vertex_indices\nend_header\n");
+
+  std::size_t n = 0;
+  const auto begin = m.begin();
+  const auto end = m.end();
+  for (auto it = begin; n < faces && it != end; ++it, ++n) {
+    for (const auto &v : *it) {
+      for (const auto &c : coordinates<d>(v)) {
+        out.put(c);
+      }
+    }
+  }
+
+  if (n < faces) {
+    stream.setstate(std::ios::failbit);
+  }
+
+  for (std::uint32_t i = 0; i < n; i++) {
+    out.put(std::uint8_t(q));
+    for (std::uint32_t j = 0; j < q; j++) {
+      out.put(std::uint32_t(i * q + j));
+    }
+  }
+
+  return n;
+}
+
+/**\brief Write binary STL file
+ *
+ * Writes all of a model's faces as triangles, splitting larger polygons into
+ * triangle fans. The format is three dimensional, so only the first three
+ * coordinates of the model are used; normals are calculated from the first
+ * triangle of each face.
+ *
+ * The triangle count at the start of the file is based on the model's size;
+ * if the model ends up producing fewer faces, the count is corrected if the
+ * stream allows seeking back, and the stream's failbit is set otherwise.
+ *
+ * \tparam model The model type.
+ *
+ * \param[out] stream The stream to write to.
+ * \param[in]  m      The model to write.
+ *
+ * \returns The number of faces that were written.
+ */
+template <typename model>
+static inline std::size_t stl(std::ostream &stream, model &m) {
+  constexpr const std::size_t q = model::faceVertices;
+  static_assert(q >= 3, "STL files can only contain polygons");
+
+  const std::size_t faces = m.size();
+  const auto start = stream.tellp();
+  std::size_t n = 0;
+
+  {
+    writeBuffer out(stream);
+
+    std::string header = std::string("libefgy ") + model::id();
+    header.resize(80, ' ');
+    out.write(header);
+    out.put(std::uint32_t(faces * (q - 2)));
+
+    const auto begin = m.begin();
+    const auto end = m.end();
+    for (auto it = begin; n < faces && it != end; ++it, ++n) {
+      std::array<math::vector<float, 3>, q> V;
+      for (std::size_t i = 0; i < q; i++) {
+        V[i] = coordinates<3>((*it)[i]);
+      }
+
+      auto R = math::crossProduct(V[1] - V[0], V[2] - V[0]);
+      const float l = math::length(R);
+      if (l > 0) {
+        R = R / l;
+      }
+
+      for (std::size_t j = 2; j < q; j++) {
+        for (const auto &v : {R, V[0], V[j - 1], V[j]}) {
+          for (std::size_t i = 0; i < 3; i++) {
+            out.put(v[i]);
+          }
+        }
+        out.put(std::uint16_t(0));
+      }
+    }
+  }
+
+  if (n < faces) {
+    const auto end = stream.tellp();
+    if (start != std::ostream::pos_type(-1) &&
+        stream.seekp(start + std::streamoff(80))) {
+      writeBuffer out(stream);
+      out.put(std::uint32_t(n * (q - 2)));
+      out.flush();
+      stream.seekp(end);
+    } else {
+      stream.setstate(std::ios::failbit);
+    }
+  }
+
+  return n;
+}
+
+/**\brief Write OBJ file
+ *
+ * Writes each face's vertices followed by the face itself, using relative
+ * vertex indices, so the file is written in a single pass. The format is
+ * three dimensional, so only the first three coordinates of the model are
+ * used.
+ *
+ * \tparam model The model type.
+ *
+ * \param[out] stream The stream to write to.
+ * \param[in]  m      The model to write.
+ *
+ * \returns The number of faces that were written.
+ */
+template <typename model>
+static inline std::size_t obj(std::ostream &stream, model &m) {
+  constexpr const std::size_t q = model::faceVertices;
+
+  writeBuffer out(stream);
+  out.write(std::string("# libefgy ") + model::id() + "\n");
+
+  std::size_t n = 0;
+  const auto begin = m.begin();
+  const auto end = m.end();
+  for (auto it = begin; it != end; ++it, ++n) {
+    for (const auto &v : *it) {
+      out.write("v", 1);
+      for (const auto &c : coordinates<3>(v)) {
+        out.write(" ", 1);
+        out.text(c);
+      }
+      out.write("\n", 1);
+    }
+    out.write("f", 1);
+    for (std::size_t i = q; i > 0; i--) {
+      out.write(" -", 2);
+      out.text(i);
+    }
+    out.write("\n", 1);
+  }
+
+  return n;
+}
+}
+}
+
+#endif
@@ -0,0 +1,347 @@
+/**\file
+ * \brief Indexed meshes
+ *
+ * Contains a builder for indexed meshes, which turns the faces produced by a
+ * model's iterator into a vertex buffer with triangle and line index buffers,
+ * sharing vertices between faces wherever possible. This is what renderers
+ * like the OpenGL one need to upload models, but it does not depend on any
+ * of them.
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#if !defined(EF_GY_MESH_H)
+#define EF_GY_MESH_H
+
+#include <ef.gy/euclidian.h>
+#include <ef.gy/prng.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace efgy {
+namespace geometry {
+/**\brief Indexed mesh builder
+ *
+ * Collects polygons into a vertex buffer, a triangle index buffer and a line
+ * index buffer for their outlines. Each vertex consists of its coordinates,
+ * its normal and an IFS index, and vertices that agree in all of these after
+ * rounding to a multiple of the quantum are only stored once.
+ *
+ * Vertices are looked up in an open addressing hash table with linear
+ * probing, which only holds indices into the vertex buffer, so adding a
+ * vertex never allocates unless one of the buffers needs to grow.
+ *
+ * \tparam Q     Type of the vertex buffer elements; should be a floating point
+ *               type.
+ * \tparam index Type of the index buffer elements.
+ */
+template <typename Q, typename index = unsigned int> class meshBuilder {
+public:
+  /**\brief Construct with quantum
+   *
+   * \param[in] pQuantum Vertex components that round to the same multiple of
+   *                     this are considered equal.
+   */
+  meshBuilder(const Q &pQuantum = Q(1) / Q(1 << 20))
+      : quantum(pQuantum), stride(0), slots(0) {}
+
+  /**\brief Quantum
+   *
+   * Vertex components that round to the same multiple of this are considered
+   * equal.
+   */
+  const Q quantum;
+
+  /**\brief Vertex buffer
+   *
+   * Vertex coordinates, followed by the normal and the IFS index, for each
+   * vertex in turn.
+   */
+  std::vector<Q> vertices;
+
+  /**\brief Triangle indices
+   *
+   * Three vertex indices per triangle.
+   */
+  std::vector<index> triangles;
+
+  /**\brief Line indices
+   *
+   * Two vertex indices per line.
+   */
+  std::vector<index> lines;
+
+  /**\brief Vertex size
+   *
+   * The number of vertex buffer elements per vertex; set by the first vertex
+   * that is added.
+   */
+  std::size_t stride;
+
+  /**\brief Number of vertices
+   *
+   * \returns The number of distinct vertices in the vertex buffer.
+   */
+  std::size_t size(void) const { return stride ? vertices.size() / stride : 0; }
+
+  /**\brief Remove everything
+   *
+   * Empties all buffers, so the builder can be reused for another mesh with
+   * vertices of any size.
+   */
+  void clear(void) {
+    vertices.clear();
+    triangles.clear();
+    lines.clear();
+    hashes.clear();
+    table.clear();
+    stride = 0;
+    slots = 0;
+  }
+
+  /**\brief Add vertex
+   *
+   * Looks up a vertex and adds it to the vertex buffer if it is not in there
+   * yet. All vertices added to a mesh must have the same depth.
+   *
+   * \tparam T Base type of the vertex.
+   * \tparam e The depth of the vertex.
+   *
+   * \param[in] c  Coordinates of the vertex.
+   * \param[in] n  Normal of the vertex.
+   * \param[in] id IFS index of the vertex.
+   *
+   * \returns The index of the vertex in the vertex buffer.
+   */
+  template <typename T, unsigned int e>
+  index add(const math::vector<T, e> &c, const math::vector<T, e> &n,
+            const T &id) {
+    constexpr const std::size_t s = 2 * e + 1;
+    if (stride == 0) {
+      stride = s;
+    }
+
+    std::array<Q, s> v;
+    std::array<std::int64_t, s> k;
+    for (std::size_t i = 0; i < e; i++) {
+      v[i] = Q(c[i]);
+      v[e + i] = Q(n[i]);
+    }
+    v[2 * e] = Q(id);
+
+    std::uint64_t hash = 0;
+    for (std::size_t i = 0; i < s; i++) {
+      k[i] = quantise(v[i]);
+      hash = prng::splitmix::mix(hash ^ std::uint64_t(k[i]));
+    }
+
+    if (2 * (slots + 1) > table.size()) {
+      grow();
+    }
+
+    const std::size_t mask = table.size() - 1;
+    for (std::size_t p = hash & mask;; p = (p + 1) & mask) {
+      const index t = table[p];
+      if (t == 0) {
+        const index r = index(slots);
+        table[p] = r + 1;
+        slots++;
+        vertices.insert(vertices.end(), v.begin(), v.end());
+        hashes.push_back(hash);
+        return r;
+      }
+      if (hashes[t - 1] == hash && same(k, vertices.data() + (t - 1) * s)) {
+        return t - 1;
+      }
+    }
+  }
+
+  /**\brief Add polygon
+   *
+   * Adds a convex polygon as a fan of triangles, and its outline as lines.
+   *
+   * \tparam T Base type of the vertices.
+   * \tparam e The depth of the vertices.
+   * \tparam q The number of vertices of the polygon.
+   *
+   * \param[in] pV The vertices of the polygon.
+   * \param[in] R  Normal of the polygon.
+   * \param[in] id IFS index of the polygon.
+   */
+  template <typename T, unsigned int e, std::size_t q>
+  void add(const std::array<math::vector<T, e>, q> &pV,
+           const math::vector<T, e> &R, const T &id) {
+    triangles.push_back(add<T, e>(pV[0], R, id));
+    const index start = triangles.back();
+    lines.push_back(start);
+    triangles.push_back(add<T, e>(pV[1], R, id));
+    lines.push_back(triangles.back());
+    lines.push_back(triangles.back());
+    triangles.push_back(add<T, e>(pV[2], R, id));
+    index end = triangles.back();
+    lines.push_back(end);
+
+    for (std::size_t j = 3; j < q; j++) {
+      triangles.push_back(start);
+      triangles.push_back(end);
+      lines.push_back(end);
+      triangles.push_back(add<T, e>(pV[j], R, id));
+      end = triangles.back();
+      lines.push_back(end);
+    }
+
+    lines.push_back(end);
+    lines.push_back(start);
+  }
+
+  /**\brief Add model faces
+   *
+   * Adds all faces in a range, e.g. those of a model. Normals are calculated
+   * from the first vertices of each face; faces with fewer vertices than
+   * dimensions get a zero normal.
+   *
+   * \tparam iterator Forward iterator over polygons.
+   *
+   * \param[in] begin Start of the range.
+   * \param[in] end   End of the range.
+   * \param[in] id    IFS index of the faces.
+   */
+  template <typename iterator>
+  void add(iterator begin, iterator end, const Q &id = Q(0.5)) {
+    for (; begin != end; ++begin) {
+      addFace(*begin, id);
+    }
+  }
+
+  /**\brief Add model
+   *
+   * Adds all faces of a model. Some models only create their faces in
+   * begin(), so this makes sure to call that before end().
+   *
+   * \tparam model The model type.
+   *
+   * \param[in] m  The model to add.
+   * \param[in] id IFS index of the faces.
+   */
+  template <typename model> void add(model &m, const Q &id = Q(0.5)) {
+    const auto begin = m.begin();
+    add(begin, m.end(), id);
+  }
+
+protected:
+  /**\brief Vertex hashes
+   *
+   * The hash of each vertex's quantised elements, so the table can grow
+   * without hashing everything again and most mismatches are found without
+   * comparing vertices.
+   */
+  std::vector<std::uint64_t> hashes;
+
+  /**\brief Hash table
+   *
+   * One more than the index of the vertex in each slot, or zero for empty
+   * slots. The size is always a power of two.
+   */
+  std::vector<index> table;
+
+  /**\brief Number of vertices
+   *
+   * The number of vertices in the hash table.
+   */
+  std::size_t slots;
+
+  /**\brief Quantise vertex component
+   *
+   * \param[in] v A vertex component.
+   *
+   * \returns 'v' as a multiple of the quantum.
+   */
+  std::int64_t quantise(const Q &v) const {
+    return std::isfinite(v) ? std::int64_t(std::floor(v / quantum + Q(0.5))) : 0;
+  }
+
+  /**\brief Compare vertex
+   *
+   * \tparam s The number of elements per vertex.
+   *
+   * \param[in] k Quantised elements of a vertex.
+   * \param[in] v Elements of a vertex in the vertex buffer.
+   *
+   * \returns Whether the vertices are the same after quantisation.
+   */
+  template <std::size_t s>
+  bool same(const std::array<std::int64_t, s> &k, const Q *v) const {
+    for (std::size_t i = 0; i < s; i++) {
+      if (k[i] != quantise(v[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**\brief Grow hash table
+   *
+   * Doubles the size of the table and puts all vertices back in.
+   */
+  void grow(void) {
+    table.assign(table.empty() ? 1024 : table.size() * 2, 0);
+    const std::size_t mask = table.size() - 1;
+    for (std::size_t i = 0; i < slots; i++) {
+      std::size_t p = hashes[i] & mask;
+      while (table[p] != 0) {
+        p = (p + 1) & mask;
+      }
+      table[p] = index(i + 1);
+    }
+  }
+
+  /**\brief Add face with calculated normal
+   *
+   * \tparam T      Base type of the vertices.
+   * \tparam e      The depth of the vertices.
+   * \tparam format Vector format of the vertices.
+   * \tparam q      The number of vertices of the face.
+   *
+   * \param[in] pV The vertices of the face.
+   * \param[in] id IFS index of the face.
+   */
+  template <typename T, unsigned int e, typename format, std::size_t q>
+  void addFace(const std::array<math::vector<T, e, format>, q> &pV,
+               const Q &id) {
+    std::array<math::vector<T, e>, q> V;
+    for (std::size_t i = 0; i < q; i++) {
+      V[i] = pV[i];
+    }
+
+    math::vector<T, e> R;
+    if constexpr (e == 3) {
+      R = math::crossProduct(V[1] - V[0], V[2] - V[0]);
+    } else if constexpr (e > 1 && q >= e) {
+      std::array<math::vector<T, e>, e - 1> edges;
+      for (std::size_t i = 0; i < e - 1; i++) {
+        edges[i] = V[i + 1] - V[0];
+      }
+      R = math::normal(edges);
+    }
+
+    const T l = math::length(R);
+    if (l > T(0)) {
+      R = R / l;
+    }
+
+    add(V, R, T(id));
+  }
+};
+}
+}
+
+#endif
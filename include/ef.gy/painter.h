@@ -0,0 +1,358 @@
+/**\file
+ * \brief Depth sorted output
+ *
+ * Contains a buffer for the painter's algorithm: projected polygons are
+ * collected along with their depth, and then handed back from the back to the
+ * front, so that renderers without a depth buffer - like the SVG renderer -
+ * can draw overlapping faces in the right order.
+ *
+ * Polygons are sorted with a parallel radix sort on their quantised depth. To
+ * keep memory use bounded for very large models, full chunks are sorted and
+ * moved to temporary files, which are merged again at the end. If temporary
+ * files cannot be written, polygons stay in memory instead.
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#if !defined(EF_GY_PAINTER_H)
+#define EF_GY_PAINTER_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace efgy {
+namespace render {
+/**\brief Painter's algorithm buffer
+ *
+ * Collects 2D polygons with a depth each and returns them sorted from the
+ * largest depth to the smallest, i.e. from the back to the front. Polygons
+ * with the same depth, after rounding it to single precision, come back in
+ * the order they were added in.
+ */
+class painter {
+public:
+  /**\brief Construct with limits
+   *
+   * \param[in] pChunk   Number of polygons to keep in memory; when there are
+   *     more, they are sorted and moved to a temporary file if possible.
+   * \param[in] pThreads Number of threads to sort with; 0 uses one thread per
+   *     core.
+   */
+  painter(std::size_t pChunk = 1 << 18, std::size_t pThreads = 0)
+      : chunk(pChunk > 0 ? pChunk : 1), threads(pThreads), spilled(0),
+        kept(0) {}
+
+  /**\brief Chunk size
+   *
+   * Number of polygons to keep in memory.
+   */
+  std::size_t chunk;
+
+  /**\brief Number of threads
+   *
+   * Number of threads to sort with; 0 uses one thread per core.
+   */
+  std::size_t threads;
+
+  /**\brief Number of polygons
+   *
+   * \returns The number of polygons added since the last flush().
+   */
+  std::size_t size(void) const { return entries.size() + spilled; }
+
+  /**\brief Number of temporary files
+   *
+   * \returns The number of sorted chunks that are currently in temporary
+   *     files.
+   */
+  std::size_t runs(void) const { return files.size(); }
+
+  /**\brief Add polygon
+   *
+   * \param[in] depth    The polygon's depth; larger means further away.
+   * \param[in] xy       The polygon's x and y coordinates, one vertex after
+   *     the other.
+   * \param[in] vertices The number of vertices of the polygon.
+   */
+  void add(double depth, const double *xy, std::size_t vertices) {
+    if (entries.size() >= kept + chunk) {
+      spill();
+    }
+
+    entries.push_back({quantise(depth), std::uint32_t(vertices),
+                       coordinates.size()});
+    coordinates.insert(coordinates.end(), xy, xy + 2 * vertices);
+  }
+
+  /**\brief Write polygons back to front
+   *
+   * Sorts all polygons and passes them to a function, starting with the one
+   * that is furthest away, then empties the buffer. Polygons that are still
+   * in memory are sorted and merged with those in temporary files.
+   *
+   * \param[in] emit Called with the coordinates and the number of vertices of
+   *     each polygon.
+   *
+   * \throws std::runtime_error if a temporary file could not be read back.
+   */
+  void flush(const std::function<void(const double *, std::size_t)> &emit) {
+    sort();
+    if (files.empty()) {
+      for (const auto &e : entries) {
+        emit(coordinates.data() + e.offset, e.vertices);
+      }
+    } else {
+      merge(emit);
+    }
+
+    clear();
+  }
+
+  /**\brief Remove everything
+   *
+   * Throws away all polygons, including those in temporary files.
+   */
+  void clear(void) {
+    entries.clear();
+    coordinates.clear();
+    files.clear();
+    spilled = 0;
+    kept = 0;
+  }
+
+protected:
+  /**\brief Buffered polygon
+   *
+   * The sort key, vertex count and coordinate offset of a polygon.
+   */
+  class entry {
+  public:
+    /**\brief Sort key; smaller keys are further away. */
+    std::uint32_t key;
+    /**\brief Number of vertices. */
+    std::uint32_t vertices;
+    /**\brief Offset of the first coordinate in the coordinate buffer. */
+    std::size_t offset;
+  };
+
+  /**\brief Temporary file
+   *
+   * Closes, and thereby removes, the file when it is no longer needed.
+   */
+  using file = std::unique_ptr<std::FILE, int (*)(std::FILE *)>;
+
+  /**\brief Polygons in memory */
+  std::vector<entry> entries;
+
+  /**\brief Coordinates of the polygons in memory */
+  std::vector<double> coordinates;
+
+  /**\brief Sorted chunks in temporary files */
+  std::vector<file> files;
+
+  /**\brief Number of polygons in temporary files */
+  std::size_t spilled;
+
+  /**\brief Number of polygons kept in memory after a failed spill */
+  std::size_t kept;
+
+  /**\brief Quantise depth
+   *
+   * Rounds the depth to single precision and maps it to an integer, so that
+   * the integers are in the opposite order of the depths.
+   *
+   * \param[in] depth The depth to quantise.
+   *
+   * \returns The sort key for the depth.
+   */
+  static std::uint32_t quantise(double depth) {
+    const float f = float(depth);
+    std::uint32_t b;
+    std::memcpy(&b, &f, sizeof(b));
+    b = (b & 0x80000000u) ? ~b : (b | 0x80000000u);
+    return ~b;
+  }
+
+  /**\brief Sort polygons in memory
+   *
+   * A least significant digit radix sort over the keys, one byte at a time;
+   * every pass splits the polygons between the threads, which count the
+   * digits in their part and then move their polygons to where they belong.
+   * Passes where all keys have the same digit are skipped.
+   */
+  void sort(void) {
+    const std::size_t n = entries.size();
+    std::size_t t = threads > 0 ? threads : std::thread::hardware_concurrency();
+    t = std::max<std::size_t>(1, std::min(t, n / (1 << 14)));
+
+    std::vector<entry> scratch(n);
+    std::vector<std::array<std::size_t, 256>> counts(t);
+
+    for (unsigned int shift = 0; shift < 32; shift += 8) {
+      const auto parallel = [&](const std::function<void(std::size_t)> &f) {
+        std::vector<std::thread> workers;
+        for (std::size_t k = 1; k < t; k++) {
+          workers.emplace_back(f, k);
+        }
+        f(0);
+        for (auto &w : workers) {
+          w.join();
+        }
+      };
+
+      parallel([&](std::size_t k) {
+        auto &c = counts[k];
+        c.fill(0);
+        for (std::size_t i = n * k / t; i < n * (k + 1) / t; i++) {
+          c[(entries[i].key >> shift) & 0xff]++;
+        }
+      });
+
+      std::size_t offset = 0;
+      bool trivial = false;
+      for (std::size_t digit = 0; digit < 256; digit++) {
+        std::size_t total = 0;
+        for (auto &c : counts) {
+          const std::size_t count = c[digit];
+          c[digit] = offset + total;
+          total += count;
+        }
+        trivial = trivial || total == n;
+        offset += total;
+      }
+      if (trivial) {
+        continue;
+      }
+
+      parallel([&](std::size_t k) {
+        auto &c = counts[k];
+        for (std::size_t i = n * k / t; i < n * (k + 1) / t; i++) {
+          scratch[c[(entries[i].key >> shift) & 0xff]++] = entries[i];
+        }
+      });
+
+      entries.swap(scratch);
+    }
+  }
+
+  /**\brief Move polygons to temporary file
+   *
+   * Sorts the polygons in memory and writes them to a new temporary file. If
+   * no temporary file can be created or written to, the polygons stay in
+   * memory and the next attempt is made once another chunk has been added.
+   */
+  void spill(void) {
+    if (entries.empty()) {
+      return;
+    }
+
+    sort();
+
+    file f(std::tmpfile(), std::fclose);
+    bool written = bool(f);
+    for (auto e = entries.begin(); written && e != entries.end(); e++) {
+      written =
+          std::fwrite(&e->key, sizeof(e->key), 1, f.get()) == 1 &&
+          std::fwrite(&e->vertices, sizeof(e->vertices), 1, f.get()) == 1 &&
+          std::fwrite(coordinates.data() + e->offset, sizeof(double),
+                      2 * e->vertices, f.get()) == 2 * e->vertices;
+    }
+    if (!written || std::fflush(f.get()) != 0) {
+      kept = entries.size();
+      return;
+    }
+    std::rewind(f.get());
+
+    spilled += entries.size();
+    files.push_back(std::move(f));
+    entries.clear();
+    coordinates.clear();
+    kept = 0;
+  }
+
+  /**\brief Merge temporary files
+   *
+   * Reads all temporary files and the sorted polygons in memory at the same
+   * time, always passing on the polygon with the smallest key; of polygons
+   * with the same key, the one from the oldest file goes first, and those in
+   * memory go last.
+   *
+   * \param[in] emit Called with the coordinates and the number of vertices of
+   *     each polygon.
+   *
+   * \throws std::runtime_error if a temporary file could not be read back.
+   */
+  void merge(const std::function<void(const double *, std::size_t)> &emit) {
+    const std::size_t memory = files.size();
+    std::vector<std::vector<double>> current(files.size());
+    std::vector<std::uint32_t> vertices(files.size());
+    std::size_t position = 0;
+    std::priority_queue<std::pair<std::uint32_t, std::size_t>,
+                        std::vector<std::pair<std::uint32_t, std::size_t>>,
+                        std::greater<std::pair<std::uint32_t, std::size_t>>>
+        queue;
+
+    const auto next = [&](std::size_t r) {
+      if (r == memory) {
+        if (position < entries.size()) {
+          queue.push({entries[position].key, r});
+        }
+        return;
+      }
+
+      std::FILE *f = files[r].get();
+      std::uint32_t key;
+      if (std::fread(&key, sizeof(key), 1, f) != 1) {
+        if (std::ferror(f)) {
+          throw std::runtime_error("could not read painter's temporary file");
+        }
+        return;
+      }
+      if (std::fread(&vertices[r], sizeof(vertices[r]), 1, f) != 1) {
+        throw std::runtime_error("truncated painter's temporary file");
+      }
+      current[r].resize(2 * vertices[r]);
+      if (std::fread(current[r].data(), sizeof(double), current[r].size(),
+                     f) != current[r].size()) {
+        throw std::runtime_error("truncated painter's temporary file");
+      }
+      queue.push({key, r});
+    };
+
+    for (std::size_t r = 0; r <= memory; r++) {
+      next(r);
+    }
+
+    while (!queue.empty()) {
+      const std::size_t r = queue.top().second;
+      queue.pop();
+      if (r == memory) {
+        const entry &e = entries[position++];
+        emit(coordinates.data() + e.offset, e.vertices);
+      } else {
+        emit(current[r].data(), vertices[r]);
+      }
+      next(r);
+    }
+  }
+};
+}
+}
+
+#endif
@@ -0,0 +1,160 @@
+/**\file
+ * \brief Parallel mesh generation
+ *
+ * Splits the faces of a model into contiguous subranges and calculates these
+ * on separate threads, which helps with models that produce a lot of faces,
+ * e.g. iterated function systems with a high number of iterations.
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#if !defined(EF_GY_PARALLEL_H)
+#define EF_GY_PARALLEL_H
+
+#include <ef.gy/polytope.h>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace efgy {
+namespace geometry {
+/**\brief Partitioned model faces
+ *
+ * Divides the faces of a model into a number of contiguous parts of roughly
+ * the same size. Each part has its own iterator, which is independent of the
+ * iterators of all other parts, so parts may be processed concurrently.
+ *
+ * \tparam model The model type, e.g. geometry::sierpinski::carpet<Q,4>.
+ */
+template <class model> class partition {
+public:
+  using iterator = typename model::iterator;
+
+  /**\brief Construct with model and number of parts
+   *
+   * Calculates the start iterator and the number of faces of the model.
+   * Models that precalculate their meshes do so here, so the model must
+   * outlive the partition and its iterators.
+   *
+   * \param[in] pModel The model to partition.
+   * \param[in] pParts The number of parts; at least 1.
+   */
+  partition(model &pModel, std::size_t pParts)
+      : first(pModel.begin()), total(pModel.size()),
+        parts(pParts > 0 ? pParts : 1) {}
+
+  /**\brief Number of parts
+   *
+   * \returns The number of parts the faces are divided into.
+   */
+  std::size_t size(void) const { return parts; }
+
+  /**\brief Number of faces
+   *
+   * \returns The number of faces in all parts.
+   */
+  std::size_t faces(void) const { return total; }
+
+  /**\brief Index of first face in part
+   *
+   * \param[in] k The part to query; part size() is the end of the faces.
+   *
+   * \returns The index of the first face in part 'k'.
+   */
+  std::size_t offset(std::size_t k) const { return total * k / parts; }
+
+  /**\brief Number of faces in part
+   *
+   * \param[in] k The part to query.
+   *
+   * \returns The number of faces in part 'k'.
+   */
+  std::size_t count(std::size_t k) const {
+    return offset(k + 1) - offset(k);
+  }
+
+  /**\brief Start of part
+   *
+   * Safe to call from several threads at the same time.
+   *
+   * \param[in] k The part to query.
+   *
+   * \returns An iterator to the first face of part 'k'. The part ends after
+   *     count(k) faces; iterators of different parts can not be compared.
+   */
+  iterator begin(std::size_t k) const {
+    return geometry::skip(first, offset(k));
+  }
+
+protected:
+  /**\brief Start iterator
+   *
+   * An iterator to the first face of the model, which is copied and moved
+   * forward to get the start of each part.
+   */
+  const iterator first;
+
+  /**\brief Number of faces
+   *
+   * The size of the model when the partition was created.
+   */
+  const std::size_t total;
+
+  /**\brief Number of parts
+   *
+   * The number of parts the faces are divided into.
+   */
+  const std::size_t parts;
+};
+
+/**\brief Generate model faces in parallel
+ *
+ * Partitions the model's faces into one part per thread, and lets each thread
+ * write the faces of its part to the output. Faces end up in the same order as
+ * if the model had been iterated over on a single thread.
+ *
+ * \tparam model          The model type.
+ * \tparam outputIterator Random access iterator to write faces to.
+ *
+ * \param[in]  object  The model to generate faces for.
+ * \param[out] out     Start of a buffer that can hold object.size() faces.
+ * \param[in]  threads Number of threads to use; 0 uses one thread per core.
+ *
+ * \returns An iterator past the last face that was written.
+ */
+template <class model, class outputIterator>
+outputIterator generate(model &object, outputIterator out,
+                        std::size_t threads = 0) {
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+
+  const partition<model> parts(object, threads);
+  std::vector<std::thread> workers;
+
+  for (std::size_t k = 0; k < parts.size(); k++) {
+    workers.emplace_back([&parts, out, k]() {
+      auto it = parts.begin(k);
+      auto o = std::next(out, parts.offset(k));
+      for (std::size_t i = parts.count(k); i > 0; i--, ++it, ++o) {
+        *o = *it;
+      }
+    });
+  }
+
+  for (auto &w : workers) {
+    w.join();
+  }
+
+  return std::next(out, parts.faces());
+}
+}
+}
+
+#endif
@@ -18,6 +18,8 @@
 
 #include <ef.gy/polytope.h>
 #include <algorithm>
+#include <cstdint>
+#include <unordered_map>
 
 namespace efgy {
 namespace geometry {
@@ -283,6 +285,50 @@ public:
     return *this;
   }
 
+  /**\brief Skip faces
+   *
+   * Moves the iterator forward by the given number of faces without
+   * calculating the faces in between, by setting the range positions to the
+   * digits of the target cell.
+   *
+   * \param[in] faces Number of faces to skip.
+   *
+   * \returns A reference to this iterator.
+   */
+  parametricIterator &skip(std::size_t faces) {
+    std::size_t target = index() + faces;
+
+    basePosition = target % base.size();
+    target /= base.size();
+
+    for (std::size_t dim = od; dim > 0; dim--) {
+      const std::size_t steps = ends[dim - 1] - starts[dim - 1];
+      positions[dim - 1] = starts[dim - 1] + (target % steps);
+      target /= steps;
+    }
+
+    if (target > 0) {
+      basePosition = 0;
+      end();
+    }
+
+    return *this;
+  }
+
+  /**\brief Number of faces
+   *
+   * Counts the faces in a full sweep over the formula's ranges.
+   *
+   * \returns The number of faces between begin() and end().
+   */
+  std::size_t count(void) const {
+    std::size_t r = base.size();
+    for (std::size_t dim = 0; dim < od; dim++) {
+      r *= ends[dim] - starts[dim];
+    }
+    return r;
+  }
+
   const face operator*(void) const {
     auto f = base[basePosition];
     face g;
@@ -365,6 +411,20 @@ protected:
     return base;
   }
 
+  /**\brief Current face index
+   *
+   * The number of faces before the current one in a full sweep.
+   *
+   * \returns The number of faces between begin() and this iterator.
+   */
+  std::size_t index(void) const {
+    std::size_t r = 0;
+    for (std::size_t dim = 0; dim < od; dim++) {
+      r = r * (ends[dim] - starts[dim]) + (positions[dim] - starts[dim]);
+    }
+    return r * base.size() + basePosition;
+  }
+
   const vector getPosition(void) const {
     vector r;
     for (std::size_t dim = 0; dim < od; dim++) {
@@ -374,6 +434,494 @@ protected:
   }
 };
   
+/**\brief Shared-vertex grid for parametric formulae
+ *
+ * Samples a parametric formula on the grid of its ranges so that each point
+ * in parameter space is evaluated exactly once, no matter how many faces
+ * share it, and describes faces as indices into the resulting vertex buffer.
+ * Faces are in the same order as those of parametricIterator.
+ *
+ * For hypersurfaces, i.e. formulae with a render depth of one more than the
+ * model depth, this also calculates a normal for every vertex, using central
+ * differences along the grid lines.
+ *
+ * \tparam Q       Base type for calculations; should be a rational type
+ * \tparam od      Model depth, e.g. '2' for a square or '3' for a cube
+ * \tparam formula Formula for the target mesh, e.g. formula::plane
+ */
+template <typename Q, std::size_t od,
+          template <typename, std::size_t> class formula>
+class parametricGrid {
+protected:
+  using source = formula<Q, od>;
+  using corners = generators::mask::cube<od>;
+
+public:
+  static constexpr const std::size_t renderDepth = source::renderDepth;
+
+  using vertex = math::vector<Q, renderDepth, typename source::format>;
+  using face = std::array<std::size_t, 4>;
+
+  /**\brief Sample formula
+   *
+   * \param[in] parameter Parameters for the formula.
+   */
+  parametricGrid(const parameters<Q> &parameter) {
+    std::vector<range<Q>> ranges;
+    std::size_t size = 1;
+    std::size_t cells = 1;
+
+    for (std::size_t dim = 0; dim < od; dim++) {
+      ranges.push_back(source::getRange(parameter, dim));
+      cells *= ranges[dim].size();
+      samples[dim] = ranges[dim].size() + 1;
+      size *= samples[dim];
+    }
+
+    vertices.reserve(size);
+    std::array<std::size_t, od> position{};
+    for (std::size_t i = 0; i < size; i++) {
+      math::vector<Q, od> ve;
+      for (std::size_t dim = 0; dim < od; dim++) {
+        ve[dim] = ranges[dim].start + ranges[dim].stride * Q(position[dim]);
+      }
+      vertices.push_back(std::array<Q, renderDepth>(
+          source::getCoordinates(parameter, ve)));
+      next(position, samples);
+    }
+
+    faces.reserve(cells * corners::size());
+    std::array<std::size_t, od> steps;
+    for (std::size_t dim = 0; dim < od; dim++) {
+      steps[dim] = samples[dim] - 1;
+    }
+    position = std::array<std::size_t, od>{};
+    for (std::size_t c = 0; c < cells; c++) {
+      for (const auto &f : corners::faces()) {
+        face g;
+        for (std::size_t v = 0; v < 4; v++) {
+          auto p = position;
+          for (std::size_t dim = 0; dim < od; dim++) {
+            p[dim] += f[v][dim] ? 1 : 0;
+          }
+          g[v] = index(p);
+        }
+        faces.push_back(g);
+      }
+      next(position, steps);
+    }
+
+    if constexpr (renderDepth == od + 1) {
+      calculateNormals();
+    }
+  }
+
+  /**\brief Samples per dimension
+   *
+   * One more than the number of steps in each range, as the last cell in
+   * each dimension also needs the point at the end of the range.
+   */
+  std::array<std::size_t, od> samples;
+
+  /**\brief Vertex buffer
+   *
+   * The formula's value at every grid point; the grid is laid out so that
+   * the last parameter changes fastest.
+   */
+  std::vector<vertex> vertices;
+
+  /**\brief Vertex normals
+   *
+   * Unit normals for the vertices at the same positions, or an empty vector
+   * if the formula does not describe a hypersurface. Normals are zero where
+   * the surface is degenerate, e.g. at the poles of a sphere.
+   */
+  std::vector<vertex> normals;
+
+  /**\brief Faces
+   *
+   * Each face is given by the indices of its four vertices.
+   */
+  std::vector<face> faces;
+
+  /**\brief Index of grid point
+   *
+   * \param[in] position Grid coordinates of a point.
+   *
+   * \returns The index of the point in the vertex buffer.
+   */
+  std::size_t index(const std::array<std::size_t, od> &position) const {
+    std::size_t r = 0;
+    for (std::size_t dim = 0; dim < od; dim++) {
+      r = r * samples[dim] + position[dim];
+    }
+    return r;
+  }
+
+protected:
+  /**\brief Advance grid position
+   *
+   * \param[in,out] position Grid coordinates to advance, last one first.
+   * \param[in]     limit    Number of values in each dimension.
+   */
+  static void next(std::array<std::size_t, od> &position,
+                   const std::array<std::size_t, od> &limit) {
+    for (std::size_t dim = od; dim > 0; dim--) {
+      if (++position[dim - 1] < limit[dim - 1]) {
+        return;
+      }
+      position[dim - 1] = 0;
+    }
+  }
+
+  /**\brief Calculate vertex normals
+   *
+   * Approximates the tangents at each grid point with central differences,
+   * or one-sided ones at the edges of the grid, and takes their normal.
+   */
+  void calculateNormals(void) {
+    normals.resize(vertices.size());
+    std::array<std::size_t, od> position{};
+
+    for (std::size_t i = 0; i < vertices.size(); i++) {
+      std::array<math::vector<Q, renderDepth>, od> tangents;
+      for (std::size_t dim = 0; dim < od; dim++) {
+        auto a = position, b = position;
+        if (a[dim] > 0) {
+          a[dim]--;
+        }
+        if (b[dim] + 1 < samples[dim]) {
+          b[dim]++;
+        }
+        tangents[dim] = math::vector<Q, renderDepth>(vertices[index(b)]) -
+                        math::vector<Q, renderDepth>(vertices[index(a)]);
+      }
+
+      const auto n = math::normal(tangents);
+      const Q l = math::length(n);
+      if (l > Q(0)) {
+        normals[i] = std::array<Q, renderDepth>(n / l);
+      }
+
+      next(position, samples);
+    }
+  }
+};
+
+/**\brief Adaptive tessellation for parametric surfaces
+ *
+ * Starts out with the cells of the formula's ranges, at the model's
+ * precision, and keeps splitting cells into four where the surface deviates
+ * too much from the cell's corners: where the distance between the surface
+ * and the chords at the centre and edge midpoints of a cell exceeds the
+ * tolerance, or, for hypersurfaces, where the normals at the corners of a
+ * cell differ by more than the given angle. Flat areas thus keep their large
+ * cells, while curved areas get as many small cells as they need.
+ *
+ * Cells are emitted as triangles; where a neighbouring cell was split
+ * further, the vertices it added on the shared edge become part of a fan
+ * around the cell's centre, so the mesh has no cracks. Dimensions where the
+ * end of the range ends up at the same points as its start, like those of a
+ * torus, are welded shut.
+ *
+ * \tparam Q       Base type for calculations; should be a rational type
+ * \tparam od      Model depth; must be '2'
+ * \tparam formula Formula for the target mesh, e.g. formula::sphere
+ */
+template <typename Q, std::size_t od,
+          template <typename, std::size_t> class formula>
+class parametricAdaptive {
+  static_assert(od == 2, "adaptive tessellation only works for surfaces");
+
+protected:
+  using source = formula<Q, od>;
+
+public:
+  static constexpr const std::size_t renderDepth = source::renderDepth;
+
+  using vertex = math::vector<Q, renderDepth, typename source::format>;
+  using face = std::array<std::size_t, 3>;
+
+  /**\brief Tessellate formula
+   *
+   * \param[in] pParameter Parameters for the formula; the precision sets the
+   *                       size of the initial cells.
+   * \param[in] pTolerance Largest acceptable distance between the surface and
+   *                       the mesh.
+   * \param[in] pAngle     Largest acceptable angle between the normals at the
+   *                       corners of a cell, in radians.
+   * \param[in] pDepth     Maximum number of times to split an initial cell.
+   */
+  parametricAdaptive(const parameters<Q> &pParameter, const Q &pTolerance,
+                     const Q &pAngle = Q(M_PI / 8), std::size_t pDepth = 8)
+      : parameter(pParameter), tolerance(pTolerance),
+        cosine(std::cos(pAngle)), depth(pDepth) {
+    for (std::size_t dim = 0; dim < od; dim++) {
+      ranges.push_back(source::getRange(parameter, dim));
+      units[dim] = ranges[dim].size() << depth;
+      wrap[dim] = false;
+    }
+
+    for (std::size_t dim = 0; dim < od; dim++) {
+      bool closed = true;
+      const std::size_t o = 1 - dim;
+      for (std::size_t i = 0; closed && i <= units[o]; i += 1 << depth) {
+        position a, b;
+        a[dim] = 0;
+        b[dim] = units[dim];
+        a[o] = b[o] = i;
+        closed = math::lengthSquared(sample(a) - sample(b)) <=
+                 tolerance * tolerance * Q(1e-6);
+      }
+      wrap[dim] = closed;
+    }
+
+    std::vector<cell> leaves;
+    const std::size_t size = std::size_t(1) << depth;
+    for (std::size_t i = 0; i < units[0]; i += size) {
+      for (std::size_t j = 0; j < units[1]; j += size) {
+        refine(cell{{{i, j}}, size}, leaves);
+      }
+    }
+
+    for (const auto &c : leaves) {
+      for (const auto &p : corners(c)) {
+        index(p);
+      }
+    }
+
+    std::vector<std::size_t> ring;
+    for (const auto &c : leaves) {
+      const auto q = corners(c);
+      ring.clear();
+      for (std::size_t k = 0; k < 4; k++) {
+        boundary(q[k], q[(k + 1) % 4], ring);
+      }
+
+      if (ring.size() == 4) {
+        faces.push_back({{ring[0], ring[1], ring[2]}});
+        faces.push_back({{ring[0], ring[2], ring[3]}});
+      } else {
+        const std::size_t m =
+            index({{c.start[0] + c.size / 2, c.start[1] + c.size / 2}});
+        for (std::size_t k = 0; k < ring.size(); k++) {
+          faces.push_back({{m, ring[k], ring[(k + 1) % ring.size()]}});
+        }
+      }
+    }
+  }
+
+  /**\brief Vertex buffer
+   *
+   * Every vertex used by the faces, exactly once.
+   */
+  std::vector<vertex> vertices;
+
+  /**\brief Faces
+   *
+   * Each face is given by the indices of its three vertices.
+   */
+  std::vector<face> faces;
+
+protected:
+  /**\brief Grid position
+   *
+   * A point in parameter space, in units of the smallest possible cell.
+   */
+  using position = std::array<std::size_t, od>;
+
+  /**\brief Cell
+   *
+   * A square in parameter space, given by its first corner and its size.
+   */
+  class cell {
+  public:
+    position start;
+    std::size_t size;
+  };
+
+  const parameters<Q> parameter;
+  const Q tolerance;
+  const Q cosine;
+  const std::size_t depth;
+
+  std::vector<range<Q>> ranges;
+  position units;
+  std::array<bool, od> wrap;
+
+  /**\brief Evaluated points
+   *
+   * Formula values by position key, so no point is evaluated twice.
+   */
+  std::unordered_map<std::uint64_t, math::vector<Q, renderDepth>> samples;
+
+  /**\brief Vertex indices
+   *
+   * Index in the vertex buffer by position key.
+   */
+  std::unordered_map<std::uint64_t, std::size_t> indices;
+
+  /**\brief Position key
+   *
+   * \param[in] p A grid position.
+   *
+   * \returns A key that is unique to the point, with the ends of welded
+   *     dimensions mapped to their start.
+   */
+  std::uint64_t key(position p) const {
+    for (std::size_t dim = 0; dim < od; dim++) {
+      if (wrap[dim] && p[dim] == units[dim]) {
+        p[dim] = 0;
+      }
+    }
+    return std::uint64_t(p[0]) * std::uint64_t(units[1] + 1) + p[1];
+  }
+
+  /**\brief Evaluate formula
+   *
+   * \param[in] p A grid position.
+   *
+   * \returns The formula's value at that position.
+   */
+  const math::vector<Q, renderDepth> &sample(const position &p) {
+    const auto k = key(p);
+    auto it = samples.find(k);
+    if (it == samples.end()) {
+      math::vector<Q, od> ve;
+      for (std::size_t dim = 0; dim < od; dim++) {
+        ve[dim] = ranges[dim].start +
+                  ranges[dim].stride * Q(p[dim]) / Q(std::size_t(1) << depth);
+      }
+      it = samples.emplace(k, source::getCoordinates(parameter, ve)).first;
+    }
+    return it->second;
+  }
+
+  /**\brief Vertex index
+   *
+   * \param[in] p A grid position.
+   *
+   * \returns The index of the position's vertex, which is added to the
+   *     vertex buffer if it is not in there yet.
+   */
+  std::size_t index(const position &p) {
+    const auto k = key(p);
+    auto it = indices.find(k);
+    if (it == indices.end()) {
+      it = indices.emplace(k, vertices.size()).first;
+      vertices.push_back(std::array<Q, renderDepth>(sample(p)));
+    }
+    return it->second;
+  }
+
+  /**\brief Cell corners
+   *
+   * \param[in] c A cell.
+   *
+   * \returns The corners of the cell, in order around it.
+   */
+  static std::array<position, 4> corners(const cell &c) {
+    const auto &p = c.start;
+    return {{{{p[0], p[1]}},
+             {{p[0] + c.size, p[1]}},
+             {{p[0] + c.size, p[1] + c.size}},
+             {{p[0], p[1] + c.size}}}};
+  }
+
+  /**\brief Split cells
+   *
+   * \param[in]  c      The cell to split, if it needs to be.
+   * \param[out] leaves Cells that need no further splitting.
+   */
+  void refine(const cell &c, std::vector<cell> &leaves) {
+    if (c.size == 1 || !coarse(c)) {
+      leaves.push_back(c);
+      return;
+    }
+
+    const std::size_t h = c.size / 2;
+    const auto &p = c.start;
+    refine(cell{p, h}, leaves);
+    refine(cell{{{p[0] + h, p[1]}}, h}, leaves);
+    refine(cell{{{p[0] + h, p[1] + h}}, h}, leaves);
+    refine(cell{{{p[0], p[1] + h}}, h}, leaves);
+  }
+
+  /**\brief Error test
+   *
+   * \param[in] c A cell.
+   *
+   * \returns Whether the cell is too coarse to approximate the surface.
+   */
+  bool coarse(const cell &c) {
+    const auto q = corners(c);
+    const std::size_t h = c.size / 2;
+    std::array<math::vector<Q, renderDepth>, 4> v;
+    math::vector<Q, renderDepth> centre;
+    for (std::size_t k = 0; k < 4; k++) {
+      v[k] = sample(q[k]);
+      centre = centre + v[k];
+    }
+
+    const Q t = tolerance * tolerance;
+    if (math::lengthSquared(
+            sample({{c.start[0] + h, c.start[1] + h}}) - centre / Q(4)) > t) {
+      return true;
+    }
+
+    for (std::size_t k = 0; k < 4; k++) {
+      const auto &a = q[k];
+      const auto &b = q[(k + 1) % 4];
+      const auto m = sample({{(a[0] + b[0]) / 2, (a[1] + b[1]) / 2}});
+      if (math::lengthSquared(m - (v[k] + v[(k + 1) % 4]) / Q(2)) > t) {
+        return true;
+      }
+    }
+
+    if constexpr (renderDepth == od + 1) {
+      std::array<math::vector<Q, renderDepth>, 4> n;
+      for (std::size_t k = 0; k < 4; k++) {
+        const auto u = k < 2 ? v[1] - v[0] : v[2] - v[3];
+        const auto w = (k == 0 || k == 3) ? v[3] - v[0] : v[2] - v[1];
+        n[k] = math::normal(std::array<math::vector<Q, renderDepth>, od>{{u, w}});
+        const Q l = math::length(n[k]);
+        n[k] = l > Q(0) ? n[k] / l : n[k];
+      }
+
+      for (std::size_t k = 0; k < 4; k++) {
+        for (std::size_t j = k + 1; j < 4; j++) {
+          if (math::lengthSquared(n[k]) > Q(0) &&
+              math::lengthSquared(n[j]) > Q(0) && n[k] * n[j] < cosine) {
+            return true;
+          }
+        }
+      }
+    }
+
+    return false;
+  }
+
+  /**\brief Collect edge vertices
+   *
+   * Adds the vertex at the start of an edge to a list, followed by any
+   * vertices that neighbouring cells added along it.
+   *
+   * \param[in]  a   Start of the edge.
+   * \param[in]  b   End of the edge.
+   * \param[out] out Vertex indices, in order.
+   */
+  void boundary(const position &a, const position &b,
+                std::vector<std::size_t> &out) {
+    const position m{{(a[0] + b[0]) / 2, (a[1] + b[1]) / 2}};
+    if (m != a && m != b && indices.count(key(m))) {
+      boundary(a, m, out);
+      boundary(m, b, out);
+    } else {
+      out.push_back(index(a));
+    }
+  }
+};
+
 /**\brief Parametric formula wrapper
  *
  * This class is used to instantiate parametric formulae so they can
@@ -417,19 +965,32 @@ public:
   constexpr iterator begin(void) const { return iterator(parent::parameter); }
   constexpr iterator end(void) const { return begin().end(); }
 
-  std::size_t size(void) const {
-#if 0
-    std::size_t s = source::getRange(parent::parameter, 0).size();
-    for (std::size_t i = 1; i < od; i++) {
-      s *= source::getRange(parent::parameter, i).size();
-    }
-    return s;
-#else
-    // TODO: this is really bad, but the closed form currently eludes me.
-    return std::count_if(begin(), end(),
-                         [](const typename parent::face&){return true;});
-#endif
+  using grid = parametricGrid<Q, od, formula>;
+
+  /**\brief Shared-vertex mesh
+   *
+   * Samples the formula once per grid point instead of once per face vertex,
+   * which is much cheaper for expensive formulae.
+   *
+   * \returns The model as a vertex buffer with indexed faces.
+   */
+  grid mesh(void) const { return grid(parent::parameter); }
+
+  using adaptive = parametricAdaptive<Q, od, formula>;
+
+  /**\brief Adaptive mesh
+   *
+   * \param[in] tolerance Largest acceptable distance between the surface and
+   *                      the mesh.
+   *
+   * \returns The model as triangles that are only as small as they need to
+   *     be to stay within the tolerance.
+   */
+  adaptive tessellate(const Q &tolerance) const {
+    return adaptive(parent::parameter, tolerance);
   }
+
+  std::size_t size(void) const { return begin().count(); }
 };
 
 /**\brief The 2D plane
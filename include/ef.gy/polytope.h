@@ -31,7 +31,7 @@
 #include <type_traits>
 #include <iterator>
 #include <cmath>
-#include <set>
+#include <utility>
 
 namespace efgy {
 namespace geometry {
@@ -181,6 +181,23 @@ public:
   static const bool flameCoefficients = tFlameCoefficients;
 };
 
+/**\brief Combined parameter flags
+ *
+ * Flags all the parameters that either of two sets of flags uses, e.g. for a
+ * model that is built from a base primitive and a set of functions.
+ *
+ * \tparam A First set of flags.
+ * \tparam B Second set of flags.
+ */
+template <class A, class B>
+using combinedParameterFlags = parameterFlags<
+    A::radius || B::radius, A::radius2 || B::radius2,
+    A::constant || B::constant, A::precision || B::precision,
+    A::iterations || B::iterations, A::functions || B::functions,
+    A::seed || B::seed, A::preRotate || B::preRotate,
+    A::postRotate || B::postRotate,
+    A::flameCoefficients || B::flameCoefficients>;
+
 /**\brief Dimensional constraints
  *
  * This class is used to hold dimensional constraints, which are in turn
@@ -334,6 +351,44 @@ public:
   using usedParameters = parameterFlags<>;
 };
 
+/**\brief Can a mesh iterator skip faces?
+ *
+ * Mesh iterators that calculate their faces on the fly may provide a skip()
+ * method to move forward by a number of faces without calculating them.
+ *
+ * \tparam T The iterator type to test.
+ */
+template <class T, class = void> class skippable : public std::false_type {};
+
+template <class T>
+class skippable<T, std::void_t<decltype(
+                       std::declval<T &>().skip(std::size_t()))>>
+    : public std::true_type {};
+
+/**\brief Skip mesh faces
+ *
+ * Moves a mesh iterator forward by the given number of faces. Iterators with
+ * a skip() method jump straight to the target, all others are advanced with
+ * std::advance, which is constant time for the random access iterators of
+ * precalculated meshes.
+ *
+ * \tparam iterator The mesh iterator type.
+ *
+ * \param[in] it    The iterator to start at.
+ * \param[in] faces Number of faces to skip.
+ *
+ * \returns A copy of 'it' that has been moved forward by 'faces'.
+ */
+template <class iterator>
+static inline iterator skip(iterator it, std::size_t faces) {
+  if constexpr (skippable<iterator>::value) {
+    it.skip(faces);
+  } else {
+    std::advance(it, faces);
+  }
+  return it;
+}
+
 /**\brief Polytope base template
  *
  * Separate from geometry::object to allow for easier overloads in renderers.
@@ -418,7 +473,7 @@ public:
   iterator end(void) const { return iterator(object.end()); }
   std::size_t size(void) const { return object.size(); }
 
-  using usedParameters = typename parent::usedParameters;
+  using usedParameters = typename model::usedParameters;
 
 protected:
   model object;
@@ -432,65 +487,174 @@ using autoAdapt = typename std::conditional<
 
 namespace generators {
 namespace mask {
+/**\brief Hypercube face table calculation
+ *
+ * Calculates the face table for mask::cube at compile time; this needs to be
+ * a separate class, as a class can not use its own constexpr functions to
+ * initialise its static members.
+ *
+ * The faces of an n-cube are those of the (n-1)-cube, one copy of those that
+ * is moved along the new axis with its winding reversed, and one new face
+ * for every edge of the (n-1)-cube, which is the edge extruded along the new
+ * axis. The table is sorted, as with the std::set that used to hold it.
+ *
+ * \tparam depth Number of dimensions of the hypercube.
+ */
 template<std::size_t depth>
-class cube {
-private:
-using vector = std::array<bool, depth>;
-using face = std::array<vector, 4>;
-
+class cubeTable {
 public:
-  static std::set<face> faces(void) {
-    std::set<face> faces{{
-      vector({false, false}),
-      vector({false, true}),
-      vector({true, true}),
-      vector({true, false})
-    }};
+  using vector = std::array<bool, depth>;
+  using face = std::array<vector, 4>;
 
-    for (std::size_t i = 2; i < depth; i++) {
-      std::set<face> newFaces;
+  /**\brief Number of surfaces
+   *
+   * \note The general, closed formula for this is (n being the depth of the
+   *     cube): (2^(n-3))*(n-1)*n
+   */
+  static constexpr std::size_t size(void) {
+    return (std::size_t(1) << depth) * (depth - 1) * depth / 8;
+  }
 
-      for (auto fa : faces) {
-        auto x = fa;
+  /**\brief Calculate face table
+   *
+   * \returns All the faces of the hypercube, in ascending order.
+   */
+  static constexpr std::array<face, size()> faces(void) {
+    return faces(quads(), std::make_index_sequence<size()>());
+  }
 
-        for (std::size_t j = 0; j < 4; j++) {
-          const auto &la = fa[j];
-          const auto &lb = fa[((j + 1) % 4)];
+private:
+  /**\brief Vertex bit mask
+   *
+   * Vertex coordinates packed into an integer; coordinate 0 is the most
+   * significant bit, so that comparing two masks gives the same result as
+   * comparing the two equivalent vectors.
+   */
+  using mask = unsigned long;
 
-          const auto &ma = la < lb ? la : lb;
-          const auto &mb = la < lb ? lb : la;
+  /**\brief Faces as vertex masks
+   *
+   * Uses a plain array, as compilers tend to evaluate constant expressions
+   * that modify these much faster than those that modify nested std::arrays.
+   */
+  class table {
+  public:
+    mask vertex[size()][4];
+  };
 
-          face n{{ma, mb, mb, ma}};
+  static constexpr mask bit(std::size_t j) {
+    return mask(1) << (depth - 1 - j);
+  }
 
-          n[2][i] = true;
-          n[3][i] = true;
+  template <std::size_t... j>
+  static constexpr vector expand(const mask &m, std::index_sequence<j...>) {
+    return {{((m & bit(j)) != 0)...}};
+  }
 
-          // this should have the smallest element first, because
-          //  - n[2] must be >= to n[1] because we set an extra bit
-          //  - n[3] must be >= to n[0] because we set an extra bit
-          //  - n[0] is <= n[1]
-          newFaces.insert(n);
-        }
+  template <std::size_t... f>
+  static constexpr std::array<face, size()> faces(const table &t,
+                                                  std::index_sequence<f...>) {
+    constexpr const auto coordinates = std::make_index_sequence<depth>();
+    return {{face{{expand(t.vertex[f][0], coordinates),
+                   expand(t.vertex[f][1], coordinates),
+                   expand(t.vertex[f][2], coordinates),
+                   expand(t.vertex[f][3], coordinates)}}...}};
+  }
 
-        x[0][i] = true;
-        x[1][i] = true;
-        x[2][i] = true;
-        x[3][i] = true;
+  /**\brief Calculate faces as vertex masks
+   *
+   * Builds up the faces one dimension at a time, then sorts them with a radix
+   * sort that uses one counting sort pass per vertex, starting with the last
+   * one. This only needs a linear number of steps, which keeps compile times
+   * down for larger cubes.
+   */
+  static constexpr table quads(void) {
+    table r{};
+    table t{};
+    std::size_t n = 0;
 
-        // since we moved this face in the new direction, we reverse the winding
-        // direction in order to reverse the normal.
-        std::reverse(x.begin(), x.end());
+    r.vertex[0][0] = 0;
+    r.vertex[0][1] = bit(1);
+    r.vertex[0][2] = bit(0) | bit(1);
+    r.vertex[0][3] = bit(0);
+    n++;
 
-        // this makes sure that the smallest vertex (via min_element) is first.
-        //std::rotate(x.begin(), std::min_element(x.begin(), x.end()), x.end());
+    for (std::size_t i = 2; i < depth; i++) {
+      const std::size_t previous = n;
+
+      for (mask s = 0; s < (mask(1) << i); s++) {
+        mask v = 0;
+        for (std::size_t j = 0; j < i; j++) {
+          if (s & (mask(1) << j)) {
+            v |= bit(j);
+          }
+        }
 
-        newFaces.insert(x);
+        for (std::size_t j = 0; j < i; j++) {
+          if (!(v & bit(j))) {
+            r.vertex[n][0] = v;
+            r.vertex[n][1] = v | bit(j);
+            r.vertex[n][2] = v | bit(j) | bit(i);
+            r.vertex[n][3] = v | bit(i);
+            n++;
+          }
+        }
       }
 
-      faces.insert(newFaces.begin(), newFaces.end());
+      for (std::size_t k = 0; k < previous; k++) {
+        for (std::size_t c = 0; c < 4; c++) {
+          r.vertex[n][c] = r.vertex[k][3 - c] | bit(i);
+        }
+        n++;
+      }
     }
 
-    return faces;
+    for (std::size_t i = 4; i-- > 0;) {
+      std::size_t start[(std::size_t(1) << depth) + 1] = {};
+
+      for (std::size_t f = 0; f < size(); f++) {
+        for (std::size_t c = 0; c < 4; c++) {
+          t.vertex[f][c] = r.vertex[f][c];
+        }
+        start[t.vertex[f][i] + 1]++;
+      }
+      for (std::size_t v = 1; v <= (std::size_t(1) << depth); v++) {
+        start[v] += start[v - 1];
+      }
+      for (std::size_t f = 0; f < size(); f++) {
+        const std::size_t p = start[t.vertex[f][i]]++;
+        for (std::size_t c = 0; c < 4; c++) {
+          r.vertex[p][c] = t.vertex[f][c];
+        }
+      }
+    }
+
+    return r;
+  }
+};
+
+/**\brief Hypercube face mask
+ *
+ * Lists the 2D surfaces of a hypercube with 'depth' dimensions, as quads of
+ * vertices whose coordinates are either 'false' or 'true'. The table is
+ * calculated at compile time, so creating an actual hypercube mesh only needs
+ * to scale these coordinates.
+ *
+ * \tparam depth Number of dimensions of the hypercube.
+ */
+template<std::size_t depth>
+class cube {
+private:
+  using table = cubeTable<depth>;
+  using face = typename table::face;
+
+public:
+  /**\brief Face table
+   *
+   * \returns All the faces of the hypercube.
+   */
+  static constexpr const std::array<face, table::size()> &faces(void) {
+    return faceTable;
   }
 
   /**\brief Number of surfaces
@@ -503,8 +667,12 @@ public:
    *     cube): (2^(n-3))*(n-1)*n
    */
   static constexpr std::size_t size(void) {
-    return std::pow<long>(2, (long)depth - 3) * (long)(depth - 1) * (long)depth;
+    return table::size();
   }
+
+private:
+  static constexpr const std::array<face, table::size()> faceTable =
+      table::faces();
 };
 
 template<> class cube<2> {
@@ -564,7 +732,7 @@ public:
     const auto nd = parameter.radius * Q(-.5);
     auto r = res.begin();
 
-    for (auto fa : source::faces()) {
+    for (const auto &fa : source::faces()) {
       for (std::size_t j = 0; j < depth; j++) {
         (*r)[0][j] = fa[0][j] ? pd : nd;
         (*r)[1][j] = fa[1][j] ? pd : nd;
@@ -0,0 +1,133 @@
+/**\file
+ * \brief Counter-based pseudo random numbers
+ *
+ * Contains a small pseudo random number generator whose output is a pure
+ * function of a key and a counter. Generators are cheap to create and to copy,
+ * so every thread or every item of work can have its own, and the numbers any
+ * of them produce only depend on where they are in a computation, not on which
+ * thread got there first.
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#if !defined(EF_GY_PRNG_H)
+#define EF_GY_PRNG_H
+
+#include <cstdint>
+#include <limits>
+
+namespace efgy {
+/**\brief Pseudo random number generators
+ *
+ * Random number generators that complement those in the standard library.
+ */
+namespace prng {
+/**\brief SplitMix64 generator
+ *
+ * The n-th output of the generator is the SplitMix64 finaliser applied to
+ * key + n * golden ratio, so jumping ahead or deriving independent streams
+ * takes constant time. Satisfies the UniformRandomBitGenerator requirements,
+ * so it can be used with the standard library's distributions.
+ *
+ * \see http://xorshift.di.unimi.it/splitmix64.c for the reference
+ *      implementation by Sebastiano Vigna.
+ */
+class splitmix {
+public:
+  using result_type = std::uint64_t;
+
+  /**\brief Construct with key and counter
+   *
+   * \param[in] pKey     Selects the sequence of numbers; e.g. a seed.
+   * \param[in] pCounter Position in that sequence.
+   */
+  constexpr splitmix(std::uint64_t pKey = 0, std::uint64_t pCounter = 0)
+      : key(pKey), counter(pCounter) {}
+
+  static constexpr result_type min(void) { return 0; }
+  static constexpr result_type max(void) {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  /**\brief Next number
+   *
+   * \returns The number at the current position, then moves on.
+   */
+  constexpr result_type operator()(void) {
+    return mix(key + golden * ++counter);
+  }
+
+  /**\brief Skip numbers
+   *
+   * \param[in] n Number of outputs to skip.
+   */
+  constexpr void discard(unsigned long long n) { counter += n; }
+
+  /**\brief Derive stream
+   *
+   * Creates a generator whose sequence is unrelated to this one's, e.g. to
+   * give every item of a computation its own numbers.
+   *
+   * \param[in] n The stream number.
+   *
+   * \returns A generator for stream 'n' of this generator.
+   */
+  constexpr splitmix stream(std::uint64_t n) const {
+    return splitmix(mix(key ^ mix(n + golden)), 0);
+  }
+
+  /**\brief Uniform number in [0,1)
+   *
+   * Uses the top bits of the next number, which unlike the standard
+   * library's distributions produces the same result everywhere.
+   *
+   * \tparam Q Floating point type to produce.
+   *
+   * \returns The next number, scaled to [0,1).
+   */
+  template <typename Q> constexpr Q uniform(void) {
+    constexpr const int bits = std::numeric_limits<Q>::digits < 53
+                                   ? std::numeric_limits<Q>::digits
+                                   : 53;
+    return Q((*this)() >> (64 - bits)) / Q(std::uint64_t(1) << bits);
+  }
+
+  /**\brief SplitMix64 finaliser
+   *
+   * A bijective mixing function with good avalanche behaviour.
+   *
+   * \param[in] z The value to mix.
+   *
+   * \returns The mixed value.
+   */
+  static constexpr std::uint64_t mix(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+  /**\brief Key
+   *
+   * Selects the sequence of numbers.
+   */
+  std::uint64_t key;
+
+  /**\brief Counter
+   *
+   * Number of outputs produced so far.
+   */
+  std::uint64_t counter;
+
+protected:
+  static constexpr const std::uint64_t golden = 0x9e3779b97f4a7c15ull;
+};
+}
+}
+
+#endif
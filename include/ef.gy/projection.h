@@ -157,6 +157,176 @@ public:
 
   using transformation::affine<Q, d>::matrix;
 };
+
+/**\brief Flattened projection chain
+ *
+ * Renderers for higher dimensions project one dimension at a time, each
+ * level with its own projective transformation, which divides by the depth
+ * coordinate of that level. Since the next level only needs the result up to
+ * a common factor, the divisions in between can be skipped and the whole
+ * chain becomes a single (d+1)x(e+1) matrix with one division at the end.
+ *
+ * The depth at each level is still a linear function of the input, up to the
+ * depths of the levels before it, so whether a point is in front of the eye
+ * of each level can be decided before the full product is calculated, and
+ * points behind any of the eyes are rejected instead of being mirrored.
+ *
+ * \tparam Q Base type for calculations.
+ * \tparam d Number of dimensions of the input.
+ * \tparam e Number of dimensions of the output.
+ */
+template <typename Q, unsigned int d, unsigned int e> class pipeline {
+public:
+  /**\brief Combined matrix
+   *
+   * Maps input points, as row vectors with a homogeneous coordinate, to
+   * output points with a homogeneous coordinate.
+   */
+  math::matrix<Q, d + 1, e + 1> matrix;
+
+  /**\brief Depth tests
+   *
+   * For each projective level, the column that gives the level's depth, up
+   * to a positive factor, with the sign chosen so that it is positive for
+   * points in front of the eye.
+   */
+  std::array<std::array<Q, d + 1>, d - e> depth;
+
+  /**\brief Add projective level
+   *
+   * Called for each level in turn, starting with the identity.
+   *
+   * \tparam k Number of dimensions of the level's input.
+   *
+   * \param[in] H The chain so far.
+   * \param[in] M The level's combined transformation and projection.
+   * \param[in] P The level's projection, which decides what is in front of
+   *     the eye: the side that the projection is looking at.
+   *
+   * \returns The chain including this level.
+   */
+  template <unsigned int k>
+  math::matrix<Q, d + 1, k> project(const math::matrix<Q, d + 1, k + 1> &H,
+                                    const transformation::projective<Q, k> &M,
+                                    const projection<Q, k> &P) {
+    math::matrix<Q, d + 1, k + 1> Y = H * M.matrix;
+
+    Q front = P.matrix[k][k - 1];
+    for (std::size_t i = 0; i < k; i++) {
+      front += P.to[i] * P.matrix[i][k - 1];
+    }
+    for (std::size_t i = 0; i <= d; i++) {
+      if (front < Q(0)) {
+        for (std::size_t j = 0; j <= k; j++) {
+          Y[i][j] = -Y[i][j];
+        }
+      }
+      depth[d - k][i] = Y[i][k - 1];
+    }
+    return math::matrix<Q, d + 1, k>(Y);
+  }
+
+  /**\brief Project point
+   *
+   * \param[in]  v   The point to project.
+   * \param[out] out The projected point.
+   *
+   * \returns False if the point is behind the eye of any level, in which
+   *     case 'out' is left alone.
+   */
+  bool operator()(const math::vector<Q, d> &v, math::vector<Q, e> &out) const {
+    for (const auto &D : depth) {
+      Q z = D[d];
+      for (std::size_t i = 0; i < d; i++) {
+        z += v[i] * D[i];
+      }
+      if (!(z > Q(0))) {
+        return false;
+      }
+    }
+
+    std::array<Q, e + 1> r;
+    for (std::size_t j = 0; j <= e; j++) {
+      r[j] = matrix[d][j];
+    }
+    for (std::size_t i = 0; i < d; i++) {
+      for (std::size_t j = 0; j <= e; j++) {
+        r[j] += v[i] * matrix[i][j];
+      }
+    }
+    for (std::size_t j = 0; j < e; j++) {
+      out[j] = r[j] / r[e];
+    }
+    return true;
+  }
+
+  /**\brief Depth of point
+   *
+   * The depth of a point at the last projective level, i.e. in the space
+   * that is projected to the output, where larger values are further away
+   * from the eye. Only meaningful for points that are in front of the eyes.
+   *
+   * \param[in] v The point to get the depth of.
+   *
+   * \returns The depth of the point.
+   */
+  Q distance(const math::vector<Q, d> &v) const {
+    const auto level = [&v](const std::array<Q, d + 1> &D) -> Q {
+      Q z = D[d];
+      for (std::size_t i = 0; i < d; i++) {
+        z += v[i] * D[i];
+      }
+      return z;
+    };
+
+    if constexpr (d - e > 1) {
+      return level(depth[d - e - 1]) / level(depth[d - e - 2]);
+    } else {
+      return level(depth[0]);
+    }
+  }
+
+  /**\brief Project face
+   *
+   * \tparam q Number of vertices of the face.
+   *
+   * \param[in]  pV  The face to project.
+   * \param[out] out The projected face.
+   *
+   * \returns False if any of the vertices is behind the eye of any level.
+   */
+  template <std::size_t q>
+  bool operator()(const std::array<math::vector<Q, d>, q> &pV,
+                  std::array<math::vector<Q, e>, q> &out) const {
+    for (std::size_t i = 0; i < q; i++) {
+      if (!(*this)(pV[i], out[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**\brief Project faces
+   *
+   * Projects a range of faces, skipping those that are not fully in front
+   * of the eyes.
+   *
+   * \param[in]  begin Start of the faces to project.
+   * \param[in]  end   End of the faces to project.
+   * \param[out] out   Where to write the projected faces.
+   *
+   * \returns The end of the output.
+   */
+  template <typename input, typename output>
+  output operator()(input begin, input end, output out) const {
+    for (; begin != end; ++begin) {
+      if ((*this)(*begin, *out)) {
+        ++out;
+      }
+    }
+    return out;
+  }
+};
 }
 }
 
@@ -0,0 +1,654 @@
+/**\file
+ * \brief Render fractal flames on the CPU
+ *
+ * Contains a chaos game renderer for iterated function systems, which plots
+ * a random walk through the functions of an IFS into a density histogram and
+ * then tone maps that histogram as described in the fractal flame paper. This
+ * works with the fractal flame transformations as well as with plain affine
+ * IFS functions.
+ *
+ * Also contains the post processing stage of the OpenGL renderer's fractal
+ * flame colouring, for images that were accumulated on the CPU.
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ * \see The paper 'Fractal Flame Algorithm' by Scott Draves and Eric Reckase:
+ *      http://flam3.com/flame_draves.pdf
+ */
+
+#if !defined(EF_GY_RENDER_FLAME_H)
+#define EF_GY_RENDER_FLAME_H
+
+#include <ef.gy/flame.h>
+#include <ef.gy/prng.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace efgy {
+namespace render {
+/**\brief Chaos game renderer
+ *
+ * Renders the attractor of an IFS by following random walks through its
+ * functions and counting how often each pixel is hit. Every function has a
+ * colour index, and the colour of a point is the running average of the
+ * indices of the functions that were applied to it.
+ *
+ * Samples are plotted in walks of a fixed length, each with its own random
+ * number stream, and threads take turns picking up walks. Each thread
+ * accumulates into a histogram of its own, which are added up once all
+ * threads are done, so threads never need to synchronise while plotting. As
+ * histograms only hold integers, the result is exactly the same no matter
+ * how many threads are used.
+ *
+ * \tparam Q              Base data type for calculations.
+ * \tparam d              Number of dimensions of the IFS; only the first two
+ *                        coordinates are plotted.
+ * \tparam transformation The IFS function type.
+ */
+template <typename Q, std::size_t d,
+          class transformation = geometry::transformation::flame<Q, d>>
+class chaosGame {
+public:
+  /**\brief Palette colour
+   *
+   * Red, green and blue components in [0,1].
+   */
+  using colour = std::array<Q, 3>;
+
+  /**\brief Histogram bin
+   *
+   * Number of samples that hit a pixel and the sum of their colours, in
+   * 16 bit fixed point.
+   */
+  class bin {
+  public:
+    unsigned long long red = 0;
+    unsigned long long green = 0;
+    unsigned long long blue = 0;
+    unsigned long long count = 0;
+
+    /**\brief Add bin
+     *
+     * \param[in] b The bin to add to this one.
+     *
+     * \returns A reference to this bin.
+     */
+    bin &operator+=(const bin &b) {
+      red += b.red;
+      green += b.green;
+      blue += b.blue;
+      count += b.count;
+      return *this;
+    }
+  };
+
+  /**\brief Construct with size, functions and palette
+   *
+   * \param[in] pWidth     Width of the histogram, in pixels.
+   * \param[in] pHeight    Height of the histogram, in pixels.
+   * \param[in] pFunctions The IFS functions to pick from.
+   * \param[in] pPalette   Colours to look up colour indices in; function i
+   *                       of n has colour index i/(n-1).
+   */
+  chaosGame(std::size_t pWidth, std::size_t pHeight,
+            const std::vector<transformation> &pFunctions,
+            const std::vector<colour> &pPalette)
+      : width(pWidth), height(pHeight), functions(pFunctions),
+        palette(fixed(pPalette)), bins(pWidth * pHeight), walks(0) {}
+
+  /**\brief Width
+   *
+   * The width of the histogram, in pixels.
+   */
+  const std::size_t width;
+
+  /**\brief Height
+   *
+   * The height of the histogram, in pixels.
+   */
+  const std::size_t height;
+
+  /**\brief Camera transformation
+   *
+   * Applied to points before plotting them; the square from (-1,-1) to (1,1)
+   * in the first two coordinates is mapped to the histogram.
+   */
+  geometry::transformation::affine<Q, d> camera;
+
+  /**\brief Iterations to discard
+   *
+   * Number of iterations at the start of every random walk that are not
+   * plotted, as the walk still needs to converge to the attractor.
+   */
+  std::size_t fuse = 20;
+
+  /**\brief Restarts before giving up
+   *
+   * Number of times in a row that a random walk may diverge before producing
+   * a single sample. Flames whose functions send every point to infinity or
+   * NaN would otherwise never finish, so plot() stops early after that.
+   */
+  std::size_t restarts = 64;
+
+  /**\brief Samples per walk
+   *
+   * Number of samples plotted from each random walk. Walks are the unit of
+   * work that threads pick up.
+   */
+  static constexpr const unsigned long long walkLength = 1 << 16;
+
+  /**\brief Plot samples
+   *
+   * Adds samples to the histogram, which may be done repeatedly to refine an
+   * image; later calls continue with new walks. The result only depends on
+   * the seed and the number of samples of each call.
+   *
+   * \param[in] samples Number of samples to plot.
+   * \param[in] seed    Seed for the random walks.
+   * \param[in] threads Number of threads to use; 0 uses one thread per core.
+   */
+  void operator()(unsigned long long samples, unsigned long long seed = 0,
+                  std::size_t threads = 0) {
+    if (threads == 0) {
+      threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    const prng::splitmix rng(seed);
+    const unsigned long long first = walks;
+    const unsigned long long count = (samples + walkLength - 1) / walkLength;
+    walks += count;
+
+    const auto work = [this, &rng, samples, first, count,
+                       threads](std::vector<bin> &target, std::size_t k) {
+      for (unsigned long long w = k; w < count; w += threads) {
+        auto walk = rng.stream(first + w);
+        plot(target, std::min(walkLength, samples - w * walkLength), walk);
+      }
+    };
+
+    std::vector<std::vector<bin>> partial(threads - 1);
+    std::vector<std::thread> workers;
+
+    for (std::size_t k = 1; k < threads; k++) {
+      workers.emplace_back([this, &partial, &work, k]() {
+        partial[k - 1].resize(bins.size());
+        work(partial[k - 1], k);
+      });
+    }
+
+    work(bins, 0);
+
+    for (std::size_t k = 1; k < threads; k++) {
+      workers[k - 1].join();
+      for (std::size_t i = 0; i < bins.size(); i++) {
+        bins[i] += partial[k - 1][i];
+      }
+    }
+  }
+
+  /**\brief Density histogram
+   *
+   * \returns The bins of the histogram, row by row, top row first.
+   */
+  const std::vector<bin> &histogram(void) const { return bins; }
+
+  /**\brief Tone mapped image
+   *
+   * Applies log-density tone mapping to the histogram: the brightness of a
+   * pixel is the logarithm of its density relative to the logarithm of the
+   * highest density, and its hue is the average colour of its samples.
+   *
+   * \param[in] gamma Gamma correction to apply to the brightness.
+   *
+   * \returns Raw, non-premultiplied RGBA pixel data, 8 bits per channel, row
+   *     by row, top row first.
+   */
+  std::vector<std::uint8_t> rgba(Q gamma = 1) const {
+    std::vector<std::uint8_t> rv(bins.size() * 4);
+
+    unsigned long long peak = 0;
+    for (const auto &b : bins) {
+      peak = std::max(peak, b.count);
+    }
+
+    const Q scale = peak > 0 ? Q(1) / std::log(Q(1) + Q(peak)) : Q(0);
+    auto o = rv.begin();
+    for (const auto &b : bins) {
+      if (b.count > 0) {
+        const Q alpha =
+            std::pow(std::log(Q(1) + Q(b.count)) * scale, Q(1) / gamma);
+        const Q samples = Q(b.count) * Q(one);
+        *(o++) = channel(Q(b.red) / samples);
+        *(o++) = channel(Q(b.green) / samples);
+        *(o++) = channel(Q(b.blue) / samples);
+        *(o++) = channel(alpha);
+      } else {
+        o += 4;
+      }
+    }
+
+    return rv;
+  }
+
+protected:
+  /**\brief IFS functions
+   *
+   * The functions that the random walks pick from.
+   */
+  const std::vector<transformation> functions;
+
+  /**\brief Fixed point colour
+   *
+   * A palette colour in 16 bit fixed point, as it is added to bins.
+   */
+  using fixedColour = std::array<unsigned long long, 3>;
+
+  /**\brief Fixed point one
+   *
+   * The value of a fully saturated colour channel in a fixedColour.
+   */
+  static constexpr const unsigned long long one = 0xffff;
+
+  /**\brief Colour palette
+   *
+   * Colours that colour indices are looked up in.
+   */
+  const std::vector<fixedColour> palette;
+
+  /**\brief Histogram data
+   *
+   * Holds width*height bins, row by row.
+   */
+  std::vector<bin> bins;
+
+  /**\brief Number of walks
+   *
+   * Walks that were plotted in earlier calls; later calls start with new
+   * random number streams.
+   */
+  unsigned long long walks;
+
+  /**\brief Convert palette to fixed point
+   *
+   * \param[in] pPalette Colours with channels in [0,1].
+   *
+   * \returns The colours in fixed point.
+   */
+  static std::vector<fixedColour> fixed(const std::vector<colour> &pPalette) {
+    std::vector<fixedColour> rv;
+    for (const auto &c : pPalette) {
+      rv.push_back({{channel(c[0], one), channel(c[1], one),
+                     channel(c[2], one)}});
+    }
+    return rv;
+  }
+
+  /**\brief Convert colour channel
+   *
+   * \param[in] v   A channel value in [0,1].
+   * \param[in] max The integer that 1 maps to.
+   *
+   * \returns 'v' as an integer in [0,max].
+   */
+  static unsigned long long channel(Q v, unsigned long long max = 255) {
+    return (unsigned long long)(std::min(std::max(v, Q(0)), Q(1)) * Q(max) +
+                                Q(0.5));
+  }
+
+  /**\brief Follow a random walk
+   *
+   * Plots a number of samples of a single random walk into a histogram. The
+   * walk is restarted whenever a point diverges, and abandoned with fewer
+   * samples if it keeps diverging; see restarts.
+   *
+   * \param[out]    target  Histogram to add samples to.
+   * \param[in]     samples Number of samples to plot.
+   * \param[in,out] rng     Random numbers for the walk.
+   */
+  void plot(std::vector<bin> &target, unsigned long long samples,
+            prng::splitmix &rng) const {
+    if (functions.empty() || palette.empty()) {
+      return;
+    }
+
+    const Q indexScale =
+        functions.size() > 1 ? Q(1) / Q(functions.size() - 1) : Q(0);
+    const Q paletteScale = Q(palette.size() - 1);
+
+    math::vector<Q, d> p;
+    Q c = 0;
+    std::size_t skip = 0;
+    std::size_t diverged = 0;
+
+    for (unsigned long long i = 0; i < samples;) {
+      if (skip == 0) {
+        if (diverged > restarts) {
+          return;
+        }
+        for (auto &v : p) {
+          v = rng.template uniform<Q>() * Q(2) - Q(1);
+        }
+        c = rng.template uniform<Q>();
+        skip = fuse + 1;
+      }
+
+      const std::size_t f = rng() % functions.size();
+      if constexpr (std::is_invocable<const transformation &,
+                                      const math::vector<Q, d> &,
+                                      prng::splitmix &>::value) {
+        p = functions[f](p, rng);
+      } else {
+        p = functions[f] * p;
+      }
+      c = (c + Q(f) * indexScale) / Q(2);
+
+      bool finite = true;
+      for (const auto &v : p) {
+        finite = finite && std::isfinite(v);
+      }
+      if (!finite) {
+        skip = 0;
+        diverged++;
+        continue;
+      }
+
+      if (skip > 1) {
+        skip--;
+        continue;
+      }
+
+      i++;
+      diverged = 0;
+
+      const auto q = camera * p;
+      const Q x = (q[0] + Q(1)) / Q(2) * Q(width);
+      const Q y = (Q(1) - q[1]) / Q(2) * Q(height);
+      if (!(x >= Q(0) && x < Q(width) && y >= Q(0) && y < Q(height))) {
+        continue;
+      }
+
+      const fixedColour &col = palette[std::size_t(c * paletteScale + Q(.5))];
+      bin &b = target[std::size_t(y) * width + std::size_t(x)];
+      b.red += col[0];
+      b.green += col[1];
+      b.blue += col[2];
+      b.count++;
+    }
+  }
+};
+
+/**\brief Fractal flame post processing
+ *
+ * Turns fractal flame accumulation buffers into an image, like the
+ * postProcessFloat shader of the OpenGL renderer: every pixel holds the sum
+ * of the colour indices of the faces that covered it and the number of those
+ * faces. The average index is looked up in a colour map, and the colour is
+ * scaled with the logarithm of the number of faces.
+ *
+ * On top of that, gamma correction and vibrancy can be applied as described
+ * in the fractal flame paper; with the defaults, the result is the same as
+ * that of the shader.
+ *
+ * Pixels are processed in blocks of 8, with the logarithms and powers
+ * approximated with polynomials so that the compiler can vectorise the
+ * calculations, and rows are split between several threads.
+ */
+class postProcess {
+public:
+  /**\brief Colour
+   *
+   * Red, green and blue components in [0,1].
+   */
+  using colour = std::array<float, 3>;
+
+  /**\brief Construct with random colour map
+   *
+   * \param[in] pThreads Number of threads to use; 0 uses one thread per core.
+   */
+  postProcess(std::size_t pThreads = 0)
+      : gamma(1), vibrancy(1), threads(pThreads) {
+    setColourMap();
+  }
+
+  /**\brief Gamma
+   *
+   * Gamma correction to apply to the intensity of pixels.
+   */
+  float gamma;
+
+  /**\brief Vibrancy
+   *
+   * How much of the gamma correction is applied to the intensity alone,
+   * rather than to each channel; 1 keeps colours saturated, 0 makes dim
+   * pixels lighter but greyer.
+   */
+  float vibrancy;
+
+  /**\brief Number of threads
+   *
+   * Number of threads to process rows with; 0 uses one thread per core.
+   */
+  std::size_t threads;
+
+  /**\brief Colour map
+   *
+   * Average indices are looked up in here, interpolating linearly between
+   * the colours, like a texture with linear filtering.
+   */
+  std::vector<colour> colourMap;
+
+  /**\brief Set random colour map
+   *
+   * Creates a random colour map with 8 colours, like the OpenGL renderer.
+   *
+   * \param[in] seed Seed for the random colours.
+   */
+  void setColourMap(unsigned long long seed = 0) {
+    prng::splitmix rng(seed);
+    colourMap.resize(8);
+    for (auto &c : colourMap) {
+      for (auto &v : c) {
+        v = rng.uniform<float>();
+      }
+    }
+  }
+
+  /**\brief Process row
+   *
+   * Processes a run of pixels whose index sums and counts are stored at a
+   * fixed distance from each other, e.g. interleaved with other channels.
+   *
+   * \param[in]  sum    Index sum of the first pixel.
+   * \param[in]  count  Number of faces of the first pixel.
+   * \param[in]  stride Distance between pixels in both inputs, in floats.
+   * \param[in]  pixels Number of pixels to process.
+   * \param[out] rgba   Where to write the pixels, 8 bits per channel with
+   *     opaque alpha.
+   */
+  void operator()(const float *sum, const float *count, std::size_t stride,
+                  std::size_t pixels, std::uint8_t *rgba) const {
+    constexpr const std::size_t block = 8;
+    const float size = float(colourMap.size());
+    const std::size_t last = colourMap.empty() ? 0 : colourMap.size() - 1;
+    const bool corrected = gamma != 1.f;
+    const float exponent = 1.f / gamma;
+
+    for (std::size_t p = 0; p < pixels; p += block) {
+      const std::size_t n = std::min(block, pixels - p);
+      std::array<float, block> s, c, a, u, f;
+      std::array<std::size_t, block> i;
+
+      for (std::size_t k = 0; k < block; k++) {
+        const std::size_t o = (p + (k < n ? k : 0)) * stride;
+        s[k] = sum[o];
+        c[k] = count[o];
+      }
+
+      for (std::size_t k = 0; k < block; k++) {
+        a[k] = c[k] > 0.f ? 1.f - 1.f / log2(c[k] + 2.f) : 0.f;
+        u[k] = c[k] > 0.f ? std::min(std::max(s[k] / c[k], 0.f), 1.f) : 0.f;
+        u[k] = std::min(std::max(u[k] * size - .5f, 0.f), float(last));
+        i[k] = std::size_t(u[k]);
+        f[k] = u[k] - float(i[k]);
+      }
+
+      std::array<std::array<float, block>, 3> rgb;
+      for (std::size_t j = 0; j < 3; j++) {
+        for (std::size_t k = 0; k < block; k++) {
+          if (colourMap.empty()) {
+            rgb[j][k] = 0.f;
+            continue;
+          }
+          const std::size_t e = std::min(i[k] + 1, last);
+          rgb[j][k] =
+              colourMap[i[k]][j] * (1.f - f[k]) + colourMap[e][j] * f[k];
+        }
+      }
+
+      if (corrected) {
+        std::array<float, block> g;
+        for (std::size_t k = 0; k < block; k++) {
+          g[k] = a[k] > 0.f ? exp2(log2(a[k]) * exponent) : 0.f;
+        }
+        for (auto &channel : rgb) {
+          for (std::size_t k = 0; k < block; k++) {
+            const float v = channel[k] * a[k];
+            channel[k] =
+                vibrancy * channel[k] * g[k] +
+                (1.f - vibrancy) * (v > 0.f ? exp2(log2(v) * exponent) : 0.f);
+          }
+        }
+      } else {
+        for (auto &channel : rgb) {
+          for (std::size_t k = 0; k < block; k++) {
+            channel[k] *= a[k];
+          }
+        }
+      }
+
+      for (std::size_t k = 0; k < n; k++) {
+        std::uint8_t *o = rgba + (p + k) * 4;
+        for (std::size_t j = 0; j < 3; j++) {
+          o[j] = std::uint8_t(std::min(std::max(rgb[j][k], 0.f), 1.f) * 255.f +
+                              .5f);
+        }
+        o[3] = 255;
+      }
+    }
+  }
+
+  /**\brief Process image
+   *
+   * Processes an image whose index sums and counts are in separate buffers,
+   * row by row, with the rows split between threads.
+   *
+   * \param[in] sum    Index sum of each pixel, row by row.
+   * \param[in] count  Number of faces of each pixel, row by row.
+   * \param[in] width  Width of the image, in pixels.
+   * \param[in] height Height of the image, in pixels.
+   *
+   * \returns Raw RGBA pixel data, 8 bits per channel, row by row.
+   */
+  std::vector<std::uint8_t> operator()(const std::vector<float> &sum,
+                                       const std::vector<float> &count,
+                                       std::size_t width,
+                                       std::size_t height) const {
+    std::vector<std::uint8_t> rv(width * height * 4);
+    rows(height, [&](std::size_t y) {
+      (*this)(sum.data() + y * width, count.data() + y * width, 1, width,
+              rv.data() + y * width * 4);
+    });
+    return rv;
+  }
+
+  /**\brief Split rows between threads
+   *
+   * \param[in] height  Number of rows.
+   * \param[in] process Called once for every row.
+   */
+  template <typename F> void rows(std::size_t height, const F &process) const {
+    std::size_t t = threads > 0 ? threads
+                                : std::size_t(std::thread::hardware_concurrency());
+    t = std::max<std::size_t>(1, std::min(t, height));
+
+    const auto work = [&process, height, t](std::size_t k) {
+      for (std::size_t y = height * k / t; y < height * (k + 1) / t; y++) {
+        process(y);
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t k = 1; k < t; k++) {
+      workers.emplace_back(work, k);
+    }
+    work(0);
+    for (auto &w : workers) {
+      w.join();
+    }
+  }
+
+protected:
+  /**\brief Approximate binary logarithm
+   *
+   * Splits a positive, normal number into its exponent and mantissa and
+   * uses a series for the logarithm of the mantissa; accurate to about
+   * 2e-5.
+   *
+   * \param[in] x The number to take the logarithm of.
+   *
+   * \returns The binary logarithm of x.
+   */
+  static float log2(float x) {
+    std::uint32_t b;
+    std::memcpy(&b, &x, sizeof(b));
+    const float e = float(int((b >> 23) & 0xff) - 127);
+    b = (b & 0x007fffffu) | 0x3f800000u;
+    float m;
+    std::memcpy(&m, &b, sizeof(m));
+
+    const float t = (m - 1.f) / (m + 1.f);
+    const float t2 = t * t;
+    return e + t * (2.885390082f +
+                    t2 * (.9617966939f + t2 * (.5770780164f +
+                                               t2 * .4121985831f)));
+  }
+
+  /**\brief Approximate binary exponential
+   *
+   * Splits the exponent into an integer, which goes straight into the
+   * result's exponent, and a fraction, which uses a series; accurate to
+   * about 2e-5 relative to the result.
+   *
+   * \param[in] x The exponent; anything below -126 is treated as -126.
+   *
+   * \returns 2 to the power of x.
+   */
+  static float exp2(float x) {
+    x = std::min(std::max(x, -126.f), 127.f);
+    const float i = std::floor(x);
+    const float f = (x - i) * .6931471806f;
+    const float p =
+        1.f + f * (1.f + f * (.5f + f * (.1666666667f +
+                                         f * (.04166666667f +
+                                              f * (.008333333333f +
+                                                   f * .001388888889f)))));
+    const std::uint32_t b = std::uint32_t(int(i) + 127) << 23;
+    float s;
+    std::memcpy(&s, &b, sizeof(s));
+    return p * s;
+  }
+};
+}
+}
+
+#endif
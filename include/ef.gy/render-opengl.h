@@ -28,8 +28,8 @@
 #include <ef.gy/opengl.h>
 #include <ef.gy/colour-space-rgb.h>
 #include <ef.gy/polytope.h>
+#include <ef.gy/mesh.h>
 #include <ef.gy/tracer.h>
-#include <map>
 #include <functional>
 #include <algorithm>
 #include <array>
@@ -852,9 +852,7 @@ public:
    *
    * Initialise an object with sane defaults.
    */
-  opengl(void) : prepared(false), fractalFlameColouring(false) {
-    vertexLookupCache.clear();
-  }
+  opengl(void) : prepared(false), fractalFlameColouring(false) {}
 
   /**\brief Has the scene been prepared?
    *
@@ -896,37 +894,13 @@ public:
    */
   math::vector<GLfloat, 4, math::format::RGB> surfaceColour;
 
-  /**\brief Vertex buffer elements
-   *
-   * Temporary storage for the vertex elements. This is committed
-   * to the vertexbuffer after all lines and tris have been drawn
-   * to the scene.
-   */
-  std::vector<GLfloat> vertices;
-
-  /**\brief Triangle indices
-   *
-   * Temporary storage for the triangle data used to draw surfaces
-   * to the OpenGL context. This is committed to the elementbuffer
-   * once all mesh elements have been drawn.
-   */
-  std::vector<unsigned int> triindices;
-
-  /**\brief Line indices
+  /**\brief Mesh data
    *
-   * Temporary storage for the index data used to draw lines to
-   * the OpenGL context. This is committed to the linebuffer once
-   * all mesh elements have been drawn.
+   * Temporary storage for the vertices and the triangle and line indices
+   * that make up the scene. This is committed to the vertex and index
+   * buffers once all mesh elements have been drawn.
    */
-  std::vector<unsigned int> lineindices;
-
-  /**\brief Number of vertex indices
-   *
-   * The number of vertices that will be uploaded to the graphics
-   * card; used when preparing the data to be uploaded, so it's
-   * only relevant when 'prepared' is 'false'.
-   */
-  unsigned int indices;
+  geometry::meshBuilder<GLfloat> mesh;
 
   /**\brief Number of triangle indices
    *
@@ -971,43 +945,6 @@ public:
    */
   bool fractalFlameColouring;
 
-  std::map<std::vector<GLfloat>, unsigned int> vertexLookupCache;
-
-  /**\brief Add vertex to vertex buffer
-   *
-   * Appends the given vertex data to the vertex buffer. The
-   * buffer is extended as necessary.
-   *
-   * \param[in] c     coordinates of the vertex.
-   * \param[in] n     coordinates of the vertex's normal.
-   * \param[in] index IFS index of the vertex.
-   *
-   * \tparam e The depth of the vertex.
-   *
-   * \returns The index of the vertex that was just added.
-   */
-  template <unsigned int e>
-  unsigned int add(math::vector<GLfloat, e> c, math::vector<GLfloat, e> n,
-                   const GLfloat &index) {
-    std::vector<GLfloat> newVertex;
-
-    newVertex.insert(newVertex.end(), c.begin(), c.end());
-    newVertex.insert(newVertex.end(), n.begin(), n.end());
-
-    newVertex.push_back(index);
-
-    auto &insertedIndex = vertexLookupCache[newVertex];
-
-    if (indices == 0 || insertedIndex == 0) {
-      vertices.insert(vertices.end(), newVertex.begin(), newVertex.end());
-      
-      insertedIndex = indices;
-      indices++;
-    }
-
-    return insertedIndex;
-  }
-
   /**\brief Add polygon to buffers
    *
    * Draw a polygon with q vertices. The Polygon should be
@@ -1028,34 +965,13 @@ public:
     if (prepared)
       return;
 
-    triindices.push_back(add(pV[0], R, index));
-    unsigned int nstartf = triindices.back();
-    lineindices.push_back(nstartf);
-    triindices.push_back(add(pV[1], R, index));
-    lineindices.push_back(triindices.back());
-    lineindices.push_back(triindices.back());
-    triindices.push_back(add(pV[2], R, index));
-    unsigned int nendf = triindices.back();
-    lineindices.push_back(nendf);
-
-    for (unsigned int j = 3; j < q; j++) {
-      triindices.push_back(add(pV[0], R, index));
-      triindices.push_back(add(pV[(j - 1)], R, index));
-      lineindices.push_back(triindices.back());
-      triindices.push_back(add(pV[j], R, index));
-      lineindices.push_back(triindices.back());
-      nendf = triindices.back();
-    }
-
-    lineindices.push_back(nendf);
-    lineindices.push_back(nstartf);
+    mesh.add(pV, R, index);
   }
 
   /**\brief Upload vertex data
    *
    * Uploads the vertex data that has been prepared so far to the graphics card.
-   * This will also flush the vertices, triindices and lineindeces members, and
-   * reset the indices counter.
+   * This will also clear the mesh, so the next scene starts out empty.
    *
    * \tparam T Type of the vertex array model.
    *
@@ -1066,25 +982,22 @@ public:
       prepared = true;
 
       vertexArrayModel.use();
-      vertexbuffer.load(vertices.size() * sizeof(GLfloat), vertices.data());
-      elementbuffer.load(triindices.size() * sizeof(unsigned int),
-                         triindices.data());
-      linebuffer.load(lineindices.size() * sizeof(unsigned int),
-                      lineindices.data());
+      vertexbuffer.load(mesh.vertices.size() * sizeof(GLfloat),
+                        mesh.vertices.data());
+      elementbuffer.load(mesh.triangles.size() * sizeof(unsigned int),
+                         mesh.triangles.data());
+      linebuffer.load(mesh.lines.size() * sizeof(unsigned int),
+                      mesh.lines.data());
       vertexArrayModel.setup();
 
-      tindices = GLsizei(triindices.size());
-      lindices = GLsizei(lineindices.size());
+      tindices = GLsizei(mesh.triangles.size());
+      lindices = GLsizei(mesh.lines.size());
 
-      std::cerr << "vertex buffer size: " << indices << " ("
-                << vertices.size() << ","
-                << triindices.size() << "," << lineindices.size() << ")\n";
+      std::cerr << "vertex buffer size: " << mesh.size() << " ("
+                << mesh.vertices.size() << "," << mesh.triangles.size() << ","
+                << mesh.lines.size() << ")\n";
 
-      vertexLookupCache.clear();
-      vertices.clear();
-      triindices.clear();
-      lineindices.clear();
-      indices = 0;
+      mesh.clear();
 
       // log errors
       efgy::opengl::error();
@@ -1167,6 +1080,17 @@ public:
  */
 template <typename Q, unsigned int d> class opengl {
 public:
+  /**\brief Native render depth
+   *
+   * The number of dimensions that the fix point renderer at the end of the
+   * chain handles, which is 4 when the shaders do the 4D projection.
+   */
+#if defined(TRANSFORM_4D_IN_PIXEL_SHADER)
+  static constexpr const unsigned int target = 4;
+#else
+  static constexpr const unsigned int target = 3;
+#endif
+
   /**\brief Construct with matrices
    *
    * Constructs an OpenGL renderer with references to a
@@ -1200,6 +1124,7 @@ public:
   void frameStart(void) {
     combined = transformation * projection;
     lowerRenderer.frameStart();
+    compose(pipeline, geometry::transformation::affine<Q, d>().matrix);
   }
 
   /**\brief End frame
@@ -1240,14 +1165,44 @@ public:
     if (context.prepared)
       return;
 
-    std::array<math::vector<Q, d - 1>, q> V;
+    std::array<math::vector<Q, target>, q> V;
+
+    if (pipeline(pV, V)) {
+      base().draw(V, index);
+    }
+  }
 
-    std::transform(pV.begin(), pV.end(), V.begin(),
-                   [&](const math::vector<Q, d> & s)->math::vector<Q, d - 1> {
-      return combined * s;
-    });
+  /**\brief Add to projection pipeline
+   *
+   * Adds this renderer's projection and those of the lower renderers down
+   * to the one that OpenGL handles natively to a pipeline.
+   *
+   * \tparam f Number of dimensions of the pipeline's input.
+   *
+   * \param[out] p The pipeline to complete.
+   * \param[in]  H The pipeline's matrix so far.
+   */
+  template <unsigned int f>
+  void compose(geometry::pipeline<Q, f, target> &p,
+               const math::matrix<Q, f + 1, d + 1> &H) const {
+    const auto N = p.template project<d>(H, combined, projection);
+    if constexpr (d - 1 == target) {
+      p.matrix = N;
+    } else {
+      lowerRenderer.compose(p, N);
+    }
+  }
 
-    lowerRenderer.draw(V, index);
+  /**\brief Native renderer
+   *
+   * \returns The renderer that the projected polygons are passed to.
+   */
+  opengl<Q, target> &base(void) const {
+    if constexpr (d - 1 == target) {
+      return lowerRenderer;
+    } else {
+      return lowerRenderer.base();
+    }
   }
 
   /**\brief Create random colour map
@@ -1289,6 +1244,14 @@ protected:
    */
   geometry::transformation::projective<Q, d> combined;
 
+  /**\brief Projection pipeline
+   *
+   * Calculated by frameStart() from the combined matrices of this
+   * and the lower renderers, so that vertices can be projected to
+   * the native render depth in one go.
+   */
+  geometry::pipeline<Q, d, target> pipeline;
+
   /**\brief Lower renderer
    *
    * A reference to the renderer that drawing commands are passed
@@ -0,0 +1,723 @@
+/**\file
+ * \brief Software rasteriser
+ *
+ * Contains a renderer that rasterises polygons on the CPU, for machines that
+ * have neither a GPU nor a display. It follows the OpenGL renderer: objects
+ * with more than two dimensions are projected down to 2D, with the depth of
+ * the last projection used for depth testing, and polygons are coloured
+ * either with simple lighting or with the fractal flame colouring algorithm.
+ * The result can be written as a PPM or PAM image.
+ *
+ * Polygons are split into triangles and sorted into square tiles of the
+ * image as they are drawn; when the frame ends, the tiles are rasterised by
+ * several threads at the same time, each tile with the triangles in the
+ * order they were drawn in, so the result does not depend on the number of
+ * threads.
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ * \see http://netpbm.sourceforge.net/doc/ppm.html for the PPM format.
+ * \see http://netpbm.sourceforge.net/doc/pam.html for the PAM format.
+ */
+
+#if !defined(EF_GY_RENDER_RASTER_H)
+#define EF_GY_RENDER_RASTER_H
+
+#include <ef.gy/culling.h>
+#include <ef.gy/euclidian.h>
+#include <ef.gy/projection.h>
+#include <ef.gy/render-flame.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace efgy {
+namespace render {
+/**\brief Rasterise to image
+ *
+ * Projects polygons with d dimensions to 2D, one level at a time, and
+ * passes them on to the 2D rasteriser at the end of the chain.
+ *
+ * \tparam Q The base numeric type you intend to use.
+ * \tparam d The number of dimensions for vectors.
+ */
+template <typename Q, unsigned int d> class raster {
+public:
+  /**\brief Construct with matrices
+   *
+   * Constructs a rasteriser with references to a transformation
+   * matrix, a projection matrix and an additional
+   * lower-dimensional renderer that values to project are passed
+   * to.
+   *
+   * \param[in]  pTransformation An affine transformation matrix
+   *    to pre-multiply vectors with.
+   * \param[in]  pProjection A projective transformation that is
+   *    used to reduce the number of dimensions so the vector can
+   *    be passed to pLowerRenderer.
+   * \param[out] pLowerRenderer An instance of this template with
+   *    one spatial dimension less.
+   */
+  raster(const geometry::transformation::affine<Q, d> &pTransformation,
+         const geometry::projection<Q, d> &pProjection,
+         raster<Q, d - 1> &pLowerRenderer)
+      : transformation(pTransformation), projection(pProjection),
+        lowerRenderer(pLowerRenderer) {}
+
+  /**\brief Begin drawing a new frame
+   *
+   * Calculates the projection pipeline and clears the image.
+   */
+  void frameStart(void) {
+    combined = transformation * projection;
+    lowerRenderer.frameStart();
+    compose(pipeline, geometry::transformation::affine<Q, d>().matrix);
+  }
+
+  /**\brief End drawing current frame
+   *
+   * Rasterises everything that was drawn since frameStart().
+   */
+  void frameEnd(void) { lowerRenderer.frameEnd(); }
+
+  /**\brief Draw polygon
+   *
+   * Draw a polygon with q vertices. The Polygon should be
+   * convex; if it isn't then you'll get rather strange results.
+   *
+   * \tparam q The number of vertices that define the polygon.
+   *
+   * \param[in] pV    The vertices that define the polygon.
+   * \param[in] index Source of the polygon; used for fractal
+   *                  flame colouring.
+   */
+  template <std::size_t q>
+  void draw(const std::array<math::vector<Q, d>, q> &pV,
+            const Q &index = 0.5) const {
+    std::array<math::vector<Q, 2>, q> V;
+    std::array<Q, q> depth;
+
+    if (!pipeline(pV, V)) {
+      base().cull.behind++;
+      return;
+    }
+
+    for (std::size_t i = 0; i < q; i++) {
+      depth[i] = pipeline.distance(pV[i]);
+    }
+
+    base().add(V, depth, index);
+  }
+
+  /**\copydoc svg<Q,d>::compose */
+  template <unsigned int f>
+  void compose(geometry::pipeline<Q, f, 2> &p,
+               const math::matrix<Q, f + 1, d + 1> &H) const {
+    lowerRenderer.compose(p, p.template project<d>(H, combined, projection));
+  }
+
+  /**\brief 2D renderer
+   *
+   * \returns The rasteriser at the end of the chain.
+   */
+  const raster<Q, 2> &base(void) const { return lowerRenderer.base(); }
+
+protected:
+  /**\brief Affine transformation matrix
+   *
+   * This is a reference to the affine transformation matrix that
+   * any vectors are pre-multiplied with.
+   */
+  const geometry::transformation::affine<Q, d> &transformation;
+
+  /**\brief Projective transformation
+   *
+   * This is a reference to the projective transformation that is
+   * used to decrease any vector's number of dimensions by one,
+   * so that the lower renderer can do its job.
+   */
+  const geometry::projection<Q, d> &projection;
+
+  /**\brief Combined projective transformation
+   *
+   * Calculated by frameStart() to speed up rendering by merging
+   * the affine pre-transformation and the projective matrices.
+   */
+  geometry::transformation::projective<Q, d> combined;
+
+  /**\brief Projection pipeline
+   *
+   * Calculated by frameStart() from the combined matrices of this
+   * and all the lower renderers, so that vertices can be projected
+   * to 2D in one go.
+   */
+  geometry::pipeline<Q, d, 2> pipeline;
+
+  /**\brief Lower renderer
+   *
+   * A reference to the renderer that drawing commands are passed
+   * to.
+   */
+  raster<Q, d - 1> &lowerRenderer;
+};
+
+/**\brief Rasterise to image (2D fix point)
+ *
+ * Holds the image and does the actual rasterisation. Points are mapped to
+ * pixels like OpenGL maps normalised device coordinates to the viewport:
+ * the square from (-1,-1) to (1,1) covers the whole image, with the y axis
+ * pointing up.
+ *
+ * The image is stored in square tiles, each of which is contiguous in
+ * memory, so that threads rasterising different tiles never write to the
+ * same cache lines.
+ *
+ * \tparam Q The base numeric type you intend to use.
+ */
+template <typename Q> class raster<Q, 2> {
+public:
+  /**\brief Colour
+   *
+   * Red, green, blue and alpha components in [0,1].
+   */
+  using colour = std::array<float, 4>;
+
+  /**\brief Tile size
+   *
+   * The width and height of a tile, in pixels.
+   */
+  static constexpr const std::size_t tileSize = 64;
+
+  /**\brief Construct with transformation and size
+   *
+   * \param[in] pTransformation An affine transformation applied
+   *    to any vectors rendered with this class before they are
+   *    rasterised.
+   * \param[in] pWidth  Width of the image, in pixels.
+   * \param[in] pHeight Height of the image, in pixels.
+   */
+  raster(const typename geometry::transformation::affine<Q, 2> &pTransformation,
+         const typename geometry::transformation::projective<Q, 2> &,
+         const raster<Q, 1> &, std::size_t pWidth = 512,
+         std::size_t pHeight = 512)
+      : width(pWidth), height(pHeight), threads(0),
+        fractalFlameColouring(false), surfaceColour({{1, 1, 1, 1}}),
+        background({{0, 0, 0, 1}}), colourMap(flame.colourMap),
+        columns((pWidth + tileSize - 1) / tileSize),
+        rows((pHeight + tileSize - 1) / tileSize),
+        pixels(columns * rows * tileSize * tileSize),
+        depths(pixels.size()), bins(columns * rows),
+        transformation(pTransformation) {}
+
+  /**\brief Not copyable
+   *
+   * colourMap refers to this instance's own flame member, which a
+   * copy would not rebind.
+   */
+  raster(const raster &) = delete;
+
+  /**\brief Width
+   *
+   * The width of the image, in pixels.
+   */
+  const std::size_t width;
+
+  /**\brief Height
+   *
+   * The height of the image, in pixels.
+   */
+  const std::size_t height;
+
+  /**\brief Number of threads
+   *
+   * Number of threads that frameEnd() rasterises with; 0 uses one
+   * thread per core.
+   */
+  std::size_t threads;
+
+  /**\brief Use Fractal Flame Colouring?
+   *
+   * Set to true to use the fractal flame colouring algorithm
+   * instead of the 'normal' colouring with lighting.
+   */
+  bool fractalFlameColouring;
+
+  /**\brief Surface colour
+   *
+   * The colour that surfaces are drawn in, before lighting. Faces
+   * are blended onto the image with their alpha; only opaque ones
+   * hide what is drawn behind them later.
+   */
+  colour surfaceColour;
+
+  /**\brief Background colour
+   *
+   * The colour that frameStart() clears the image to; not used
+   * with fractal flame colouring, which has a black background.
+   */
+  colour background;
+
+  /**\brief Fractal flame post processing
+   *
+   * Turns the index sums and face counts of the fractal flame
+   * colouring algorithm into colours; holds the colour map. Its
+   * thread count is also used by rgba().
+   */
+  postProcess flame;
+
+  /**\brief Colour map
+   *
+   * The colour map of the fractal flame colouring algorithm; this
+   * is flame.colourMap.
+   */
+  std::vector<postProcess::colour> &colourMap;
+
+  /**\brief Set random colour map
+   *
+   * Creates a random colour map with 8 colours for the fractal
+   * flame colouring algorithm.
+   *
+   * \param[in] seed Seed for the random colours.
+   */
+  void setColourMap(unsigned long long seed = 0) {
+    flame.setColourMap(seed);
+  }
+
+  /**\brief Culling stage
+   *
+   * Decides which polygons are rasterised, in pixel coordinates,
+   * and counts them; disabled by default. The statistics are
+   * reset by frameStart().
+   */
+  mutable culling<Q> cull;
+
+  /**\brief Begin drawing a new frame
+   *
+   * Clears the image and throws away everything that was drawn
+   * but not rasterised yet.
+   */
+  void frameStart(void) {
+    std::fill(pixels.begin(), pixels.end(),
+              fractalFlameColouring ? colour{{0, 0, 0, 1}} : background);
+    std::fill(depths.begin(), depths.end(), 0.f);
+    triangles.clear();
+    for (auto &b : bins) {
+      b.clear();
+    }
+    cull.reset();
+  }
+
+  /**\brief End drawing current frame
+   *
+   * Rasterises all the triangles that were drawn since the last
+   * frameStart(), one tile at a time, on several threads. Threads
+   * take turns picking up tiles.
+   */
+  void frameEnd(void) {
+    std::size_t t =
+        threads > 0 ? threads : std::size_t(std::thread::hardware_concurrency());
+    t = std::max<std::size_t>(1, std::min(t, bins.size()));
+
+    const auto work = [this, t](std::size_t k) {
+      for (std::size_t i = k; i < bins.size(); i += t) {
+        rasterise(i);
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t k = 1; k < t; k++) {
+      workers.emplace_back(work, k);
+    }
+    work(0);
+    for (auto &w : workers) {
+      w.join();
+    }
+
+    triangles.clear();
+    for (auto &b : bins) {
+      b.clear();
+    }
+  }
+
+  /**\brief Draw polygon
+   *
+   * Draw a polygon with q vertices. The Polygon should be
+   * convex; if it isn't then you'll get rather strange results.
+   *
+   * \tparam q The number of vertices that define the polygon.
+   *
+   * \param[in] pV    The vertices that define the polygon.
+   * \param[in] index Source of the polygon; used for fractal
+   *                  flame colouring.
+   */
+  template <std::size_t q>
+  void draw(const std::array<math::vector<Q, 2>, q> &pV,
+            const Q &index = 0.5) const {
+    std::array<math::vector<Q, 2>, q> V;
+    std::array<Q, q> depth;
+    for (std::size_t i = 0; i < q; i++) {
+      V[i] = transformation * pV[i];
+      depth[i] = Q(1);
+    }
+    add(V, depth, index);
+  }
+
+  /**\brief Add transformed polygon
+   *
+   * Splits a polygon whose vertices have already been transformed
+   * into a fan of triangles, and sorts them into the tiles they
+   * overlap, unless the culling stage drops the polygon.
+   *
+   * \tparam q The number of vertices that define the polygon.
+   *
+   * \param[in] V     The transformed vertices of the polygon.
+   * \param[in] depth The depth of each vertex; must be positive.
+   * \param[in] index Source of the polygon; used for fractal
+   *                  flame colouring.
+   */
+  template <std::size_t q>
+  void add(const std::array<math::vector<Q, 2>, q> &V,
+           const std::array<Q, q> &depth, const Q &index) const {
+    if (q < 3) {
+      return;
+    }
+
+    std::array<math::vector<Q, 2>, q> P;
+    for (std::size_t i = 0; i < q; i++) {
+      P[i] = {{(V[i][0] + Q(1)) / Q(2) * Q(width),
+               (Q(1) - V[i][1]) / Q(2) * Q(height)}};
+    }
+
+    if (!cull(P)) {
+      return;
+    }
+
+    colour shade;
+    if (fractalFlameColouring) {
+      shade = {{float(index), 0, 0, 0}};
+    } else {
+      std::array<math::vector<Q, 3>, 3> E;
+      for (std::size_t i = 0; i < 3; i++) {
+        E[i] = {{V[i][0] * depth[i], V[i][1] * depth[i], depth[i]}};
+      }
+      math::vector<Q, 3> R = math::crossProduct(E[1] - E[0], E[2] - E[0]);
+      const Q l = math::length(R);
+      Q light = Q(0);
+      if (l > Q(0)) {
+        R = R / l;
+        if (R * E[0] > Q(0)) {
+          R = R * Q(-1);
+        }
+        light = std::max(Q(0), (R[1] - R[2]) / Q(std::sqrt(2.)));
+      }
+      shade = {{surfaceColour[0] * float(light),
+                surfaceColour[1] * float(light),
+                surfaceColour[2] * float(light), surfaceColour[3]}};
+    }
+
+    for (std::size_t j = 2; j < q; j++) {
+      setup({{P[0], P[j - 1], P[j]}}, {{depth[0], depth[j - 1], depth[j]}},
+            shade);
+    }
+  }
+
+  /**\brief Image data
+   *
+   * \returns Raw, non-premultiplied RGBA pixel data, 8 bits per
+   *     channel, row by row, top row first.
+   */
+  std::vector<std::uint8_t> rgba(void) const {
+    std::vector<std::uint8_t> rv(width * height * 4);
+    flame.rows(height, [this, &rv](std::size_t y) {
+      for (std::size_t x = 0; x < width; x += tileSize) {
+        const std::size_t n = std::min(tileSize, width - x);
+        const std::size_t tile = (y / tileSize) * columns + x / tileSize;
+        const colour *c =
+            &pixels[(tile * tileSize + y % tileSize) * tileSize];
+        std::uint8_t *o = &rv[(y * width + x) * 4];
+
+        if (fractalFlameColouring) {
+          flame(&(*c)[0], &(*c)[1], 4, n, o);
+          continue;
+        }
+
+        for (std::size_t i = 0; i < n * 4; i++) {
+          o[i] = std::uint8_t(std::min(std::max(c[i / 4][i % 4], 0.f), 1.f) *
+                                  255.f +
+                              0.5f);
+        }
+      }
+    });
+    return rv;
+  }
+
+  /**\brief Write PPM image
+   *
+   * Writes the image as a binary PPM file, which has no alpha
+   * channel.
+   *
+   * \tparam C Character type for the basic_ostream reference.
+   *
+   * \param[out] output Where to write the image to.
+   */
+  template <typename C> void ppm(std::basic_ostream<C> &output) const {
+    output << "P6\n" << width << " " << height << "\n255\n";
+    const auto data = rgba();
+    std::string row(width * 3, '\0');
+    for (std::size_t y = 0; y < height; y++) {
+      for (std::size_t x = 0; x < width; x++) {
+        for (std::size_t c = 0; c < 3; c++) {
+          row[x * 3 + c] = char(data[(y * width + x) * 4 + c]);
+        }
+      }
+      output.write(row.data(), row.size());
+    }
+  }
+
+  /**\brief Write PAM image
+   *
+   * Writes the image as a PAM file with an alpha channel.
+   *
+   * \tparam C Character type for the basic_ostream reference.
+   *
+   * \param[out] output Where to write the image to.
+   */
+  template <typename C> void pam(std::basic_ostream<C> &output) const {
+    output << "P7\nWIDTH " << width << "\nHEIGHT " << height
+           << "\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n";
+    const auto data = rgba();
+    output.write(reinterpret_cast<const char *>(data.data()), data.size());
+  }
+
+  /**\copydoc svg<Q,2>::compose */
+  template <unsigned int f>
+  void compose(geometry::pipeline<Q, f, 2> &p,
+               const math::matrix<Q, f + 1, 3> &H) const {
+    p.matrix = H * transformation.matrix;
+  }
+
+  /**\copydoc raster<Q,d>::base */
+  const raster &base(void) const { return *this; }
+
+protected:
+  /**\brief Triangle setup
+   *
+   * The edge functions of a triangle, which are positive inside
+   * the triangle, the plane of its inverse depth, its bounding box
+   * and its colour, or its index with fractal flame colouring.
+   */
+  class triangle {
+  public:
+    /**\brief Edge functions, as x and y factors and a constant */
+    std::array<std::array<float, 3>, 3> edge;
+    /**\brief Whether pixels right on an edge are inside */
+    std::array<bool, 3> inclusive;
+    /**\brief Inverse depth, as x and y factors and a constant */
+    std::array<float, 3> depth;
+    /**\brief Smallest x and y, and largest x and y plus one */
+    std::array<std::size_t, 4> box;
+    /**\brief Colour or index */
+    colour shade;
+  };
+
+  /**\brief Number of tile columns */
+  const std::size_t columns;
+
+  /**\brief Number of tile rows */
+  const std::size_t rows;
+
+  /**\brief Colour buffer
+   *
+   * One colour per pixel, tile by tile. With fractal flame
+   * colouring, the first two channels hold the sum of the indices
+   * and the number of faces that cover the pixel.
+   */
+  std::vector<colour> pixels;
+
+  /**\brief Depth buffer
+   *
+   * The inverse depth of each pixel, in the same order as the
+   * colours; zero is infinitely far away.
+   */
+  std::vector<float> depths;
+
+  /**\brief Triangles
+   *
+   * All triangles drawn since frameStart(), in order.
+   */
+  mutable std::vector<triangle> triangles;
+
+  /**\brief Tile bins
+   *
+   * For each tile, the indices of the triangles that overlap it,
+   * in the order they were drawn in.
+   */
+  mutable std::vector<std::vector<std::uint32_t>> bins;
+
+  /**\brief Affine transformation matrix
+   *
+   * This is a reference to the affine transformation matrix that
+   * any vectors are pre-multiplied with.
+   */
+  const geometry::transformation::affine<Q, 2> &transformation;
+
+  /**\brief Set up triangle
+   *
+   * Calculates a triangle's edge functions and depth plane and
+   * adds it to the bins of all tiles its bounding box overlaps.
+   * Triangles that do not cover any area are dropped.
+   *
+   * \param[in] P     The vertices, in pixel coordinates.
+   * \param[in] depth The depth of each vertex.
+   * \param[in] shade Colour or index of the triangle.
+   */
+  void setup(std::array<math::vector<Q, 2>, 3> P, std::array<Q, 3> depth,
+             const colour &shade) const {
+    Q area = (P[1][0] - P[0][0]) * (P[2][1] - P[0][1]) -
+             (P[1][1] - P[0][1]) * (P[2][0] - P[0][0]);
+    if (!(std::fabs(area) > Q(0))) {
+      return;
+    }
+    if (area < Q(0)) {
+      std::swap(P[1], P[2]);
+      std::swap(depth[1], depth[2]);
+      area = -area;
+    }
+
+    Q xmin = P[0][0], xmax = P[0][0], ymin = P[0][1], ymax = P[0][1];
+    for (const auto &p : P) {
+      xmin = std::min(xmin, p[0]);
+      xmax = std::max(xmax, p[0]);
+      ymin = std::min(ymin, p[1]);
+      ymax = std::max(ymax, p[1]);
+    }
+    if (!(xmax > Q(0) && ymax > Q(0) && xmin < Q(width) &&
+          ymin < Q(height))) {
+      return;
+    }
+
+    // clamp in Q first, as converting values beyond the range of size_t is
+    // undefined, and huge triangles are common close to the eye
+    triangle t;
+    t.box = {{std::size_t(std::max(xmin, Q(0))),
+              std::size_t(std::max(ymin, Q(0))),
+              std::min(std::size_t(std::min(xmax, Q(width))) + 1, width),
+              std::min(std::size_t(std::min(ymax, Q(height))) + 1, height)}};
+    t.shade = shade;
+    t.depth = {{0, 0, 0}};
+
+    for (std::size_t i = 0; i < 3; i++) {
+      const auto &a = P[(i + 1) % 3];
+      const auto &b = P[(i + 2) % 3];
+      const Q A = a[1] - b[1];
+      const Q B = b[0] - a[0];
+      const Q C = a[0] * b[1] - a[1] * b[0];
+      t.edge[i] = {{float(A), float(B), float(C)}};
+      t.inclusive[i] = A > Q(0) || (A == Q(0) && B > Q(0));
+
+      const Q z = Q(1) / (depth[i] * area);
+      t.depth[0] += float(A * z);
+      t.depth[1] += float(B * z);
+      t.depth[2] += float(C * z);
+    }
+
+    const std::uint32_t n = std::uint32_t(triangles.size());
+    triangles.push_back(t);
+    for (std::size_t y = t.box[1] / tileSize; y <= (t.box[3] - 1) / tileSize;
+         y++) {
+      for (std::size_t x = t.box[0] / tileSize;
+           x <= (t.box[2] - 1) / tileSize; x++) {
+        bins[y * columns + x].push_back(n);
+      }
+    }
+  }
+
+  /**\brief Rasterise tile
+   *
+   * Rasterises all the triangles in a tile's bin, in order. Each
+   * row of a triangle's bounding box is processed in blocks of 8
+   * pixels: the edge functions and the depth of a block are
+   * calculated for all pixels at once, in plain arrays that the
+   * compiler can turn into vector instructions, and only then are
+   * the covered pixels shaded.
+   *
+   * \param[in] tile The index of the tile to rasterise.
+   */
+  void rasterise(std::size_t tile) {
+    constexpr const std::size_t block = 8;
+    const std::size_t tx = (tile % columns) * tileSize;
+    const std::size_t ty = (tile / columns) * tileSize;
+    colour *tilePixels = pixels.data() + tile * tileSize * tileSize;
+    float *tileDepths = depths.data() + tile * tileSize * tileSize;
+
+    for (const std::uint32_t n : bins[tile]) {
+      const triangle &t = triangles[n];
+      const std::size_t x0 = std::max(t.box[0], tx);
+      const std::size_t x1 = std::min(t.box[2], tx + tileSize);
+      const std::size_t y0 = std::max(t.box[1], ty);
+      const std::size_t y1 = std::min(t.box[3], ty + tileSize);
+
+      const bool opaque = t.shade[3] >= 1.f;
+      const float alpha = t.shade[3];
+
+      for (std::size_t y = y0; y < y1; y++) {
+        const float py = float(y) + .5f;
+        for (std::size_t x = x0; x < x1; x += block) {
+          std::array<float, block> w0, w1, w2, z;
+          for (std::size_t k = 0; k < block; k++) {
+            const float px = float(x + k) + .5f;
+            w0[k] = t.edge[0][0] * px + t.edge[0][1] * py + t.edge[0][2];
+            w1[k] = t.edge[1][0] * px + t.edge[1][1] * py + t.edge[1][2];
+            w2[k] = t.edge[2][0] * px + t.edge[2][1] * py + t.edge[2][2];
+            z[k] = t.depth[0] * px + t.depth[1] * py + t.depth[2];
+          }
+
+          const std::size_t end = std::min(block, x1 - x);
+          for (std::size_t k = 0; k < end; k++) {
+            if (!((w0[k] > 0.f || (w0[k] == 0.f && t.inclusive[0])) &&
+                  (w1[k] > 0.f || (w1[k] == 0.f && t.inclusive[1])) &&
+                  (w2[k] > 0.f || (w2[k] == 0.f && t.inclusive[2])))) {
+              continue;
+            }
+
+            const std::size_t i = (y - ty) * tileSize + (x + k - tx);
+            colour &c = tilePixels[i];
+
+            if (fractalFlameColouring) {
+              c[0] += t.shade[0];
+              c[1] += 1.f;
+              continue;
+            }
+
+            if (z[k] < tileDepths[i]) {
+              continue;
+            }
+            if (opaque) {
+              tileDepths[i] = z[k];
+            }
+            for (std::size_t j = 0; j < 3; j++) {
+              c[j] = t.shade[j] * alpha + c[j] * (1.f - alpha);
+            }
+            c[3] = alpha + c[3] * (1.f - alpha);
+          }
+        }
+      }
+    }
+  }
+};
+
+template <typename Q> class raster<Q, 1> {};
+}
+}
+
+#endif
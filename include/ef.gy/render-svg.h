@@ -16,11 +16,16 @@
 #if !defined(EF_GY_RENDER_SVG_H)
 #define EF_GY_RENDER_SVG_H
 
+#include <ef.gy/culling.h>
 #include <ef.gy/euclidian.h>
+#include <ef.gy/painter.h>
 #include <ef.gy/projection.h>
 #include <ef.gy/stream-svg.h>
 #include <ef.gy/polytope.h>
-#include <sstream>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <string>
 
 namespace efgy {
 namespace render {
@@ -66,6 +71,7 @@ public:
   void frameStart(void) {
     combined = transformation * projection;
     lowerRenderer.frameStart();
+    compose(pipeline, geometry::transformation::affine<Q, d>().matrix);
   };
 
   /**\brief End drawing current frame
@@ -88,15 +94,43 @@ public:
   template <std::size_t q, typename C>
   void draw(std::basic_ostream<C> &output,
             const std::array<math::vector<Q, d>, q> &pV) const {
-    std::array<math::vector<Q, d - 1>, q> V;
-
-    for (unsigned int i = 0; i < q; i++) {
-      V[i] = combined * pV[i];
+    std::array<math::vector<Q, 2>, q> V;
+
+    if (!pipeline(pV, V)) {
+      base().cull.behind++;
+    } else if (base().sorted) {
+      Q depth = Q(0);
+      for (const auto &v : pV) {
+        depth += pipeline.distance(v);
+      }
+      base().path(output, V, depth / Q(q));
+    } else {
+      base().path(output, V);
     }
+  }
 
-    lowerRenderer.draw(output, V);
+  /**\brief Add to projection pipeline
+   *
+   * Adds this renderer's projection and those of all the lower renderers to
+   * a pipeline.
+   *
+   * \tparam f Number of dimensions of the pipeline's input.
+   *
+   * \param[out] p The pipeline to complete.
+   * \param[in]  H The pipeline's matrix so far.
+   */
+  template <unsigned int f>
+  void compose(geometry::pipeline<Q, f, 2> &p,
+               const math::matrix<Q, f + 1, d + 1> &H) const {
+    lowerRenderer.compose(p, p.template project<d>(H, combined, projection));
   }
 
+  /**\brief 2D renderer
+   *
+   * \returns The renderer at the end of the chain.
+   */
+  const svg<Q, 2> &base(void) const { return lowerRenderer.base(); }
+
 protected:
   /**\brief Affine transformation matrix
    *
@@ -120,6 +154,14 @@ protected:
    */
   geometry::transformation::projective<Q, d> combined;
 
+  /**\brief Projection pipeline
+   *
+   * Calculated by frameStart() from the combined matrices of this
+   * and all the lower renderers, so that vertices can be projected
+   * to 2D in one go.
+   */
+  geometry::pipeline<Q, d, 2> pipeline;
+
   /**\brief Lower renderer
    *
    * A reference to the renderer that drawing commands are passed
@@ -130,6 +172,209 @@ protected:
   svg<Q, d - 1> &lowerRenderer;
 };
 
+/**\brief SVG path encoder
+ *
+ * Builds the 'd' attribute of an SVG path. Every segment is written both with
+ * absolute and with relative coordinates, and whichever is shorter is used;
+ * horizontal and vertical lines use the 'H' and 'V' commands. Numbers are
+ * formatted with std::to_chars into a buffer that is kept between paths, so
+ * encoding a path does not allocate once the buffer is large enough.
+ *
+ * Coordinates can be rounded to a number of decimal places, in which case
+ * they are kept as integer multiples of the rounding unit, so relative
+ * coordinates are exact and rounding errors do not add up along a path.
+ */
+class svgPath {
+public:
+  /**\brief Construct with precision
+   *
+   * \param[in] pDecimals Number of decimal places to round coordinates to,
+   *                      or a negative number to write coordinates with
+   *                      full precision.
+   */
+  svgPath(int pDecimals = -1) { precision(pDecimals); }
+
+  /**\brief Set precision
+   *
+   * \param[in] pDecimals Number of decimal places to round coordinates to,
+   *                      or a negative number to write coordinates with
+   *                      full precision.
+   */
+  void precision(int pDecimals) {
+    decimals = std::min(pDecimals, 15);
+    scale = decimals < 0 ? 1 : std::pow(10., decimals);
+  }
+
+  /**\brief Start new path
+   *
+   * Empties the path, keeping the buffer for the next one.
+   */
+  void clear(void) {
+    data.clear();
+    open = false;
+  }
+
+  /**\brief Start subpath
+   *
+   * \param[in] x X coordinate of the new current point.
+   * \param[in] y Y coordinate of the new current point.
+   */
+  void moveTo(double x, double y) {
+    segment('M', x, y);
+    start = current;
+  }
+
+  /**\brief Line to point
+   *
+   * Lines of length zero are skipped.
+   *
+   * \param[in] x X coordinate of the end of the line.
+   * \param[in] y Y coordinate of the end of the line.
+   */
+  void lineTo(double x, double y) { segment('L', x, y); }
+
+  /**\brief Close subpath
+   *
+   * Draws a line back to the start of the current subpath.
+   */
+  void close(void) {
+    data.push_back('Z');
+    current = start;
+  }
+
+  /**\brief Path data
+   *
+   * \returns The path data so far.
+   */
+  const std::string &str(void) const { return data; }
+
+protected:
+  /**\brief A point, in rounding units if rounding. */
+  using point = std::array<double, 2>;
+
+  int decimals;
+  double scale;
+  std::string data;
+  bool open = false;
+  point current;
+  point start;
+
+  /**\brief Add segment
+   *
+   * \param[in] command Absolute command letter; 'M' or 'L'.
+   * \param[in] x       X coordinate of the end of the segment.
+   * \param[in] y       Y coordinate of the end of the segment.
+   */
+  void segment(char command, double x, double y) {
+    const point p =
+        decimals < 0 ? point{{x + 0., y + 0.}}
+                     : point{{std::round(x * scale), std::round(y * scale)}};
+
+    if (!open) {
+      open = true;
+      char a[64];
+      char *e = a;
+      *e++ = 'M';
+      e = pair(e, p[0], p[1]);
+      data.append(a, e);
+      current = p;
+      return;
+    }
+
+    const double dx = p[0] - current[0];
+    const double dy = p[1] - current[1];
+
+    if (command == 'L' && dx == 0 && dy == 0) {
+      return;
+    }
+
+    char a[64], r[64];
+    char *ea = a, *er = r;
+
+    if (command == 'L' && dy == 0) {
+      *ea++ = 'H';
+      ea = number(ea, p[0]);
+      *er++ = 'h';
+      er = number(er, dx);
+    } else if (command == 'L' && dx == 0) {
+      *ea++ = 'V';
+      ea = number(ea, p[1]);
+      *er++ = 'v';
+      er = number(er, dy);
+    } else {
+      *ea++ = command;
+      ea = pair(ea, p[0], p[1]);
+      *er++ = char(command - 'A' + 'a');
+      er = pair(er, dx, dy);
+    }
+
+    if (er - r < ea - a) {
+      data.append(r, er);
+    } else {
+      data.append(a, ea);
+    }
+    current = p;
+  }
+
+  /**\brief Format coordinate pair
+   *
+   * \param[out] o Where to write to.
+   * \param[in]  x The first coordinate.
+   * \param[in]  y The second coordinate.
+   *
+   * \returns The end of the output.
+   */
+  char *pair(char *o, double x, double y) const {
+    o = number(o, x);
+    *o++ = ',';
+    return number(o, y);
+  }
+
+  /**\brief Format number
+   *
+   * \param[out] o Where to write to; needs room for 32 characters.
+   * \param[in]  v The number, in rounding units if rounding.
+   *
+   * \returns The end of the output.
+   */
+  char *number(char *o, double v) const {
+    if (decimals < 0) {
+      return std::to_chars(o, o + 32, v).ptr;
+    }
+
+    long long n = std::llround(v);
+    if (n < 0) {
+      *o++ = '-';
+      n = -n;
+    }
+
+    char digits[24];
+    const int length = int(std::to_chars(digits, digits + 24, n).ptr - digits);
+    const int whole = length - decimals;
+
+    if (whole > 0) {
+      o = std::copy(digits, digits + whole, o);
+    } else {
+      *o++ = '0';
+    }
+
+    int end = length;
+    while (end > std::max(whole, 0) && digits[end - 1] == '0') {
+      end--;
+    }
+
+    if (end > std::max(whole, 0)) {
+      *o++ = '.';
+      for (int i = whole; i < 0; i++) {
+        *o++ = '0';
+      }
+      o = std::copy(digits + std::max(whole, 0), digits + end, o);
+    }
+
+    return o;
+  }
+};
+
 /**\brief Render to SVG (2D fix point)
  *
  * Converts objects to strings so that an SVG parser can understand and
@@ -156,14 +401,14 @@ public:
   svg(const typename geometry::transformation::affine<Q, 2> &pTransformation,
       const typename geometry::transformation::projective<Q, 2> &,
       const svg<Q, 1> &)
-      : transformation(pTransformation) {}
+      : sorted(false), transformation(pTransformation) {}
 
   /**\brief Begin drawing a new frame
    *
    * Reset the renderer's state and start drawing a new image.
-   * Not used by the 2D SVG renderer.
+   * Resets the culling statistics.
    */
-  void frameStart(void) const {};
+  void frameStart(void) const { cull.reset(); };
 
   /**\brief End drawing current frame
    *
@@ -188,45 +433,119 @@ public:
   template <std::size_t q, typename C>
   void draw(std::basic_ostream<C> &output,
             const std::array<math::vector<Q, 2>, q> &pV) const {
-    output << "<path d='";
-    for (unsigned int i = 0; i < q; i++) {
-      std::stringstream sbuf1;
-      std::stringstream sbuf2;
+    std::array<math::vector<Q, 2>, q> V;
+    for (std::size_t i = 0; i < q; i++) {
+      V[i] = transformation * pV[i];
+    }
+    this->path(output, V);
+  }
 
-      const math::vector<Q, 2> V = transformation * pV[i];
+  /**\brief Write transformed polygon
+   *
+   * Writes a polygon whose vertices have already been transformed,
+   * e.g. by a higher renderer's projection pipeline, unless the
+   * culling stage drops it. In sorted mode, the polygon is only
+   * written by the next flush().
+   *
+   * \tparam q The number of vertices that define the polygon.
+   * \tparam C Character type for the basic_ostream reference.
+   *
+   * \param[out] output Where to write the polygon to.
+   * \param[in]  V      The transformed vertices of the polygon.
+   * \param[in]  depth  The depth of the polygon, for sorted mode.
+   */
+  template <std::size_t q, typename C>
+  void path(std::basic_ostream<C> &output,
+            const std::array<math::vector<Q, 2>, q> &V,
+            const Q &depth = Q(0)) const {
+    std::array<math::vector<Q, 2>, q> P;
+    for (std::size_t i = 0; i < q; i++) {
+      P[i] = {{V[i][0], -V[i][1]}};
+    }
 
-      const double a0 = Q(V[0]);
-      const double a1 = -Q(V[1]);
+    if (!cull(P)) {
+      return;
+    }
 
-      if (i == 0) {
-        sbuf1 << "M" << a0 << "," << a1;
-        sbuf2 << "M" << a0 << "," << a1;
-      } else {
-        const math::vector<Q, 2> V1 = transformation * pV[(i - 1)];
-
-        const double a0r = a0 - Q(V1[0]);
-        const double a1r = a1 + Q(V1[1]);
-
-        if (pV[i][1] == V1[1]) {
-          sbuf1 << "H" << a0;
-          sbuf2 << "h" << a0r;
-        } else if (pV[i][0] == -V1[0]) {
-          sbuf1 << "V" << a1;
-          sbuf2 << "v" << a1r;
-        } else {
-          sbuf1 << "L" << a0 << "," << a1;
-          sbuf2 << "l" << a0r << "," << a1r;
-        }
-      }
-      if (sbuf1.str().size() >= sbuf2.str().size()) {
-        output << sbuf2.str();
-      } else {
-        output << sbuf1.str();
-      }
+    std::array<double, 2 * q> xy;
+    for (std::size_t i = 0; i < q; i++) {
+      xy[2 * i] = double(Q(P[i][0]));
+      xy[2 * i + 1] = double(Q(P[i][1]));
+    }
+
+    if (sorted) {
+      layers.add(double(depth), xy.data(), q);
+    } else {
+      write(output, xy.data(), q);
     }
-    output << "Z'/>";
   }
 
+  /**\brief Write sorted polygons
+   *
+   * Writes all polygons collected in sorted mode, from the back to
+   * the front. Does nothing if there are none.
+   *
+   * \tparam C Character type for the basic_ostream reference.
+   *
+   * \param[out] output Where to write the polygons to.
+   */
+  template <typename C> void flush(std::basic_ostream<C> &output) const {
+    if (layers.size() > 0) {
+      layers.flush([this, &output](const double *xy, std::size_t n) {
+        write(output, xy, n);
+      });
+    }
+  }
+
+  /**\brief Complete projection pipeline
+   *
+   * Adds this renderer's transformation as the last stage of a
+   * higher renderer's projection pipeline.
+   *
+   * \tparam f Number of dimensions of the pipeline's input.
+   *
+   * \param[out] p The pipeline to complete.
+   * \param[in]  H The pipeline's matrix so far.
+   */
+  template <unsigned int f>
+  void compose(geometry::pipeline<Q, f, 2> &p,
+               const math::matrix<Q, f + 1, 3> &H) const {
+    p.matrix = H * transformation.matrix;
+  }
+
+  /**\copydoc svg<Q,d>::base */
+  const svg &base(void) const { return *this; }
+
+  /**\brief Path encoder
+   *
+   * Used to write polygons; set its precision to round coordinates.
+   */
+  mutable svgPath encoder;
+
+  /**\brief Culling stage
+   *
+   * Decides which polygons are written, in SVG coordinates, and
+   * counts them; disabled by default. The statistics are reset by
+   * frameStart().
+   */
+  mutable culling<Q> cull;
+
+  /**\brief Sort by depth?
+   *
+   * In sorted mode, polygons are collected instead of being written
+   * right away, and flush() writes them from the back to the front,
+   * which is what translucent faces need to look right. Writing a
+   * model to an osvgstream flushes automatically.
+   */
+  bool sorted;
+
+  /**\brief Depth sort buffer
+   *
+   * Holds the polygons of sorted mode until the next flush(); set
+   * its chunk size to limit how much memory that takes.
+   */
+  mutable painter layers;
+
 protected:
   /**\brief Affine transformation matrix
    *
@@ -234,6 +553,29 @@ protected:
    * any vectors are pre-multiplied with.
    */
   const geometry::transformation::affine<Q, 2> &transformation;
+
+  /**\brief Write polygon
+   *
+   * \tparam C Character type for the basic_ostream reference.
+   *
+   * \param[out] output Where to write the polygon to.
+   * \param[in]  xy     The polygon's coordinates in SVG space.
+   * \param[in]  n      The number of vertices of the polygon.
+   */
+  template <typename C>
+  void write(std::basic_ostream<C> &output, const double *xy,
+             std::size_t n) const {
+    encoder.clear();
+    for (std::size_t i = 0; i < n; i++) {
+      if (i == 0) {
+        encoder.moveTo(xy[0], xy[1]);
+      } else {
+        encoder.lineTo(xy[2 * i], xy[2 * i + 1]);
+      }
+    }
+    encoder.close();
+    output << "<path d='" << encoder.str() << "'/>";
+  }
 };
 
 template <typename Q> class svg<Q, 1> {};
@@ -296,7 +638,9 @@ constexpr inline osvgstream<C, Q, d> operator<<(std::basic_ostream<C> &stream,
 /**\brief Write out polytope as SVG
  *
  * Iterates through all of the polytope's faces and then writes a 2D
- * projection of them to the stream.
+ * projection of them to the stream. If the renderer is in sorted mode,
+ * the faces are written from the back to the front once all of them
+ * have been projected.
  *
  * \tparam C      Character type for the basic_ostream reference.
  * \tparam Q      Base type for calculations; should be a rational type
@@ -324,6 +668,8 @@ operator<<(osvgstream<C, Q, d> stream, model &poly) {
     stream.render.draw(stream.stream, q);
   }
 
+  stream.render.base().flush(stream.stream);
+
   return stream;
 }
 }
@@ -17,6 +17,8 @@
 
 #include <ef.gy/euclidian.h>
 #include <ef.gy/matrix.h>
+#include <algorithm>
+#include <type_traits>
 
 namespace efgy {
 namespace geometry {
@@ -29,6 +31,100 @@ namespace geometry {
  * vectors that we'd want to work with.
  */
 namespace transformation {
+/**\brief Transformation kinds
+ *
+ * Tags that classify transformations by the shape of their matrices. Every
+ * transformation class exports one of these as its 'classification' type, so
+ * that compositions and applications can pick a cheaper algorithm than a full
+ * matrix product whenever the matrix is known to be sparse.
+ */
+namespace kind {
+/**\brief Pure translation
+ *
+ * Identity matrix, except for the translation vector in the last row.
+ */
+class translation {};
+
+/**\brief Uniform scale
+ *
+ * Diagonal matrix with the same factor in all but the homogeneous cell.
+ */
+class scale {};
+
+/**\brief Plane rotation
+ *
+ * Identity matrix, except for the four cells that rotate two axes.
+ */
+class rotation {};
+
+/**\brief General linear map
+ *
+ * Any map that fixes the origin; scales and rotations are special cases.
+ */
+class linear {};
+
+/**\brief General affine map
+ *
+ * Any map that keeps the homogeneous column at (0,...,0,1).
+ */
+class affine {};
+
+/**\brief Projective map
+ *
+ * No structural assumptions whatsoever.
+ */
+class projective {};
+
+/**\brief Is the kind a linear map?
+ *
+ * Scales and plane rotations are linear maps, so composing them with each
+ * other or with a general linear map results in a linear map.
+ *
+ * \tparam K The kind to test.
+ */
+template <class K>
+using isLinear = std::integral_constant<
+    bool, std::is_same<K, linear>::value || std::is_same<K, scale>::value ||
+              std::is_same<K, rotation>::value>;
+
+/**\brief Kind of a composition
+ *
+ * Calculates the kind of the transformation that results from composing a
+ * transformation of kind A with one of kind B, at compile time.
+ *
+ * \tparam A Kind of the left-hand side of the composition.
+ * \tparam B Kind of the right-hand side of the composition.
+ */
+template <class A, class B> class compose {
+public:
+  using type = typename std::conditional<
+      std::is_same<A, projective>::value || std::is_same<B, projective>::value,
+      projective,
+      typename std::conditional<
+          std::is_same<A, B>::value && (std::is_same<A, translation>::value ||
+                                        std::is_same<A, scale>::value),
+          A, typename std::conditional<isLinear<A>::value && isLinear<B>::value,
+                                       linear, affine>::type>::type>::type;
+};
+
+/**\brief Is T an elementary transformation?
+ *
+ * Elementary transformations are those with a kind of translation, scale or
+ * rotation; these have dedicated composition and application algorithms.
+ *
+ * \tparam T The transformation type to test.
+ */
+template <class T, class = void> class elementary : public std::false_type {};
+
+template <class T>
+class elementary<T, std::void_t<typename T::classification>>
+    : public std::integral_constant<
+          bool,
+          std::is_same<typename T::classification, translation>::value ||
+              std::is_same<typename T::classification, scale>::value ||
+              std::is_same<typename T::classification, rotation>::value> {};
+}
+
 namespace generator {
 template<typename Q, std::size_t, std::size_t>
 class identity {
@@ -37,6 +133,21 @@ public:
     return (i == j) ? Q(1) : Q(0);
   }
 };
+}
+}
+}
+
+namespace math {
+namespace ghost {
+template <>
+class isIdentity<geometry::transformation::generator::identity>
+    : public std::true_type {};
+}
+}
+
+namespace geometry {
+namespace transformation {
+namespace generator {
 
 template<typename Q, std::size_t d, std::size_t>
 class scale {
@@ -112,6 +223,12 @@ public:
  */
 template <typename Q, std::size_t d> class linear {
 public:
+  /**\brief Transformation kind
+   *
+   * Linear maps are not assumed to have any particular structure.
+   */
+  using classification = kind::linear;
+
   /**\brief Constructor for the identity map
    *
    * Constructs a transformation whose matrix is the identity matrix.
@@ -176,6 +293,13 @@ public:
  */
 template <typename Q, std::size_t d> class affine {
 public:
+  /**\brief Transformation kind
+   *
+   * General affine transformation; derived classes with a sparser matrix
+   * override this.
+   */
+  using classification = kind::affine;
+
   /* \brief Constructor for the identity transformation
    *
    * Constructor for the identity transformation
@@ -256,6 +380,17 @@ public:
     return rv;
   }
 
+  /**\brief Inverse transformation
+   *
+   * Calculates the transformation that undoes this one, e.g. to map screen
+   * coordinates back to model coordinates, with an LU decomposition of the
+   * transformation matrix. Use transformation::invertible to reuse the inverse
+   * of a transformation that rarely changes.
+   *
+   * \returns The inverse of this transformation.
+   */
+  affine inverse(void) const { return affine(math::lu(matrix).inverse()); }
+
   math::matrix<Q, d + 1, d + 1> matrix;
 };
 
@@ -263,6 +398,12 @@ template <typename Q, std::size_t d> class projective : public affine<Q, d> {
 public:
   using affine<Q, d>::affine;
 
+  /**\brief Transformation kind
+   *
+   * Projective transformations may use the homogeneous column.
+   */
+  using classification = kind::projective;
+
   template <typename format>
   math::vector<Q, d - 1, format> operator*(
       const math::vector<Q, d, format> &pP) const {
@@ -291,9 +432,59 @@ public:
     return result;
   }
 
+  /**\brief Inverse transformation
+   *
+   * \copydetails affine::inverse
+   */
+  projective inverse(void) const {
+    return projective(math::lu(matrix).inverse());
+  }
+
   using affine<Q, d>::matrix;
 };
 
+/**\brief Transformation with cached inverse
+ *
+ * Keeps the inverse of a transformation next to a copy of the matrix it was
+ * calculated from. The transformation matrix is public and may be written to
+ * directly, so inverse() compares the matrices and only recalculates the
+ * inverse when they differ, which costs O(d^2) instead of O(d^3) for a
+ * transformation that rarely changes, such as a camera when picking.
+ *
+ * The cache is an ordinary member, so copies are independent and nothing is
+ * shared between threads; as with any other object, a single instance must
+ * not be used from several threads at once.
+ *
+ * \tparam T The transformation type, e.g. transformation::projective.
+ */
+template <class T> class invertible : public T {
+public:
+  using T::T;
+
+  invertible(void) = default;
+  invertible(const T &pTransformation) : T(pTransformation) {}
+
+  /**\brief Cached inverse transformation
+   *
+   * \returns The inverse of the current transformation matrix.
+   */
+  const T &inverse(void) {
+    if (!cached || !std::equal(T::matrix.begin(), T::matrix.end(),
+                               source.begin())) {
+      source = T::matrix;
+      inverted = T::inverse();
+      cached = true;
+    }
+
+    return inverted;
+  }
+
+protected:
+  bool cached = false;
+  decltype(T::matrix) source;
+  T inverted;
+};
+
 /*\brief Composes two linear maps.
  *
  * Composes two linear maps on Q^d by multiplying their transformation matrices.
@@ -382,42 +573,482 @@ public:
   identity() : linear<Q, d>() {}
 };
 
+/**\brief Uniform scale
+ *
+ * Scales all coordinates by the same factor. Applying this to a vector or
+ * composing it with another transformation only touches the cells that the
+ * scale actually modifies.
+ *
+ * \tparam Q The underlying field of the vector space.
+ * \tparam d The dimension of the vector space.
+ */
 template <typename Q, std::size_t d> class scale : public affine<Q, d> {
 public:
+  using classification = kind::scale;
+  using affine<Q, d>::operator*;
+
   scale(const Q &pScale) {
+    math::ghost::matrix<Q, d + 1, d + 1, generator::scale> ghost;
     ghost.generator.targetScale = pScale;
     affine<Q, d>::matrix = ghost;
   }
 
-protected:
-  math::ghost::matrix<Q,d+1,d+1,generator::scale> ghost;
+  /**\brief Scale factor
+   *
+   * Read from the transformation matrix, so it reflects changes to the
+   * matrix.
+   *
+   * \returns The factor that this transformation scales vectors by.
+   */
+  const Q &factor(void) const { return affine<Q, d>::matrix[0][0]; }
+
+  /**\brief Apply scale to vector
+   *
+   * \tparam format The vector format to use.
+   *
+   * \param[in] pV The vector to scale.
+   *
+   * \returns The scaled vector; costs O(d).
+   */
+  template <typename format>
+  math::vector<Q, d, format> operator*(
+      const math::vector<Q, d, format> &pV) const {
+    math::vector<Q, d, format> rv = pV;
+    for (std::size_t i = 0; i < d; i++) {
+      rv[i] *= factor();
+    }
+    return rv;
+  }
+
+  /**\brief Multiply from the left
+   *
+   * Replaces pM with this transformation's matrix times pM, which scales all
+   * but the homogeneous row.
+   *
+   * \param[out] pM The matrix to modify.
+   */
+  void premultiply(math::matrix<Q, d + 1, d + 1> &pM) const {
+    for (std::size_t i = 0; i < d; i++) {
+      for (std::size_t j = 0; j <= d; j++) {
+        pM[i][j] *= factor();
+      }
+    }
+  }
+
+  /**\brief Multiply from the right
+   *
+   * Replaces pM with pM times this transformation's matrix, which scales all
+   * but the homogeneous column.
+   *
+   * \param[out] pM The matrix to modify.
+   */
+  void postmultiply(math::matrix<Q, d + 1, d + 1> &pM) const {
+    for (std::size_t i = 0; i <= d; i++) {
+      for (std::size_t j = 0; j < d; j++) {
+        pM[i][j] *= factor();
+      }
+    }
+  }
 };
 
+/**\brief Plane rotation
+ *
+ * Rotates vectors in the plane spanned by two coordinate axes. Only four
+ * matrix cells differ from the identity, so applying a rotation costs O(1)
+ * arithmetic operations per vector and composing it with an arbitrary affine
+ * transformation costs O(d). Those four cells are read from the matrix, so
+ * changes to them are reflected by the specialised algorithms.
+ *
+ * \tparam Q The underlying field of the vector space.
+ * \tparam d The dimension of the vector space.
+ */
 template <typename Q, std::size_t d> class rotation : public affine<Q, d> {
 public:
+  using classification = kind::rotation;
+  using affine<Q, d>::operator*;
+
   rotation(const Q &pAngle, const std::size_t &pAxis1,
-           const std::size_t &pAxis2) {
+           const std::size_t &pAxis2)
+      : axes{{pAxis1, pAxis2}} {
+    math::ghost::matrix<Q, d + 1, d + 1, generator::rotate> ghost;
     ghost.generator.angle = pAngle;
     ghost.generator.axis1 = pAxis1;
     ghost.generator.axis2 = pAxis2;
     affine<Q, d>::matrix = ghost;
   }
 
+  const std::size_t &axis1(void) const { return axes[0]; }
+  const std::size_t &axis2(void) const { return axes[1]; }
+
+  /**\brief Apply rotation to vector
+   *
+   * Only the two coordinates in the plane of rotation change.
+   *
+   * \tparam format The vector format to use.
+   *
+   * \param[in] pV The vector to rotate.
+   *
+   * \returns The rotated vector.
+   */
+  template <typename format>
+  math::vector<Q, d, format> operator*(
+      const math::vector<Q, d, format> &pV) const {
+    const auto c = cells();
+    math::vector<Q, d, format> rv = pV;
+    rv[axis1()] = pV[axis1()] * c[0] + pV[axis2()] * c[2];
+    rv[axis2()] = pV[axis1()] * c[1] + pV[axis2()] * c[3];
+    return rv;
+  }
+
+  /**\brief Multiply from the left
+   *
+   * Replaces pM with this transformation's matrix times pM; only the two rows
+   * of the rotation axes change.
+   *
+   * \param[out] pM The matrix to modify.
+   */
+  void premultiply(math::matrix<Q, d + 1, d + 1> &pM) const {
+    const auto c = cells();
+    for (std::size_t j = 0; j <= d; j++) {
+      const Q a = pM[axis1()][j];
+      const Q b = pM[axis2()][j];
+      pM[axis1()][j] = c[0] * a + c[1] * b;
+      pM[axis2()][j] = c[2] * a + c[3] * b;
+    }
+  }
+
+  /**\brief Multiply from the right
+   *
+   * Replaces pM with pM times this transformation's matrix; only the two
+   * columns of the rotation axes change.
+   *
+   * \param[out] pM The matrix to modify.
+   */
+  void postmultiply(math::matrix<Q, d + 1, d + 1> &pM) const {
+    const auto c = cells();
+    for (std::size_t i = 0; i <= d; i++) {
+      const Q a = pM[i][axis1()];
+      const Q b = pM[i][axis2()];
+      pM[i][axis1()] = a * c[0] + b * c[2];
+      pM[i][axis2()] = a * c[1] + b * c[3];
+    }
+  }
+
 protected:
-  math::ghost::matrix<Q,d+1,d+1,generator::rotate> ghost;
+  /**\brief Rotation axes
+   *
+   * The two coordinate axes that span the plane of rotation.
+   */
+  std::array<std::size_t, 2> axes;
+
+  /**\brief Non-trivial matrix cells
+   *
+   * \returns The cells at (axis1,axis1), (axis1,axis2), (axis2,axis1) and
+   *     (axis2,axis2); these are the only ones that differ from the identity.
+   */
+  std::array<Q, 4> cells(void) const {
+    const auto &m = affine<Q, d>::matrix;
+    return {{m[axes[0]][axes[0]], m[axes[0]][axes[1]], m[axes[1]][axes[0]],
+             m[axes[1]][axes[1]]}};
+  }
 };
 
+/**\brief Translation
+ *
+ * Moves vectors by a fixed offset. Applying a translation costs O(d), and
+ * composing one with an arbitrary affine transformation costs O(d^2).
+ *
+ * \tparam Q The underlying field of the vector space.
+ * \tparam d The dimension of the vector space.
+ */
 template <typename Q, std::size_t d> class translation : public affine<Q, d> {
 public:
-  translation(const math::vector<Q, d> &pFrom) : from(ghost.generator.from) {
-    from = pFrom;
+  using classification = kind::translation;
+  using affine<Q, d>::operator*;
+
+  translation(const math::vector<Q, d> &pFrom) {
+    math::ghost::matrix<Q, d + 1, d + 1, generator::translate> ghost;
+    ghost.generator.from = pFrom;
     affine<Q, d>::matrix = ghost;
   }
 
-protected:
-  math::ghost::matrix<Q,d+1,d+1,generator::translate> ghost;
-  math::vector<Q, d> &from;
+  /**\brief Translation vector
+   *
+   * Read from the homogeneous row of the transformation matrix, so it
+   * reflects changes to the matrix.
+   *
+   * \returns The offset that this transformation adds to vectors.
+   */
+  math::vector<Q, d> offset(void) const {
+    math::vector<Q, d> rv;
+    for (std::size_t i = 0; i < d; i++) {
+      rv[i] = affine<Q, d>::matrix[d][i];
+    }
+    return rv;
+  }
+
+  /**\brief Apply translation to vector
+   *
+   * \tparam format The vector format to use.
+   *
+   * \param[in] pV The vector to translate.
+   *
+   * \returns The translated vector.
+   */
+  template <typename format>
+  math::vector<Q, d, format> operator*(
+      const math::vector<Q, d, format> &pV) const {
+    math::vector<Q, d, format> rv = pV;
+    for (std::size_t i = 0; i < d; i++) {
+      rv[i] += affine<Q, d>::matrix[d][i];
+    }
+    return rv;
+  }
+
+  /**\brief Multiply from the left
+   *
+   * Replaces pM with this transformation's matrix times pM; only the
+   * homogeneous row changes.
+   *
+   * \param[out] pM The matrix to modify.
+   */
+  void premultiply(math::matrix<Q, d + 1, d + 1> &pM) const {
+    const math::vector<Q, d> o = offset();
+    for (std::size_t j = 0; j <= d; j++) {
+      for (std::size_t k = 0; k < d; k++) {
+        pM[d][j] += o[k] * pM[k][j];
+      }
+    }
+  }
+
+  /**\brief Multiply from the right
+   *
+   * Replaces pM with pM times this transformation's matrix; each row picks up
+   * its homogeneous cell times the offset.
+   *
+   * \param[out] pM The matrix to modify.
+   */
+  void postmultiply(math::matrix<Q, d + 1, d + 1> &pM) const {
+    const math::vector<Q, d> o = offset();
+    for (std::size_t i = 0; i <= d; i++) {
+      for (std::size_t j = 0; j < d; j++) {
+        pM[i][j] += pM[i][d] * o[j];
+      }
+    }
+  }
+};
+
+/**\brief Affine transformation of a known kind
+ *
+ * Result of compositions that are known at compile time to be narrower than
+ * a general affine transformation, e.g. a linear map for two rotations. The
+ * matrix is a regular (d+1)x(d+1) matrix; only the classification differs.
+ *
+ * \tparam Q The underlying field of the vector space.
+ * \tparam d The dimension of the vector space.
+ * \tparam K The kind of the transformation, e.g. kind::linear.
+ */
+template <typename Q, std::size_t d, class K>
+class classified : public affine<Q, d> {
+public:
+  using classification = K;
+  using affine<Q, d>::affine;
+};
+
+namespace kind {
+/**\brief Transformation type for a kind
+ *
+ * Maps the kind of a composition back to a transformation type: general
+ * affine and projective kinds map to affine and projective, all others to a
+ * classified affine transformation of that kind.
+ *
+ * \tparam K The kind of the transformation.
+ * \tparam Q The underlying field of the vector space.
+ * \tparam d The dimension of the vector space.
+ */
+template <class K, typename Q, std::size_t d> class result {
+public:
+  using type = classified<Q, d, K>;
 };
+
+template <typename Q, std::size_t d> class result<affine, Q, d> {
+public:
+  using type = transformation::affine<Q, d>;
+};
+
+template <typename Q, std::size_t d> class result<projective, Q, d> {
+public:
+  using type = transformation::projective<Q, d>;
+};
+
+/**\brief Transformation type of a composition
+ *
+ * \tparam A Left-hand side transformation type.
+ * \tparam B Right-hand side transformation type.
+ * \tparam Q The underlying field of the vector space.
+ * \tparam d The dimension of the vector space.
+ */
+template <class A, class B, typename Q, std::size_t d>
+using composite = typename result<
+    typename compose<typename A::classification,
+                     typename B::classification>::type,
+    Q, d>::type;
+}
+
+/**\brief Composes two translations.
+ *
+ * Translations are closed under composition, so the result is another
+ * translation, by the sum of both offsets.
+ *
+ * \param a The object providing the left-hand side of the composition.
+ * \param b The object providing the right-hand side of the composition.
+ *
+ * \returns A translation that is the composite of the two transformations.
+ */
+template <typename Q, std::size_t d>
+translation<Q, d> operator*(const translation<Q, d> &a,
+                            const translation<Q, d> &b) {
+  return translation<Q, d>(a.offset() + b.offset());
+}
+
+/**\brief Composes two scales.
+ *
+ * Uniform scales are closed under composition, so the result is another
+ * scale, by the product of both factors.
+ *
+ * \param a The object providing the left-hand side of the composition.
+ * \param b The object providing the right-hand side of the composition.
+ *
+ * \returns A scale that is the composite of the two transformations.
+ */
+template <typename Q, std::size_t d>
+scale<Q, d> operator*(const scale<Q, d> &a, const scale<Q, d> &b) {
+  return scale<Q, d>(a.factor() * b.factor());
+}
+
+/**\brief Composes two elementary transformations.
+ *
+ * Starts with the matrix of the right-hand side and then lets the left-hand
+ * side modify the few rows it affects.
+ *
+ * \tparam A Left-hand side template; an elementary transformation.
+ * \tparam B Right-hand side template; an elementary transformation.
+ *
+ * \param a The object providing the left-hand side of the composition.
+ * \param b The object providing the right-hand side of the composition.
+ *
+ * \returns The composite of the two transformations, of the kind given by
+ *    kind::compose; e.g. a linear map for two rotations.
+ */
+template <template <typename, std::size_t> class A,
+          template <typename, std::size_t> class B, typename Q, std::size_t d>
+typename std::enable_if<kind::elementary<A<Q, d>>::value &&
+                            kind::elementary<B<Q, d>>::value,
+                        kind::composite<A<Q, d>, B<Q, d>, Q, d>>::type
+operator*(const A<Q, d> &a, const B<Q, d> &b) {
+  math::matrix<Q, d + 1, d + 1> m = b.matrix;
+  a.premultiply(m);
+  return kind::composite<A<Q, d>, B<Q, d>, Q, d>(m);
+}
+
+/**\brief Composes an elementary and a classified transformation.
+ * \copydetails operator*(const A<Q,d>&,const B<Q,d>&)
+ */
+template <template <typename, std::size_t> class T, typename Q, std::size_t d,
+          class K>
+typename std::enable_if<kind::elementary<T<Q, d>>::value,
+                        kind::composite<T<Q, d>, classified<Q, d, K>, Q,
+                                        d>>::type
+operator*(const T<Q, d> &a, const classified<Q, d, K> &b) {
+  math::matrix<Q, d + 1, d + 1> m = b.matrix;
+  a.premultiply(m);
+  return kind::composite<T<Q, d>, classified<Q, d, K>, Q, d>(m);
+}
+
+/**\brief Composes a classified and an elementary transformation.
+ * \copydetails operator*(const A<Q,d>&,const B<Q,d>&)
+ */
+template <template <typename, std::size_t> class T, typename Q, std::size_t d,
+          class K>
+typename std::enable_if<kind::elementary<T<Q, d>>::value,
+                        kind::composite<classified<Q, d, K>, T<Q, d>, Q,
+                                        d>>::type
+operator*(const classified<Q, d, K> &a, const T<Q, d> &b) {
+  math::matrix<Q, d + 1, d + 1> m = a.matrix;
+  b.postmultiply(m);
+  return kind::composite<classified<Q, d, K>, T<Q, d>, Q, d>(m);
+}
+
+/**\brief Composes two classified transformations.
+ *
+ * \param a The object providing the left-hand side of the composition.
+ * \param b The object providing the right-hand side of the composition.
+ *
+ * \returns The composite of the two transformations, of the kind given by
+ *    kind::compose.
+ */
+template <typename Q, std::size_t d, class A, class B>
+kind::composite<classified<Q, d, A>, classified<Q, d, B>, Q, d>
+operator*(const classified<Q, d, A> &a, const classified<Q, d, B> &b) {
+  return kind::composite<classified<Q, d, A>, classified<Q, d, B>, Q, d>(
+      a.matrix * b.matrix);
+}
+
+/**\brief Composes an elementary and an affine transformation.
+ *
+ * Only the rows of b that the elementary transformation touches are
+ * recalculated, instead of doing a full matrix product.
+ *
+ * \tparam T Left-hand side template; an elementary transformation.
+ *
+ * \param a The object providing the left-hand side of the composition.
+ * \param b The object providing the right-hand side of the composition.
+ *
+ * \returns An affine transformation that is the composite of the two
+ *    transformations.
+ */
+template <template <typename, std::size_t> class T, typename Q, std::size_t d>
+typename std::enable_if<kind::elementary<T<Q, d>>::value, affine<Q, d>>::type
+operator*(const T<Q, d> &a, const affine<Q, d> &b) {
+  math::matrix<Q, d + 1, d + 1> m = b.matrix;
+  a.premultiply(m);
+  return affine<Q, d>(m);
+}
+
+/**\brief Composes an affine and an elementary transformation.
+ * \copydetails operator*(const T<Q,d>&,const affine<Q,d>&)
+ */
+template <template <typename, std::size_t> class T, typename Q, std::size_t d>
+typename std::enable_if<kind::elementary<T<Q, d>>::value, affine<Q, d>>::type
+operator*(const affine<Q, d> &a, const T<Q, d> &b) {
+  math::matrix<Q, d + 1, d + 1> m = a.matrix;
+  b.postmultiply(m);
+  return affine<Q, d>(m);
+}
+
+/**\brief Composes an elementary and a projective transformation.
+ * \copydetails operator*(const T<Q,d>&,const affine<Q,d>&)
+ */
+template <template <typename, std::size_t> class T, typename Q, std::size_t d>
+typename std::enable_if<kind::elementary<T<Q, d>>::value,
+                        projective<Q, d>>::type
+operator*(const T<Q, d> &a, const projective<Q, d> &b) {
+  math::matrix<Q, d + 1, d + 1> m = b.matrix;
+  a.premultiply(m);
+  return projective<Q, d>(m);
+}
+
+/**\brief Composes a projective and an elementary transformation.
+ * \copydetails operator*(const T<Q,d>&,const affine<Q,d>&)
+ */
+template <template <typename, std::size_t> class T, typename Q, std::size_t d>
+typename std::enable_if<kind::elementary<T<Q, d>>::value,
+                        projective<Q, d>>::type
+operator*(const projective<Q, d> &a, const T<Q, d> &b) {
+  math::matrix<Q, d + 1, d + 1> m = a.matrix;
+  b.postmultiply(m);
+  return projective<Q, d>(m);
+}
 }
 }
 }
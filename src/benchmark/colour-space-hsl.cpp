@@ -0,0 +1,85 @@
+/**\file
+ * \brief Benchmarks for colour-space-hsl.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/colour-space-hsl.h>
+#include <ef.gy/prng.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Time conversions.
+ *
+ * Converts a million colours from RGB to HSL and back with the HSL vectors,
+ * in bulk and to 8 bits with the lookup table, and logs how long each one
+ * took.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int benchmarkConversion(std::ostream &log) {
+  const std::size_t n = 1 << 20;
+  prng::splitmix rng(0);
+  std::vector<float> colours(n * 3), h(n * 3), c(n * 3);
+  std::vector<std::uint8_t> bytes(n * 3);
+  for (auto &v : colours) {
+    v = rng.uniform<float>();
+  }
+
+  float sum = 0;
+  const auto time = [&log](const char *name, const std::function<void()> &f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+    log << name << ": "
+        << std::chrono::duration<double, std::milli>(end - start).count()
+        << "ms\n";
+  };
+
+  time("vectors", [&] {
+    for (std::size_t i = 0; i < n; i++) {
+      const math::vector<float, 3, math::format::HSL> v(
+          math::vector<float, 3, math::format::RGB>(
+              colours[i * 3], colours[i * 3 + 1], colours[i * 3 + 2]));
+      const math::vector<float, 3, math::format::RGB> w = v;
+      sum += w[0] + w[1] + w[2];
+    }
+  });
+  time("bulk to HSL",
+       [&] { math::colour::toHSL(colours.data(), h.data(), n); });
+  time("bulk to RGB", [&] { math::colour::toRGB(h.data(), c.data(), n); });
+  time("8-bit", [&] {
+    const math::colour::rgb8<> lut;
+    lut(h.data(), bytes.data(), n);
+  });
+
+  float bulk = 0;
+  for (const auto &v : c) {
+    bulk += v;
+  }
+  if (std::fabs(sum - bulk) > 1e-3 * n) {
+    log << "bulk conversion differs: " << bulk << " instead of " << sum
+        << "\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+TEST_BATCH(benchmarkConversion)
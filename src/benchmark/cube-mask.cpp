@@ -0,0 +1,57 @@
+/**\file
+ * \brief Benchmarks for hypercube masks
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <iostream>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/polytope.h>
+
+using namespace efgy;
+
+/**\brief Time hypercube mesh generation.
+ *
+ * Measures how long it takes to get the face table of a cube mask for the
+ * first time, and how long it takes to scale it to a hypercube mesh.
+ *
+ * \tparam depth The number of dimensions of the hypercube.
+ *
+ * \return Zero.
+ */
+template<std::size_t depth>
+int timeCubeMesh(std::ostream &log) {
+  constexpr const int rounds = 20;
+  geometry::parameters<double> parameter;
+  parameter.radius = 2;
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto &table = geometry::generators::mask::cube<depth>::faces();
+  const auto startup = std::chrono::steady_clock::now();
+  std::size_t n = 0;
+  for (int i = 0; i < rounds; i++) {
+    n += geometry::generators::cube<double, depth>::faces(parameter).size();
+  }
+  const auto generated = std::chrono::steady_clock::now();
+
+  log << "depth " << depth << ": " << table.size() << " faces; startup: "
+      << std::chrono::duration<double, std::micro>(startup - start).count()
+      << "us, mesh generation: "
+      << std::chrono::duration<double, std::micro>(generated - startup)
+                 .count() / rounds
+      << "us (" << n << ")\n";
+
+  return 0;
+}
+
+TEST_BATCH(
+    timeCubeMesh<3>, timeCubeMesh<4>, timeCubeMesh<5>, timeCubeMesh<6>,
+    timeCubeMesh<7>, timeCubeMesh<8>, timeCubeMesh<9>, timeCubeMesh<10>)
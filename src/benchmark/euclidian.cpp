@@ -0,0 +1,85 @@
+/**\file
+ * \brief Benchmarks for euclidian.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <iostream>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/euclidian.h>
+
+using namespace efgy;
+
+/**\brief Time normals of one dimension.
+ *
+ * Calculates normals of the same integer-valued vectors with the Laplace
+ * expansion in exact integer arithmetic and with Gaussian elimination in
+ * floating point, and logs how long each of them takes per call.
+ *
+ * \tparam d Number of dimensions.
+ *
+ * \param[out] log A stream to copy log messages to.
+ */
+template <unsigned int d> static void timeNormal(std::ostream &log) {
+  constexpr const int rounds = 1000;
+
+  std::array<math::vector<long, d>, d - 1> a;
+  std::array<math::vector<double, d>, d - 1> b;
+
+  for (unsigned int i = 0; i < (d - 1); i++) {
+    for (unsigned int j = 0; j < d; j++) {
+      a[i][j] = long((i * 7 + j * 3 + i * j) % 9) - 4 + (i == j ? 5 : 0);
+      b[i][j] = a[i][j];
+    }
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  long sa = 0;
+  for (int r = 0; r < rounds; r++) {
+    a[0][0] += r & 1;
+    sa += math::normal(a)[0];
+  }
+  const auto laplace = std::chrono::steady_clock::now();
+  double sb = 0;
+  for (int r = 0; r < rounds; r++) {
+    b[0][0] += r & 1;
+    sb += math::normal(b)[0];
+  }
+  const auto elimination = std::chrono::steady_clock::now();
+
+  log << "d=" << d << ": Laplace expansion: "
+      << std::chrono::duration<double, std::micro>(laplace - start).count() /
+             rounds
+      << "us, Gaussian elimination: "
+      << std::chrono::duration<double, std::micro>(elimination - laplace)
+                 .count() / rounds
+      << "us (" << sa << ", " << sb << ")\n";
+}
+
+/**\brief Time normal calculation.
+ *
+ * Logs the cost of both normal algorithms from 4 to 8 dimensions.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero.
+ */
+int benchmarkNormal(std::ostream &log) {
+  timeNormal<4>(log);
+  timeNormal<5>(log);
+  timeNormal<6>(log);
+  timeNormal<7>(log);
+  timeNormal<8>(log);
+
+  return 0;
+}
+
+TEST_BATCH(benchmarkNormal)
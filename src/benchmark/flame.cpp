@@ -0,0 +1,65 @@
+/**\file
+ * \brief Benchmarks for flame.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/flame.h>
+
+using namespace efgy;
+
+using flame = geometry::transformation::flame<double, 2>;
+
+/**\brief Time batch evaluation.
+ *
+ * Transforms points with only a few active variations, both one at a time and
+ * in blocks, and logs how long both take.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero.
+ */
+int benchmarkBatch(std::ostream &log) {
+  flame g;
+  g.coefficient[0] = 0.5;
+  g.coefficient[3] = 0.3;
+  g.coefficient[28] = 0.2;
+
+  std::vector<math::vector<double, 2>> many(200000);
+  prng::splitmix rng(42);
+  for (auto &p : many) {
+    p[0] = rng.uniform<double>() * 1.8 - 0.9 + 0.05;
+    p[1] = rng.uniform<double>() * 1.8 - 0.9 + 0.05;
+  }
+  std::vector<math::vector<double, 2>> out(many.size());
+
+  prng::splitmix a(7), b(7);
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < many.size(); i++) {
+    out[i] = g(many[i], b);
+  }
+  const auto single = std::chrono::steady_clock::now();
+  g(many.begin(), many.end(), out.begin(), a);
+  const auto blocks = std::chrono::steady_clock::now();
+
+  log << many.size() << " points with 3 variations: "
+      << std::chrono::duration<double, std::milli>(single - start).count()
+      << "ms one at a time, "
+      << std::chrono::duration<double, std::milli>(blocks - single).count()
+      << "ms in blocks\n";
+
+  return 0;
+}
+
+TEST_BATCH(benchmarkBatch)
@@ -0,0 +1,56 @@
+/**\file
+ * \brief Benchmarks for mesh-cache.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <iostream>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/mesh-cache.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Time factory lookups.
+ *
+ * Looks up a detailed torus through the model factory twice and logs how
+ * long the miss and the hit took.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int benchmarkFactory(std::ostream &log) {
+  geometry::meshCache<double> cache;
+  geometry::parameters<double> params;
+  params.precision = 200;
+  geometry::meshCache<double>::request request(cache, params);
+
+  for (const char *pass : {"miss", "hit"}) {
+    const auto start = std::chrono::steady_clock::now();
+    geometry::with<double, geometry::functor::mesh, 4>(request, "torus", 2, 3);
+    const auto end = std::chrono::steady_clock::now();
+
+    if (!request.result) {
+      log << "factory did not find a torus\n";
+      return next_integer();
+    }
+
+    log << pass << ": " << request.result->triangles.size() / 3
+        << " triangles in "
+        << std::chrono::duration<double, std::milli>(end - start).count()
+        << "ms\n";
+  }
+
+  return 0;
+}
+
+TEST_BATCH(benchmarkFactory)
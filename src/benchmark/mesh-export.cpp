@@ -0,0 +1,91 @@
+/**\file
+ * \brief Benchmarks for mesh-export.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <iostream>
+#include <streambuf>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/mesh-export.h>
+#include <ef.gy/parametric.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Byte counter
+ *
+ * A stream buffer that throws away everything written to it, but counts the
+ * bytes, to measure exporters without being limited by a disk.
+ */
+class countingBuffer : public std::streambuf {
+public:
+  std::size_t bytes = 0;
+
+protected:
+  std::streamsize xsputn(const char *, std::streamsize n) {
+    bytes += n;
+    return n;
+  }
+
+  int_type overflow(int_type c) {
+    bytes++;
+    return c;
+  }
+};
+
+/**\brief Time exporters.
+ *
+ * Streams a torus with a million faces through each exporter into a stream
+ * that only counts bytes, and logs how fast each exporter is.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when all faces were written, nonzero otherwise.
+ */
+int benchmarkExport(std::ostream &log) {
+  geometry::parameters<double> params;
+  params.precision = 500;
+  geometry::parametric<double, 2, geometry::formula::torus> torus(params);
+  const std::size_t faces = torus.size();
+
+  const struct {
+    const char *name;
+    std::size_t (*write)(std::ostream &, decltype(torus) &);
+  } exporters[] = {
+      {"PLY", geometry::ply<decltype(torus)>},
+      {"STL", geometry::stl<decltype(torus)>},
+      {"OBJ", geometry::obj<decltype(torus)>},
+  };
+
+  for (const auto &e : exporters) {
+    countingBuffer buffer;
+    std::ostream stream(&buffer);
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t n = e.write(stream, torus);
+    const auto end = std::chrono::steady_clock::now();
+
+    if (n != faces || !stream) {
+      log << e.name << " exporter wrote " << n << " of " << faces
+          << " faces\n";
+      return next_integer();
+    }
+
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    log << e.name << ": " << n << " faces, " << buffer.bytes << " bytes in "
+        << seconds * 1000 << "ms (" << n / seconds << " faces/s)\n";
+  }
+
+  return 0;
+}
+
+TEST_BATCH(benchmarkExport)
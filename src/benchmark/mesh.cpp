@@ -0,0 +1,90 @@
+/**\file
+ * \brief Benchmarks for mesh.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <iostream>
+#include <map>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/mesh.h>
+#include <ef.gy/parametric.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Time mesh builder against an ordered map.
+ *
+ * Builds the mesh of a plane with a million faces, whose corners are shared
+ * by up to four faces, both with the mesh builder and with an ordered map for
+ * vertex lookups, and logs how long each of them took. The map compares
+ * vertices bitwise, so it may find a few more than the builder, which merges
+ * vertices that only differ by rounding errors.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int benchmarkBuilder(std::ostream &log) {
+  geometry::parameters<double> params;
+  params.precision = 1000;
+  geometry::parametric<double, 2, geometry::formula::plane> plane(params);
+
+  std::vector<std::array<math::vector<double, 2>, 4>> faces;
+  for (const auto &f : plane) {
+    std::array<math::vector<double, 2>, 4> g;
+    for (std::size_t i = 0; i < 4; i++) {
+      g[i] = f[i];
+    }
+    faces.push_back(g);
+  }
+  const math::vector<double, 2> normal{{0, 1}};
+
+  const auto start = std::chrono::steady_clock::now();
+  geometry::meshBuilder<float> mesh;
+  for (const auto &f : faces) {
+    mesh.add(f, normal, 0.5);
+  }
+  const auto built = std::chrono::steady_clock::now();
+
+  std::map<std::vector<float>, unsigned int> lookup;
+  std::vector<unsigned int> triangles;
+  for (const auto &f : faces) {
+    for (const std::size_t j : {0, 1, 2, 0, 2, 3}) {
+      std::vector<float> v{float(f[j][0]), float(f[j][1]), float(normal[0]),
+                           float(normal[1]), 0.5f};
+      triangles.push_back(
+          lookup.emplace(v, (unsigned int)(lookup.size())).first->second);
+    }
+  }
+  const auto mapped = std::chrono::steady_clock::now();
+
+  if (mesh.triangles.size() != triangles.size() ||
+      mesh.size() != 1001 * 1001) {
+    log << "mesh has " << mesh.size() << " vertices and "
+        << mesh.triangles.size() << " triangle indices, expected 1002001 and "
+        << triangles.size() << "\n";
+    return next_integer();
+  }
+
+  const double hashed = std::chrono::duration<double>(built - start).count();
+  const double ordered = std::chrono::duration<double>(mapped - built).count();
+  log << faces.size() << " faces, " << mesh.size() << " vertices, "
+      << mesh.triangles.size() - mesh.size() << " reused: " << hashed * 1000
+      << "ms (" << faces.size() / hashed << " faces/s) with the mesh builder, "
+      << ordered * 1000 << "ms (" << faces.size() / ordered
+      << " faces/s) with a map, which found " << lookup.size()
+      << " bitwise distinct vertices\n";
+
+  return 0;
+}
+
+TEST_BATCH(benchmarkBuilder)
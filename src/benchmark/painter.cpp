@@ -0,0 +1,65 @@
+/**\file
+ * \brief Benchmarks for painter.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/painter.h>
+#include <ef.gy/parametric.h>
+#include <ef.gy/render-svg.h>
+
+using namespace efgy;
+
+/**\brief Time sorted SVG output.
+ *
+ * Writes a torus with 360000 faces in sorted and in unsorted mode, and logs
+ * how long each of them takes.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero.
+ */
+int benchmarkSVG(std::ostream &log) {
+  geometry::transformation::affine<double, 3> transformation;
+  geometry::projection<double, 3> projection({{0, 0, 5}}, {{0, 0, 0}});
+  geometry::transformation::affine<double, 2> transformation2 =
+      geometry::transformation::scale<double, 2>(100);
+  geometry::transformation::projective<double, 2> projection2;
+  render::svg<double, 1> svg1;
+  render::svg<double, 2> svg2(transformation2, projection2, svg1);
+  render::svg<double, 3> svg(transformation, projection, svg2);
+
+  geometry::parameters<double> params;
+  params.precision = 300;
+  geometry::parametric<double, 2, geometry::formula::torus> torus(params);
+
+  for (const bool sorted : {false, true}) {
+    svg2.sorted = sorted;
+    svg.frameStart();
+
+    std::ostringstream out;
+    const auto start = std::chrono::steady_clock::now();
+    out << svg << torus;
+    const auto end = std::chrono::steady_clock::now();
+
+    log << torus.size() << " faces " << (sorted ? "sorted" : "unsorted")
+        << ": "
+        << std::chrono::duration<double, std::milli>(end - start).count()
+        << "ms\n";
+  }
+
+  return 0;
+}
+
+TEST_BATCH(benchmarkSVG)
@@ -0,0 +1,68 @@
+/**\file
+ * \brief Benchmarks for parallel.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/parallel.h>
+#include <ef.gy/parametric.h>
+#include <ef.gy/ifs.h>
+#include <ef.gy/flame.h>
+
+using namespace efgy;
+
+/**\brief Time parallel generation.
+ *
+ * Generates the mesh of a model by plain iteration and with as many threads
+ * as there are cores, and logs how long both take.
+ *
+ * \tparam     C          The model.
+ * \tparam     iterations Number of iterations for IFS models.
+ * \param[out] log        A stream for test cases to log messages to.
+ *
+ * \return Zero.
+ */
+template <class C, unsigned int iterations = 3>
+int timeGenerate(std::ostream &log) {
+  auto params = geometry::parameters<double>();
+  params.iterations = iterations;
+  auto p = C(params, typename C::format());
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<typename C::face> faces;
+  for (const auto &f : p) {
+    faces.push_back(f);
+  }
+  const auto iterated = std::chrono::steady_clock::now();
+
+  std::vector<typename C::face> buffer(p.size());
+  geometry::generate(p, buffer.begin(), 0);
+  const auto generated = std::chrono::steady_clock::now();
+
+  log << p.id() << ": " << faces.size() << " faces in "
+      << std::chrono::duration<double, std::milli>(iterated - start).count()
+      << "ms iterating, "
+      << std::chrono::duration<double, std::milli>(generated - iterated)
+             .count()
+      << "ms generating in parallel\n";
+
+  return 0;
+}
+
+TEST_BATCH(timeGenerate<geometry::cube<double, 5>>,
+           timeGenerate<geometry::parametric<double, 3,
+                                             geometry::formula::sphere>>,
+           timeGenerate<geometry::sierpinski::gasket<double, 3>, 6>,
+           timeGenerate<geometry::sierpinski::carpet<double, 2>, 6>,
+           timeGenerate<geometry::flame::random<double, 2>, 5>)
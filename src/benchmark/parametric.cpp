@@ -0,0 +1,54 @@
+/**\file
+ * \brief Benchmarks for parametric.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <iostream>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/parametric.h>
+
+using namespace efgy;
+
+/**\brief Time grid meshes.
+ *
+ * Creates the faces of a finely sampled Klein bagel with the iterator and as a
+ * grid mesh with normals, and logs how long both take.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero.
+ */
+int benchmarkGrid(std::ostream &log) {
+  geometry::parameters<double> fine;
+  fine.precision = 200;
+  geometry::parametric<double, 2, geometry::formula::kleinBagel> bagel(fine);
+
+  double sum = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto &f : bagel) {
+    sum += f[0][0];
+  }
+  const auto faces = std::chrono::steady_clock::now();
+  const auto m = bagel.mesh();
+  const auto grid = std::chrono::steady_clock::now();
+
+  log << bagel.size() << " klein bagel faces: "
+      << std::chrono::duration<double, std::milli>(faces - start).count()
+      << "ms with the iterator, "
+      << std::chrono::duration<double, std::milli>(grid - faces).count()
+      << "ms as a grid with " << m.vertices.size() << " vertices and normals ("
+      << sum << ")\n";
+
+  return 0;
+}
+
+TEST_BATCH(benchmarkGrid)
@@ -0,0 +1,57 @@
+/**\file
+ * \brief Benchmarks for polytopes and IFS
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <iostream>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/ifs.h>
+
+using namespace efgy;
+
+/**\brief Time IFS mesh generation.
+ *
+ * Iterates through all faces of an IFS and logs how long it takes to generate
+ * the full mesh.
+ *
+ * \tparam     C          The IFS.
+ * \tparam     iterations Number of iterations for the IFS.
+ * \param[out] log        A stream for test cases to log messages to.
+ *
+ * \return Zero.
+ */
+template<class C, std::size_t iterations>
+int timeIFS(std::ostream &log) {
+  auto params = geometry::parameters<double>();
+  params.iterations = iterations;
+
+  const auto p = C(params, typename C::format());
+
+  const auto start = std::chrono::steady_clock::now();
+  std::size_t c = 0;
+  for (const auto &f : p) {
+    c += f.size();
+  }
+  const auto generated = std::chrono::steady_clock::now();
+
+  log << p.id() << " with " << iterations << " iterations: " << p.size()
+      << " faces, " << c << " vertices in "
+      << std::chrono::duration<double, std::milli>(generated - start).count()
+      << "ms\n";
+
+  return 0;
+}
+
+TEST_BATCH(
+    timeIFS<geometry::sierpinski::gasket<double,2>, 8>,
+    timeIFS<geometry::sierpinski::gasket<double,3>, 6>,
+    timeIFS<geometry::sierpinski::carpet<double,2>, 5>)
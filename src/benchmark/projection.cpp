@@ -0,0 +1,174 @@
+/**\file
+ * \brief Benchmarks for projection.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/render-svg.h>
+#include <ef.gy/prng.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Projection chain
+ *
+ * An SVG renderer for d dimensions with all of its lower renderers, the
+ * transformations and projections they use, and the original way of
+ * projecting points one level at a time to compare the renderer with.
+ *
+ * \tparam d Number of dimensions of the top level.
+ */
+template <unsigned int d> class chain {
+public:
+  chain(void)
+      : projection(eye(), math::vector<double, d>()),
+        renderer(transformation, projection, lower.renderer) {
+    transformation = geometry::transformation::translation<double, d>(shift());
+    combined = transformation * projection;
+  }
+
+  /**\brief Project point one level at a time
+   *
+   * \param[in] v The point to project.
+   *
+   * \returns The point in SVG coordinates.
+   */
+  math::vector<double, 2> operator()(const math::vector<double, d> &v) const {
+    return lower(combined * v);
+  }
+
+  /**\brief Eye position
+   *
+   * \returns The position of the eye for this level.
+   */
+  static math::vector<double, d> eye(void) {
+    math::vector<double, d> r;
+    for (unsigned int i = 0; i < d; i++) {
+      r[i] = 2.5 + 0.5 * i;
+    }
+    return r;
+  }
+
+  /**\brief Translation
+   *
+   * \returns The translation that is applied before the projection.
+   */
+  static math::vector<double, d> shift(void) {
+    math::vector<double, d> r;
+    r[0] = 0.1;
+    r[d - 1] = -0.2;
+    return r;
+  }
+
+  geometry::transformation::affine<double, d> transformation;
+  geometry::projection<double, d> projection;
+  geometry::transformation::projective<double, d> combined;
+  chain<d - 1> lower;
+  render::svg<double, d> renderer;
+};
+
+/**\brief 2D projection chain
+ *
+ * The end of the chain, which only scales and moves points.
+ */
+template <> class chain<2> {
+public:
+  chain(void) : renderer(transformation, projection, lower) {
+    transformation = geometry::transformation::scale<double, 2>(100) *
+                     geometry::transformation::translation<double, 2>(
+                         math::vector<double, 2>{{1, 2}});
+  }
+
+  /**\copydoc chain::operator() */
+  math::vector<double, 2> operator()(const math::vector<double, 2> &v) const {
+    return transformation * v;
+  }
+
+  geometry::transformation::affine<double, 2> transformation;
+  geometry::transformation::projective<double, 2> projection;
+  render::svg<double, 1> lower;
+  render::svg<double, 2> renderer;
+};
+
+/**\brief Random point
+ *
+ * \tparam d Number of dimensions of the point.
+ *
+ * \param[in] rng The random number generator to use.
+ *
+ * \returns A point with all coordinates in [-1,1).
+ */
+template <unsigned int d>
+math::vector<double, d> randomPoint(prng::splitmix &rng) {
+  math::vector<double, d> v;
+  for (unsigned int i = 0; i < d; i++) {
+    v[i] = rng.uniform<double>() * 2 - 1;
+  }
+  return v;
+}
+
+/**\brief Time projections.
+ *
+ * Projects lots of random 7D points to 2D, once one level at a time and once
+ * with the flattened pipeline, and logs how long each took.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when both produced the same points, nonzero otherwise.
+ */
+int benchmarkProjection(std::ostream &log) {
+  constexpr const unsigned int d = 7;
+  chain<d> c;
+  c.renderer.frameStart();
+
+  geometry::pipeline<double, d, 2> pipeline;
+  c.renderer.compose(pipeline,
+                     geometry::transformation::affine<double, d>().matrix);
+
+  prng::splitmix rng(1);
+  std::vector<math::vector<double, d>> points(200000);
+  for (auto &p : points) {
+    p = randomPoint<d>(rng);
+  }
+
+  double a = 0, b = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto &p : points) {
+    a += c(p)[0];
+  }
+  const auto chained = std::chrono::steady_clock::now();
+  for (const auto &p : points) {
+    math::vector<double, 2> out;
+    if (pipeline(p, out)) {
+      b += out[0];
+    }
+  }
+  const auto fused = std::chrono::steady_clock::now();
+
+  if (std::fabs(a - b) > 1e-6 * std::fabs(a)) {
+    log << "sums of projected points differ: " << a << " and " << b << "\n";
+    return next_integer();
+  }
+
+  log << points.size() << " 7D points: "
+      << std::chrono::duration<double, std::milli>(chained - start).count()
+      << "ms one level at a time, "
+      << std::chrono::duration<double, std::milli>(fused - chained).count()
+      << "ms with the pipeline\n";
+
+  return 0;
+}
+
+TEST_BATCH(benchmarkProjection)
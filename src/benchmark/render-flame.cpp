@@ -0,0 +1,79 @@
+/**\file
+ * \brief Benchmarks for render-flame.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/render-flame.h>
+
+using namespace efgy;
+
+/**\brief Time fractal flame rendering.
+ *
+ * Renders a random fractal flame and logs how many samples per second the
+ * renderer manages.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero.
+ */
+int benchmarkFlame(std::ostream &log) {
+  using renderer = render::chaosGame<double, 2>;
+
+  geometry::parameters<double> params;
+  const auto functions =
+      geometry::generators::randomFlame<double, 2, 2>::functions(params);
+  const std::vector<renderer::colour> palette{
+      {{1, .5, 0}}, {{.2, .2, 1}}, {{1, 1, 1}}, {{0, 1, .5}}};
+  constexpr unsigned long long samples = 10000000;
+
+  renderer r(256, 256, functions, palette);
+
+  const auto start = std::chrono::steady_clock::now();
+  r(samples);
+  const auto end = std::chrono::steady_clock::now();
+
+  const double seconds = std::chrono::duration<double>(end - start).count();
+  log << samples << " flame samples in " << seconds * 1000 << "ms ("
+      << samples / seconds << " samples/s)\n";
+
+  return 0;
+}
+
+/**\brief Time fractal flame post processing.
+ *
+ * Post processes a 2048x2048 accumulation buffer with as many threads as
+ * there are cores and logs how many pixels per second are processed.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero.
+ */
+int benchmarkPostProcess(std::ostream &log) {
+  std::vector<float> big(2048 * 2048, 10.f);
+  render::postProcess post(0);
+  post.setColourMap(3);
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto image = post(big, big, 2048, 2048);
+  const auto end = std::chrono::steady_clock::now();
+
+  const double seconds = std::chrono::duration<double>(end - start).count();
+  log << image.size() / 4 << " pixels post processed in " << seconds * 1000
+      << "ms (" << double(big.size()) / seconds << " pixels/s)\n";
+
+  return 0;
+}
+
+TEST_BATCH(benchmarkFlame, benchmarkPostProcess)
@@ -0,0 +1,117 @@
+/**\file
+ * \brief Benchmarks for render-raster.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <iostream>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/factory.h>
+#include <ef.gy/render-raster.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Raster benchmark state
+ *
+ * The renderers and parameters that all models are rendered with, and where
+ * to log the results.
+ */
+class rasterBenchmark {
+public:
+  rasterBenchmark(std::ostream &pLog)
+      : log(pLog), projection({{1, 2, 5}}, {{0, 0, 0}}),
+        raster2(transformation2, projection2, raster1, 1280, 720),
+        raster(transformation, projection, raster2) {}
+
+  std::ostream &log;
+  geometry::parameters<double> parameter;
+  geometry::transformation::affine<double, 3> transformation;
+  geometry::projection<double, 3> projection;
+  geometry::transformation::affine<double, 2> transformation2;
+  geometry::transformation::projective<double, 2> projection2;
+  render::raster<double, 1> raster1;
+  render::raster<double, 2> raster2;
+  render::raster<double, 3> raster;
+
+  /**\brief Number of models that were rendered */
+  std::size_t models = 0;
+};
+
+/**\brief Geometry factory functor: time rasterising a model
+ *
+ * Renders models with a render depth of 3 at the factory's default sizes and
+ * logs how long that takes; other render depths are skipped.
+ *
+ * \tparam Q      Base data type for calculations
+ * \tparam T      Model template, e.g. efgy::geometry::cube
+ * \tparam d      Model depth, e.g. 4 for a tesseract
+ * \tparam e      Model render depth.
+ * \tparam format Vector coordinate format to work in.
+ */
+template <typename Q, template <class, std::size_t> class T, std::size_t d,
+          std::size_t e, typename format>
+class timeRaster : public geometry::functor::symmetric<rasterBenchmark> {
+public:
+  using geometry::functor::symmetric<rasterBenchmark>::argument;
+  using geometry::functor::symmetric<rasterBenchmark>::output;
+
+  static output apply(argument out, const format &tag) {
+    if constexpr (e == 3) {
+      geometry::autoAdapt<Q, e, T<Q, d>, format> model(out.parameter, tag);
+
+      const auto start = std::chrono::steady_clock::now();
+      out.raster.frameStart();
+      for (const auto &p : model) {
+        std::array<math::vector<Q, e>, std::tuple_size<
+                                           typename std::decay<decltype(p)>::
+                                               type>::value> q;
+        for (std::size_t i = 0; i < q.size(); i++) {
+          q[i] = p[i];
+        }
+        out.raster.draw(q);
+      }
+      out.raster.frameEnd();
+      const auto end = std::chrono::steady_clock::now();
+
+      out.log << d << "-" << T<Q, d>::id() << ": "
+              << out.raster.base().cull.emitted << " faces in "
+              << std::chrono::duration<double, std::milli>(end - start).count()
+              << "ms\n";
+      out.models++;
+    }
+    return out;
+  }
+};
+
+/**\brief Time rasterising factory models.
+ *
+ * Renders every model that the factory can create in up to 3 dimensions into
+ * a 1280x720 image, once with plain shading and once with fractal flame
+ * colouring.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when any models were rendered, nonzero otherwise.
+ */
+int benchmarkModels(std::ostream &log) {
+  rasterBenchmark state(log);
+
+  for (const bool flame : {false, true}) {
+    state.raster2.fractalFlameColouring = flame;
+    log << (flame ? "fractal flame colouring:\n" : "plain shading:\n");
+    geometry::with<double, timeRaster, 3>(state, "*", 0, 3);
+  }
+
+  return state.models > 0 ? 0 : next_integer();
+}
+
+TEST_BATCH(benchmarkModels)
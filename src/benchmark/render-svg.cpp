@@ -0,0 +1,67 @@
+/**\file
+ * \brief Benchmarks for render-svg.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/render-svg.h>
+#include <ef.gy/prng.h>
+
+using namespace efgy;
+
+/**\brief Time SVG polygon output.
+ *
+ * Draws lots of random triangles with the 2D renderer, at full precision and
+ * rounded to two decimals, and logs how long that takes.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero.
+ */
+int benchmarkDraw(std::ostream &log) {
+  geometry::transformation::affine<double, 2> transformation;
+  geometry::transformation::projective<double, 2> projection;
+  render::svg<double, 1> lower;
+  render::svg<double, 2> svg(transformation, projection, lower);
+
+  prng::splitmix rng(1);
+  std::vector<std::array<math::vector<double, 2>, 3>> triangles(200000);
+  for (auto &t : triangles) {
+    for (auto &v : t) {
+      v[0] = rng.uniform<double>() * 1000;
+      v[1] = rng.uniform<double>() * 1000;
+    }
+  }
+
+  for (const int decimals : {-1, 2}) {
+    std::ostringstream output;
+    svg.encoder.precision(decimals);
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto &t : triangles) {
+      svg.draw(output, t);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    log << triangles.size() << " triangles with "
+        << (decimals < 0 ? std::string("full precision")
+                         : std::to_string(decimals) + " decimals")
+        << ": " << output.str().size() << " bytes in "
+        << std::chrono::duration<double, std::milli>(end - start).count()
+        << "ms\n";
+  }
+
+  return 0;
+}
+
+TEST_BATCH(benchmarkDraw)
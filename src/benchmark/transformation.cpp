@@ -0,0 +1,84 @@
+/**\file
+ * \brief Benchmarks for transformation.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <chrono>
+#include <iostream>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/transformation.h>
+
+using namespace efgy::geometry::transformation;
+using namespace efgy::test;
+
+/* \brief Times inverses of one dimension.
+ *
+ * Inverts a projective transformation in d dimensions, once changing the
+ * matrix before every call so the inverse has to be recalculated, and once
+ * reusing the cached inverse of an unchanged matrix.
+ *
+ * \tparam d Number of dimensions.
+ *
+ * \param log A stream for message output.
+ */
+template <std::size_t d> static void timeInverse(std::ostream &log) {
+  constexpr const int rounds = 2000;
+  invertible<projective<double, d>> p;
+  for (std::size_t i = 0; i <= d; i++) {
+    for (std::size_t k = 0; k <= d; k++) {
+      p.matrix[i][k] = (i == k) ? d : double((i * 3 + k) % 5) * 0.5 - 1;
+    }
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  double sum = 0;
+  for (int i = 0; i < rounds; i++) {
+    p.matrix[0][0] += 1e-9;
+    sum += p.inverse().matrix[0][0];
+  }
+  const auto recalculated = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; i++) {
+    sum += p.inverse().matrix[0][0];
+  }
+  const auto cached = std::chrono::steady_clock::now();
+
+  log << "d=" << d << ": recalculated inverse: "
+      << std::chrono::duration<double, std::micro>(recalculated - start)
+                 .count() / rounds
+      << "us, cached inverse: "
+      << std::chrono::duration<double, std::micro>(cached - recalculated)
+                 .count() / rounds
+      << "us (" << sum << ")\n";
+}
+
+/* \brief Times inverse transformations.
+ *
+ * Logs the cost of recalculated and cached inverses of projective
+ * transformations from 3 to 10 dimensions.
+ *
+ * \param log A stream for message output.
+ *
+ * \returns Zero.
+ */
+int benchmarkInverse(std::ostream &log) {
+  timeInverse<3>(log);
+  timeInverse<4>(log);
+  timeInverse<5>(log);
+  timeInverse<6>(log);
+  timeInverse<7>(log);
+  timeInverse<8>(log);
+  timeInverse<9>(log);
+  timeInverse<10>(log);
+
+  return 0;
+}
+
+TEST_BATCH(benchmarkInverse)
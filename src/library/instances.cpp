@@ -0,0 +1,27 @@
+/**\file
+ * \brief Library of common template instances
+ *
+ * Compiled once for each base type and depth by 'make library', with
+ * EF_GY_LIBRARY_TYPE set to the base type and EF_GY_LIBRARY_DEPTH set to the
+ * depth, or to zero for the instances that do not depend on the depth. The
+ * resulting objects define the instances that ef.gy/instances.h declares.
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <ef.gy/instances.h>
+
+#if EF_GY_LIBRARY_DEPTH == 0
+EF_GY_INSTANCES_COMMON(template, EF_GY_LIBRARY_TYPE)
+#elif EF_GY_LIBRARY_DEPTH == 2
+EF_GY_INSTANCES_DEPTH(template, EF_GY_LIBRARY_TYPE, 2)
+#else
+EF_GY_INSTANCES_DEPTH(template, EF_GY_LIBRARY_TYPE, EF_GY_LIBRARY_DEPTH)
+EF_GY_INSTANCES_RENDER(template, EF_GY_LIBRARY_TYPE, EF_GY_LIBRARY_DEPTH)
+#endif
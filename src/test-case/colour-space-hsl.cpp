@@ -0,0 +1,141 @@
+/**\file
+ * \brief Test cases for colour-space-hsl.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/colour-space-hsl.h>
+#include <ef.gy/prng.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+using rgb = math::vector<double, 3, math::format::RGB>;
+using hsl = math::vector<double, 3, math::format::HSL>;
+using rgba = math::vector<double, 4, math::format::RGB>;
+using hsla = math::vector<double, 4, math::format::HSL>;
+
+/**\brief Test bulk conversions.
+ * \test Converts a grid of RGBA colours to HSLA and back, both in bulk and
+ *       with the HSL vectors, and makes sure that both agree and that the
+ *       round trip yields the original colours, including in place.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testBulk(std::ostream &log) {
+  std::vector<double> colours;
+  for (int r = 0; r <= 6; r++) {
+    for (int g = 0; g <= 6; g++) {
+      for (int b = 0; b <= 6; b++) {
+        colours.insert(colours.end(), {r / 6., g / 6., b / 6., r / 7.});
+      }
+    }
+  }
+  const std::size_t n = colours.size() / 4;
+
+  std::vector<double> h(colours.size()), c(colours.size());
+  math::colour::toHSL<4>(colours.data(), h.data(), n);
+  math::colour::toRGB<4>(h.data(), c.data(), n);
+
+  for (std::size_t i = 0; i < n; i++) {
+    const double *p = &colours[i * 4];
+    const hsla v(rgba(p[0], p[1], p[2], p[3]));
+    const rgba w = v;
+    for (std::size_t j = 0; j < 4; j++) {
+      if (std::fabs(v[j] - h[i * 4 + j]) > 1e-12 ||
+          std::fabs(w[j] - c[i * 4 + j]) > 1e-12 ||
+          std::fabs(p[j] - c[i * 4 + j]) > 1e-12) {
+        log << "colour " << i << ", channel " << j << ": " << p[j] << " -> "
+            << h[i * 4 + j] << " -> " << c[i * 4 + j] << ", expected "
+            << v[j] << " -> " << w[j] << "\n";
+        return next_integer();
+      }
+    }
+  }
+
+  std::vector<double> three;
+  for (std::size_t i = 0; i < colours.size(); i++) {
+    if (i % 4 != 3) {
+      three.push_back(colours[i]);
+    }
+  }
+  const auto original = three;
+  math::colour::toHSL(three.data(), three.data(), n);
+  for (std::size_t i = 0; i < n; i++) {
+    if (std::fabs(three[i * 3 + 1] - h[i * 4 + 1]) > 1e-12) {
+      log << "in-place conversion to HSL differs for colour " << i << "\n";
+      return next_integer();
+    }
+  }
+  math::colour::toRGB(three.data(), three.data(), n);
+  for (std::size_t i = 0; i < three.size(); i++) {
+    if (std::fabs(three[i] - original[i]) > 1e-12) {
+      log << "in-place round trip changed channel " << i << "\n";
+      return next_integer();
+    }
+  }
+
+  const double wrapped[] = {-0.25, 1, 0.5, 2.25, 1, 0.5};
+  double out[6];
+  math::colour::toRGB(wrapped, out, 2);
+  const rgb expected = hsl(0.75, 1, 0.5);
+  for (std::size_t j = 0; j < 3; j++) {
+    if (std::fabs(out[j] - expected[j]) > 1e-12 ||
+        std::fabs(out[j + 3] - out[j] - (j == 0 ? 0 : j == 1 ? 1 : -1)) >
+            1e-12) {
+      log << "hue was not wrapped around\n";
+      return next_integer();
+    }
+  }
+
+  return 0;
+}
+
+/**\brief Test 8-bit conversions.
+ * \test Converts random HSLA colours to 8-bit RGBA with the lookup table and
+ *       makes sure the results are within one of the rounded bulk conversion.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testRGB8(std::ostream &log) {
+  prng::splitmix rng(42);
+  std::vector<float> colours(4096 * 4);
+  for (auto &v : colours) {
+    v = rng.uniform<float>();
+  }
+  colours[0] = 0.9999f;
+
+  std::vector<float> reference(colours.size());
+  std::vector<std::uint8_t> result(colours.size());
+  math::colour::toRGB<4>(colours.data(), reference.data(), 4096);
+  const math::colour::rgb8<> lut;
+  lut.operator()<4>(colours.data(), result.data(), 4096);
+
+  for (std::size_t i = 0; i < result.size(); i++) {
+    const long expected = std::lround(reference[i] * 255);
+    if (std::labs(long(result[i]) - expected) > 1) {
+      log << "channel " << i << " is " << int(result[i]) << " instead of "
+          << expected << "\n";
+      return next_integer();
+    }
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testBulk, testRGB8)
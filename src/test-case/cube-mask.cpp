@@ -61,10 +61,52 @@ int analyseCubeMaskProperties(std::ostream &log) {
   return 0;
 }
 
+/**\brief Check hypercube mesh generation.
+ * \test Scales the face table of a cube mask to a hypercube mesh, and makes
+ *     sure that it has one square for each pair of axes and each corner of
+ *     the remaining depth - 2 dimensional cube, and that all coordinates of
+ *     the mesh are plus or minus half the radius.
+ *
+ * \tparam depth The number of dimensions of the hypercube.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+template<std::size_t depth>
+int checkCubeMesh(std::ostream &log) {
+  geometry::parameters<double> parameter;
+  parameter.radius = 2;
+
+  const auto &table = geometry::generators::mask::cube<depth>::faces();
+  const auto faces = geometry::generators::cube<double, depth>::faces(parameter);
+  const std::size_t expected =
+      (std::size_t(1) << (depth - 2)) * depth * (depth - 1) / 2;
+
+  if (faces.size() != table.size() || faces.size() != expected) {
+    log << "depth " << depth << ": mesh has " << faces.size()
+        << " faces, mask has " << table.size() << ", expected " << expected
+        << "\n";
+    return -1;
+  }
+
+  for (const auto &f : faces) {
+    for (const auto &v : f) {
+      for (const auto &c : v) {
+        if (c != 1 && c != -1) {
+          log << "unexpected coordinate in mesh: " << c << "\n";
+          return -1;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
 TEST_BATCH(
     analyseCubeMaskProperties<geometry::generators::mask::cube<1>>,
     analyseCubeMaskProperties<geometry::generators::mask::cube<2>>,
     analyseCubeMaskProperties<geometry::generators::mask::cube<3>>,
     analyseCubeMaskProperties<geometry::generators::mask::cube<4>>,
     analyseCubeMaskProperties<geometry::generators::mask::cube<5>>,
-    )
+    checkCubeMesh<3>, checkCubeMesh<4>, checkCubeMesh<5>, checkCubeMesh<6>,
+    checkCubeMesh<7>, checkCubeMesh<8>, checkCubeMesh<9>, checkCubeMesh<10>)
@@ -0,0 +1,177 @@
+/**\file
+ * \brief Test cases for culling.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/culling.h>
+#include <ef.gy/parametric.h>
+#include <ef.gy/render-svg.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Test culling single faces.
+ * \test Runs a few faces through a culling stage and makes sure that they are
+ *       culled according to their winding and position, and that they are
+ *       counted correctly.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testFaces(std::ostream &log) {
+  using face = std::array<math::vector<double, 2>, 4>;
+  const face clockwise{{{{0, 0}}, {{1, 0}}, {{1, 1}}, {{0, 1}}}};
+  const face counterClockwise{{{{0, 0}}, {{0, 1}}, {{1, 1}}, {{1, 0}}}};
+  const face edge{{{{0, 0}}, {{1, 1}}, {{2, 2}}, {{3, 3}}}};
+  const face right{{{{11, 0}}, {{12, 0}}, {{12, 1}}, {{11, 1}}}};
+  const face across{{{{-5, 5}}, {{15, 5}}, {{15, 6}}, {{-5, 6}}}};
+
+  render::culling<double> cull;
+  if (!cull(clockwise) || !cull(counterClockwise) || !cull(edge) ||
+      !cull(right) || cull.emitted != 4 || cull.culled() != 0) {
+    log << "default culling stage culled faces\n";
+    return next_integer();
+  }
+
+  cull.reset();
+  cull.front = render::culling<double>::clockwise;
+  if (!cull(clockwise) || cull(counterClockwise) || cull(edge)) {
+    log << "clockwise faces not culled correctly\n";
+    return next_integer();
+  }
+
+  cull.front = render::culling<double>::counterClockwise;
+  if (cull(clockwise) || !cull(counterClockwise)) {
+    log << "counterclockwise faces not culled correctly\n";
+    return next_integer();
+  }
+
+  cull.front = render::culling<double>::any;
+  cull.clip({{0, 0}}, {{10, 10}});
+  if (cull(right) || !cull(across) || !cull(clockwise)) {
+    log << "faces not culled against the view correctly\n";
+    return next_integer();
+  }
+
+  if (cull.emitted != 4 || cull.backFacing != 3 || cull.outside != 1 ||
+      cull.culled() != 4) {
+    log << "unexpected statistics: " << cull.emitted << " emitted, "
+        << cull.backFacing << " back faces, " << cull.outside << " outside\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Count paths
+ *
+ * \param[in] svg An SVG fragment.
+ *
+ * \returns The number of path elements in the fragment.
+ */
+static std::size_t paths(const std::string &svg) {
+  std::size_t n = 0;
+  for (auto p = svg.find("<path"); p != std::string::npos;
+       p = svg.find("<path", p + 1)) {
+    n++;
+  }
+  return n;
+}
+
+/**\brief Test culling a torus.
+ * \test Renders a torus, whose faces are all wound the same way, to SVG with
+ *       either winding culled, makes sure that the two halves add up to all of
+ *       the faces and that the statistics match the output, then culls the
+ *       torus against a view that only shows part of it.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testTorus(std::ostream &log) {
+  geometry::parameters<double> params;
+  params.precision = 24;
+  geometry::parametric<double, 2, geometry::formula::torus> torus(params);
+
+  geometry::transformation::affine<double, 3> transformation;
+  geometry::projection<double, 3> projection({{1, 2, 3}}, {{0, 0, 0}});
+  geometry::transformation::affine<double, 2> transformation2 =
+      geometry::transformation::scale<double, 2>(100);
+  geometry::transformation::projective<double, 2> projection2;
+  render::svg<double, 1> svg1;
+  render::svg<double, 2> svg2(transformation2, projection2, svg1);
+  render::svg<double, 3> svg(transformation, projection, svg2);
+
+  std::size_t bytes = 0, visible = 0;
+  for (const auto front : {render::culling<double>::any,
+                           render::culling<double>::clockwise,
+                           render::culling<double>::counterClockwise}) {
+    svg2.cull.front = front;
+    svg.frameStart();
+
+    std::ostringstream out;
+    out << svg << torus;
+
+    const auto &cull = svg2.cull;
+    if (paths(out.str()) != cull.emitted ||
+        cull.emitted + cull.culled() != torus.size()) {
+      log << "statistics do not match the output: " << paths(out.str())
+          << " paths, " << cull.emitted << " emitted, " << cull.culled()
+          << " culled, " << torus.size() << " faces\n";
+      return next_integer();
+    }
+
+    if (front == render::culling<double>::any) {
+      bytes = out.str().size();
+      if (cull.culled() != 0) {
+        log << "faces culled without culling\n";
+        return next_integer();
+      }
+    } else {
+      if (cull.emitted < torus.size() / 4 ||
+          cull.emitted > torus.size() * 3 / 4) {
+        log << "unexpected number of visible faces: " << cull.emitted
+            << " of " << torus.size() << "\n";
+        return next_integer();
+      }
+      log << cull.emitted << " of " << torus.size() << " faces emitted, "
+          << out.str().size() << " of " << bytes << " bytes\n";
+      visible += cull.emitted;
+    }
+  }
+
+  if (visible > torus.size()) {
+    log << "faces were visible with both windings\n";
+    return next_integer();
+  }
+
+  svg2.cull.front = render::culling<double>::any;
+  svg2.cull.clip({{0, -1000}}, {{1000, 1000}});
+  svg.frameStart();
+  std::ostringstream out;
+  out << svg << torus;
+
+  if (svg2.cull.outside == 0 || svg2.cull.emitted == 0 ||
+      paths(out.str()) != svg2.cull.emitted) {
+    log << "unexpected view culling: " << svg2.cull.emitted << " emitted, "
+        << svg2.cull.outside << " outside\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testFaces, testTorus)
@@ -0,0 +1,137 @@
+/**\file
+ * \brief Test cases for euclidian.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/euclidian.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Compare normals of one dimension.
+ *
+ * Calculates normals of integer-valued vectors with the Laplace expansion in
+ * exact integer arithmetic and with Gaussian elimination in floating point,
+ * and makes sure they agree; the second set of vectors has a zero first
+ * column, which needs a column swap.
+ *
+ * \tparam d Number of dimensions.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \returns True if both calculations produced the same vectors.
+ */
+template <unsigned int d> static bool checkNormal(std::ostream &log) {
+  for (int seed = 0; seed < 2; seed++) {
+    std::array<math::vector<long, d>, d - 1> a;
+    std::array<math::vector<double, d>, d - 1> b;
+
+    for (unsigned int i = 0; i < (d - 1); i++) {
+      for (unsigned int j = 0; j < d; j++) {
+        a[i][j] = (seed == 1 && j == 0) ? 0 : long((i * 7 + j * 3 + i * j) % 9) -
+                                                  4 + (i == j ? 5 : 0);
+        b[i][j] = a[i][j];
+      }
+    }
+
+    const math::vector<long, d> na = math::normal(a);
+    const math::vector<double, d> nb = math::normal(b);
+
+    for (unsigned int j = 0; j < d; j++) {
+      if (std::fabs(double(na[j]) - nb[j]) > 1e-6 * (1 + std::fabs(nb[j]))) {
+        log << "normal component " << j << " differs: " << na[j] << " vs. "
+            << nb[j] << "\n";
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/**\brief Test normal calculation.
+ *
+ * \test Compares normals calculated with Gaussian elimination with those
+ *     calculated with Laplace expansion, from 4 to 8 dimensions.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testNormal(std::ostream &log) {
+  if (!(checkNormal<4>(log) && checkNormal<5>(log) && checkNormal<6>(log) &&
+        checkNormal<7>(log) && checkNormal<8>(log))) {
+    return next_integer();
+  }
+
+  std::array<math::vector<double, 5>, 4> dependent{
+      {{{1, 2, 3, 4, 5}}, {{2, 4, 6, 8, 10}}, {{0, 1, 0, 1, 0}},
+       {{1, 0, 0, 0, 1}}}};
+  const auto n = math::normal(dependent);
+
+  for (unsigned int j = 0; j < 5; j++) {
+    if (n[j] != 0) {
+      log << "normal of linearly dependent vectors should be zero\n";
+      return next_integer();
+    }
+  }
+
+  return 0;
+}
+
+/**\brief Test batch normal calculation.
+ *
+ * \test Calculates the normals of a set of faces in 5-space, and checks that
+ *     each normal is perpendicular to all the edges of its face.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testNormals(std::ostream &log) {
+  std::vector<std::array<math::vector<double, 5>, 5>> faces(32);
+
+  for (std::size_t f = 0; f < faces.size(); f++) {
+    for (unsigned int i = 0; i < 5; i++) {
+      for (unsigned int j = 0; j < 5; j++) {
+        faces[f][i][j] = std::sin(double(f * 25 + i * 5 + j));
+      }
+    }
+  }
+
+  std::vector<math::vector<double, 5>> result(faces.size());
+  auto end =
+      math::normals<double, 5>(faces.begin(), faces.end(), result.begin());
+
+  if (end != result.end()) {
+    log << "batch normal calculation did not produce one normal per face\n";
+    return next_integer();
+  }
+
+  for (std::size_t f = 0; f < faces.size(); f++) {
+    for (unsigned int i = 1; i < 5; i++) {
+      const double p = (faces[f][i] - faces[f][0]) * result[f];
+      if (std::fabs(p) > 1e-9) {
+        log << "normal of face " << f << " is not perpendicular to edge " << i
+            << ": " << p << "\n";
+        return next_integer();
+      }
+    }
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testNormal, testNormals)
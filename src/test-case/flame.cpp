@@ -0,0 +1,181 @@
+/**\file
+ * \brief Test cases for flame.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/flame.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+using flame = geometry::transformation::flame<double, 2>;
+
+/**\brief Create test points
+ *
+ * \param[in] count Number of points to create.
+ *
+ * \returns Points scattered over the square from (-1,-1) to (1,1), none of
+ *     which are on either axis.
+ */
+static std::vector<math::vector<double, 2>> points(std::size_t count) {
+  std::vector<math::vector<double, 2>> rv(count);
+  prng::splitmix rng(42);
+  for (auto &p : rv) {
+    p[0] = rng.uniform<double>() * 1.8 - 0.9 + 0.05;
+    p[1] = rng.uniform<double>() * 1.8 - 0.9 + 0.05;
+  }
+  return rv;
+}
+
+/**\brief Test batch evaluation.
+ * \test Transforms a set of points with all variations active, both one at a
+ *       time and as a batch, and makes sure the results are the same.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testBatch(std::ostream &log) {
+  flame f;
+  for (std::size_t i = 0; i < flame::coefficients; i++) {
+    f.coefficient[i] = 1. / flame::coefficients;
+  }
+  f.matrix[2][0] = 0.3;
+  f.matrix[2][1] = -0.2;
+
+  const auto in = points(1000);
+  std::vector<math::vector<double, 2>> batch(in.size());
+
+  prng::splitmix a(7), b(7);
+  const auto end = f(in.begin(), in.end(), batch.begin(), a);
+
+  if (end != batch.end()) {
+    log << "batch evaluation did not produce one result per input\n";
+    return next_integer();
+  }
+
+  for (std::size_t i = 0; i < in.size(); i++) {
+    const auto single = f(in[i], b);
+    for (std::size_t j = 0; j < 2; j++) {
+      if (!(single[j] == batch[i][j] ||
+            (std::isnan(single[j]) && std::isnan(batch[i][j])))) {
+        log << "point " << i << " differs: " << batch[i][j] << " vs. "
+            << single[j] << "\n";
+        return next_integer();
+      }
+    }
+  }
+
+  if (a.counter != in.size() * flame::randomNumbers || a.counter != b.counter) {
+    log << "unexpected number of random numbers used: " << a.counter << "\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test individual variations.
+ * \test Applies each variation on its own to a few points, checks some of
+ *       them against values calculated by hand, and makes sure that all of
+ *       them produce finite results away from their singularities.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testVariations(std::ostream &log) {
+  const math::vector<double, 2> v{{0.3, 0.4}};
+
+  const struct {
+    std::size_t variation;
+    double x, y;
+  } expected[] = {
+      {0, 0.3, 0.4},
+      {2, 0.3 / 0.25, 0.4 / 0.25},
+      {27, 2 / 1.5 * 0.3, 2 / 1.5 * 0.4},
+      {28, 4 / 4.25 * 0.3, 4 / 4.25 * 0.4},
+      {29, std::sin(0.3), 0.4},
+      {42, std::sin(0.3) / std::cos(0.4), std::tan(0.4)},
+      {48, 0.3 / 0.07, 0.4 / 0.07},
+  };
+
+  for (const auto &e : expected) {
+    flame f;
+    f.coefficient[e.variation] = 1;
+    const auto r = f * v;
+    if (std::fabs(r[0] - e.x) > 1e-12 || std::fabs(r[1] - e.y) > 1e-12) {
+      log << "variation " << e.variation << " produced (" << r[0] << ", "
+          << r[1] << "), expected (" << e.x << ", " << e.y << ")\n";
+      return next_integer();
+    }
+  }
+
+  for (std::size_t i = 0; i < flame::coefficients; i++) {
+    flame f;
+    f.coefficient[i] = 0.5;
+    f.matrix[2][0] = 0.1;
+    f.matrix[2][1] = 0.2;
+    prng::splitmix rng(i);
+    for (const auto &p : points(50)) {
+      const auto r = f(p, rng);
+      if (!std::isfinite(r[0]) || !std::isfinite(r[1])) {
+        log << "variation " << i << " produced (" << r[0] << ", " << r[1]
+            << ") for (" << p[0] << ", " << p[1] << ")\n";
+        return next_integer();
+      }
+    }
+  }
+
+  return 0;
+}
+
+/**\brief Test random flames.
+ * \test Creates random flames in two and three dimensions with different
+ *       seeds, and makes sure that they only use as many of the general
+ *       variations as the parameters allow, and that their coefficients add
+ *       up to one.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+template <std::size_t d> int testRandom(std::ostream &log) {
+  using random = geometry::transformation::randomFlame<double, d>;
+  geometry::parameters<double> params;
+
+  for (unsigned long long seed = 0; seed < 50; seed++) {
+    const random f(params, seed);
+    std::size_t nonzero = 0;
+    double sum = 0;
+    for (std::size_t i = 0; i < random::coefficients; i++) {
+      if (f.coefficient[i] != 0 && i >= random::generalCoefficients) {
+        log << "seed " << seed << " picked planar variation " << i << "\n";
+        return next_integer();
+      }
+      nonzero += f.coefficient[i] != 0 ? 1 : 0;
+      sum += f.coefficient[i];
+    }
+
+    if (nonzero > params.flameCoefficients || std::fabs(sum - 1) > 1e-9) {
+      log << "seed " << seed << " has " << nonzero
+          << " variations with a sum of " << sum << "\n";
+      return next_integer();
+    }
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testBatch, testVariations, testRandom<2>, testRandom<3>)
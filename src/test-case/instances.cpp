@@ -0,0 +1,76 @@
+/**\file
+ * \brief Test cases for instances.h
+ *
+ * The test cases are not linked against the library, so this file defines the
+ * double instances itself; this also makes sure that every member of those
+ * instances compiles.
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <iostream>
+#include <sstream>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/instances.h>
+
+EF_GY_INSTANCES(template, double)
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Test rendering with instances.
+ * \test Renders the faces of a cube with the SVG and raster renderers that are
+ *       declared in instances.h and makes sure that both produce output.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testRender(std::ostream &log) {
+  geometry::parameters<double> params;
+  geometry::polytope<double, 3, geometry::generators::cube> cube(params);
+
+  geometry::transformation::affine<double, 3> transformation;
+  geometry::projection<double, 3> projection({{1, 2, 5}}, {{0, 0, 0}});
+  geometry::transformation::affine<double, 2> transformation2;
+  geometry::transformation::projective<double, 2> projection2;
+
+  render::svg<double, 1> svg1;
+  render::svg<double, 2> svg2(transformation2, projection2, svg1);
+  render::svg<double, 3> svg(transformation, projection, svg2);
+  render::raster<double, 1> raster1;
+  render::raster<double, 2> raster2(transformation2, projection2, raster1, 32,
+                                    32);
+  render::raster<double, 3> raster(transformation, projection, raster2);
+
+  std::ostringstream output;
+  svg.frameStart();
+  raster.frameStart();
+  for (const auto &f : cube) {
+    svg.draw(output, f);
+    raster.draw(f);
+  }
+  raster.frameEnd();
+
+  if (output.str().find("<path") == std::string::npos) {
+    log << "no SVG output\n";
+    return next_integer();
+  }
+
+  const auto image = raster2.rgba();
+  if (image[(16 * raster2.width + 16) * 4] == 0) {
+    log << "cube not rasterised\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testRender)
@@ -0,0 +1,162 @@
+/**\file
+ * \brief Test cases for matrix expressions
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <iostream>
+#include <type_traits>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/matrix-expression.h>
+#include <ef.gy/transformation.h>
+
+using namespace efgy::math;
+using efgy::math::expression::lazy;
+using efgy::test::next_integer;
+
+/**\brief Fill matrix with test data
+ *
+ * \param[out] m    The matrix to fill.
+ * \param[in]  seed Changes the values in the matrix.
+ */
+template <std::size_t n, std::size_t m>
+static void fill(matrix<long, n, m> &r, long seed) {
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t j = 0; j < m; j++) {
+      r[i][j] = long(i * 3 + j * 5 + seed) % 7 - 3;
+    }
+  }
+}
+
+template <std::size_t n, std::size_t m>
+static bool equal(const matrix<long, n, m> &a, const matrix<long, n, m> &b) {
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t j = 0; j < m; j++) {
+      if (a[i][j] != b[i][j]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**\brief Test expression evaluation.
+ *
+ * \test Evaluates A*B*C + D - E and (A*B*C)/2 lazily and compares the results
+ *     to the same expressions calculated with the plain matrix operators.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testEvaluation(std::ostream &log) {
+  matrix<long, 9, 2> a;
+  matrix<long, 2, 11> b;
+  matrix<long, 11, 3> c;
+  matrix<long, 9, 3> d, e;
+  fill(a, 1);
+  fill(b, 2);
+  fill(c, 3);
+  fill(d, 4);
+  fill(e, 5);
+
+  matrix<long, 9, 3> expected = a * b * c + d - e;
+  matrix<long, 9, 3> actual = lazy(a) * b * c + d - e;
+
+  if (!equal(expected, actual)) {
+    log << "lazy evaluation of A*B*C + D - E differs from plain evaluation:\n"
+        << actual << "\nvs. expected:\n" << expected;
+    return next_integer();
+  }
+
+  expected = (a * b * c) / 2l;
+  actual = (lazy(a) * b * c) / 2l;
+
+  if (!equal(expected, actual)) {
+    log << "lazy evaluation of (A*B*C)/2 differs from plain evaluation:\n"
+        << actual << "\nvs. expected:\n" << expected;
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test chain ordering.
+ *
+ * \test Checks the split chosen for the chain of a 10x100, a 100x5 and a 5x50
+ *     matrix, where multiplying the first two matrices first is ten times
+ *     cheaper than the alternative. Also checks the splits for a chain of four
+ *     matrices, where the cheapest order is (A(BC))D.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testOrder(std::ostream &log) {
+  constexpr auto left = expression::order<3>({{10, 100, 5, 50}});
+  constexpr auto right = expression::order<3>({{50, 5, 100, 10}});
+
+  static_assert(left[0 * 3 + 2] == 1, "should multiply (AB)C");
+  static_assert(right[0 * 3 + 2] == 0, "should multiply A(BC)");
+
+  const auto chain = expression::order<4>({{40, 20, 30, 10, 30}});
+
+  if (chain[0 * 4 + 3] != 2 || chain[0 * 4 + 2] != 0 ||
+      chain[1 * 4 + 2] != 1) {
+    log << "unexpected splits for a chain of four: " << chain[0 * 4 + 3]
+        << ", " << chain[0 * 4 + 2] << ", " << chain[1 * 4 + 2]
+        << "; expected: 2, 0, 1\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test identity folding.
+ *
+ * \test Multiplies with an identity ghost matrix on either side and makes sure
+ *     that the identity disappears from the expression type.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testIdentity(std::ostream &log) {
+  ghost::matrix<long, 4, 4,
+                efgy::geometry::transformation::generator::identity> i;
+  matrix<long, 4, 4> a;
+  fill(a, 6);
+
+  auto l = lazy(i) * a;
+  auto r = lazy(a) * i;
+
+  static_assert(
+      std::is_same<decltype(l), expression::terminal<long, 4, 4>>::value,
+      "identity should vanish from the left of a product");
+  static_assert(
+      std::is_same<decltype(r), expression::terminal<long, 4, 4>>::value,
+      "identity should vanish from the right of a product");
+
+  matrix<long, 4, 4> s = lazy(a) + i;
+  a[0][0]++;
+  a[1][1]++;
+  a[2][2]++;
+  a[3][3]++;
+
+  if (!equal(s, a)) {
+    log << "unexpected result when adding identity:\n" << s
+        << "\nvs. expected:\n" << a;
+    return next_integer();
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testEvaluation, testOrder, testIdentity)
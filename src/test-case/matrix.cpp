@@ -11,6 +11,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <sstream>
 
@@ -272,5 +273,209 @@ int testIterator(std::ostream &log) {
   return 0;
 }
 
+/**\brief Compare a matrix product with a cell-by-cell calculation.
+ *
+ * Fills an n x m and an m x p matrix with small integers, multiplies them and
+ * checks every cell of the result against the plain sum of products.
+ *
+ * \tparam n Number of rows in the first operand.
+ * \tparam m Number of columns in the first operand.
+ * \tparam p Number of columns in the second operand.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return True if all cells matched, false otherwise.
+ */
+template <std::size_t n, std::size_t m, std::size_t p>
+static bool checkMultiplication(std::ostream &log) {
+  matrix<long, n, m> a;
+  matrix<long, m, p> b;
+
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t k = 0; k < m; k++) {
+      a[i][k] = long(i * 7 + k * 3) % 11 - 5;
+    }
+  }
+
+  for (std::size_t i = 0; i < m; i++) {
+    for (std::size_t k = 0; k < p; k++) {
+      b[i][k] = long(i * 5 + k) % 9 - 4;
+    }
+  }
+
+  matrix<long, n, p> r = a * b;
+
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t k = 0; k < p; k++) {
+      long e = 0;
+      for (std::size_t j = 0; j < m; j++) {
+        e += a[i][j] * b[j][k];
+      }
+      if (r[i][k] != e) {
+        log << "unexpected value in " << n << "x" << m << " by " << m << "x"
+            << p << " product at (" << i << "," << k << "): " << r[i][k]
+            << " vs. expected: " << e << "\n";
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/**\brief Test matrix multiplication.
+ *
+ * \test Multiplies two matrices that are larger than a single register tile
+ *     and not multiples of the tile size, then compares the result with a
+ *     product calculated cell by cell. The second product has an inner
+ *     dimension of more than two cache blocks, so that partial sums of
+ *     several blocks need to be added up, including a short final block.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testMultiplication(std::ostream &log) {
+  if (!(checkMultiplication<17, 13, 7>(log) &&
+        checkMultiplication<9, 150, 11>(log))) {
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test row and column views.
+ *
+ * \test Writes to a matrix through its row and column views and checks that
+ *     the changes end up in the right cells, and that the iterators of the
+ *     last column reach its end after exactly as many steps as there are
+ *     rows.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testViews(std::ostream &log) {
+  matrix<int, 3, 4> m;
+  int j = 0;
+  for (auto &c : m) {
+    c = j++;
+  }
+
+  auto c = m(2);
+  auto r = range<int, 3>(2, 10);
+
+  if (!std::equal(c.begin(), c.end(), r.begin())) {
+    log << "column view did not produce the expected sequence\n";
+    return next_integer();
+  }
+
+  const auto last = m(3);
+  std::size_t steps = 0;
+  for (auto it = last.begin(); it != last.end(); ++it) {
+    steps++;
+  }
+  if (steps != 3 || last.end() - last.begin() != 3 ||
+      last.begin()[2] != m[2][3]) {
+    log << "last column view has " << steps << " cells instead of 3\n";
+    return next_integer();
+  }
+
+  m(1)[2] = 42;
+  if (m[2][1] != 42) {
+    log << "write through column view ended up in the wrong cell\n";
+    return next_integer();
+  }
+
+  if (m.data()[2 * matrix<int, 3, 4>::stride + 1] != 42) {
+    log << "matrix storage is not in row-major order\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test matrix decompositions.
+ *
+ * \test Decomposes a matrix that needs row swaps with LU and QR, then checks
+ *     that multiplying the factors yields the original matrix, that the
+ *     inverse times the matrix yields the identity, and that the determinant
+ *     is the same as with Laplace expansion.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testDecomposition(std::ostream &log) {
+  matrix<double, 5, 5> m;
+  for (int i = 0; i < 5; i++) {
+    for (int k = 0; k < 5; k++) {
+      m[i][k] = i == k ? 0.5 : double((i * 7 + k * 3) % 5) - 2;
+    }
+  }
+
+  const auto l = lu(m);
+  const auto q = qr(m);
+
+  matrix<double, 5, 5> pm;
+  for (int i = 0; i < 5; i++) {
+    for (int k = 0; k < 5; k++) {
+      pm[i][k] = m[l.permutation[i]][k];
+    }
+  }
+
+  const auto a = l.lower() * l.upper();
+  const auto b = q.q * q.r;
+  const auto c = invert(m) * m;
+  const auto o = q.q * transpose(q.q);
+
+  for (int i = 0; i < 5; i++) {
+    for (int k = 0; k < 5; k++) {
+      const double e = i == k ? 1 : 0;
+      if (std::fabs(a[i][k] - pm[i][k]) > 1e-9 ||
+          std::fabs(b[i][k] - m[i][k]) > 1e-9 ||
+          std::fabs(c[i][k] - e) > 1e-9 || std::fabs(o[i][k] - e) > 1e-9 ||
+          (i > k && std::fabs(q.r[i][k]) > 1e-9)) {
+        log << "unexpected value in decomposition at (" << i << "," << k
+            << ")\nL*U:\n" << a << "P*A:\n" << pm << "Q*R:\n" << b
+            << "A^-1*A:\n" << c;
+        return next_integer();
+      }
+    }
+  }
+
+  matrix<double, 5, 5> s = m;
+  for (int k = 0; k < 5; k++) {
+    s[4][k] = s[1][k] * 2;
+  }
+
+  if (!lu(s).singular) {
+    log << "LU decomposition did not flag singular matrix\n";
+    return next_integer();
+  }
+
+  const matrix<double, 4, 4> m4 = m;
+  double expected = 0;
+  for (int i = 0; i < 4; i++) {
+    matrix<double, 3, 3> minor;
+    for (int j = 1; j < 4; j++) {
+      for (int k = 0, c = 0; k < 4; k++) {
+        if (k != i) {
+          minor[j - 1][c++] = m4[j][k];
+        }
+      }
+    }
+    expected += (i % 2 ? -1 : 1) * m4[0][i] * determinant(minor);
+  }
+
+  if (std::fabs(determinant(m4) - expected) > 1e-9) {
+    log << "determinant: " << determinant(m4) << " vs. expected: " << expected
+        << "\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
 TEST_BATCH(testConstruction, testAssignment, testAddition, testStream,
-           testIterator)
+           testIterator, testMultiplication, testViews, testDecomposition)
@@ -0,0 +1,241 @@
+/**\file
+ * \brief Test cases for mesh-cache.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <iostream>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/mesh-cache.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+using torus = geometry::parametricFactory<geometry::formula::torus>;
+
+/**\brief Test cache hits.
+ * \test Requests meshes with the same and with different parameters and makes
+ *       sure that only new models are generated, that parameters a model does
+ *       not use do not matter and that the statistics add up.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testHits(std::ostream &log) {
+  using format = math::format::cartesian;
+  geometry::meshCache<double> cache;
+  geometry::parameters<double> params;
+  params.precision = 16;
+
+  const auto cube = cache.get<geometry::cube, 3, 3>(params, format());
+  const auto square = cache.get<geometry::cube, 2, 2>(params, format());
+  const auto torus1 =
+      cache.get<torus::modelType, 2, 3>(params, format());
+
+  params.precision = 32;
+  const auto cube2 = cache.get<geometry::cube, 3, 3>(params, format());
+  const auto torus2 =
+      cache.get<torus::modelType, 2, 3>(params, format());
+  const auto cube4 = cache.get<geometry::cube, 3, 4>(params, format());
+
+  if (cube != cube2 || cube == square || torus1 == torus2 || cube == cube4) {
+    log << "wrong meshes shared between requests\n";
+    return next_integer();
+  }
+
+  if (cube->triangles.size() != 6 * 2 * 3 || cube->stride != 3 + 3 + 1 ||
+      cube4->stride != 4 + 4 + 1 ||
+      torus2->triangles.size() != 4 * torus1->triangles.size()) {
+    log << "unexpected mesh sizes: " << cube->triangles.size() << ", "
+        << torus1->triangles.size() << ", " << torus2->triangles.size()
+        << "\n";
+    return next_integer();
+  }
+
+  std::size_t bytes = 0;
+  for (const auto &m : {cube, square, torus1, torus2, cube4}) {
+    bytes += m->bytes();
+  }
+
+  if (cache.hits() != 1 || cache.misses() != 5 || cache.size() != 5 ||
+      cache.bytes() != bytes || cache.evictions() != 0) {
+    log << "unexpected statistics: " << cache.hits() << " hits, "
+        << cache.misses() << " misses, " << cache.size() << " meshes, "
+        << cache.bytes() << " bytes\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test eviction.
+ * \test Fills a cache with room for two meshes and makes sure that the least
+ *       recently used one is evicted, that evicted meshes stay valid and that
+ *       lowering the memory cap evicts meshes as well.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testEviction(std::ostream &log) {
+  using format = math::format::cartesian;
+  geometry::parameters<double> params;
+  params.precision = 8;
+
+  std::size_t size;
+  {
+    geometry::meshCache<double> probe;
+    size = probe.get<torus::modelType, 2, 3>(params, format())->bytes();
+  }
+
+  geometry::meshCache<double> cache(size * 2 + size / 2);
+  params.radius = 1;
+  const auto a = cache.get<torus::modelType, 2, 3>(params, format());
+  params.radius = 2;
+  const auto b = cache.get<torus::modelType, 2, 3>(params, format());
+  params.radius = 1;
+  cache.get<torus::modelType, 2, 3>(params, format());
+  params.radius = 3;
+  cache.get<torus::modelType, 2, 3>(params, format());
+
+  if (cache.size() != 2 || cache.evictions() != 1 || cache.hits() != 1 ||
+      cache.bytes() > size * 2 + size / 2) {
+    log << "unexpected statistics after eviction: " << cache.size()
+        << " meshes, " << cache.evictions() << " evictions\n";
+    return next_integer();
+  }
+
+  params.radius = 2;
+  if (cache.get<torus::modelType, 2, 3>(params, format()) == b ||
+      b->bytes() != size) {
+    log << "least recently used mesh was not evicted\n";
+    return next_integer();
+  }
+
+  params.radius = 1;
+  if (cache.get<torus::modelType, 2, 3>(params, format()) == a) {
+    log << "mesh survived two evictions\n";
+    return next_integer();
+  }
+
+  cache.limit(size);
+  if (cache.size() != 1 || cache.bytes() != size) {
+    log << "lowering the cap left " << cache.size() << " meshes\n";
+    return next_integer();
+  }
+
+  cache.limit(size / 2);
+  if (cache.get<torus::modelType, 2, 3>(params, format())->bytes() != size ||
+      cache.size() != 0) {
+    log << "mesh larger than the cap was stored\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test IFS parameters.
+ * \test Requests IFS meshes with different iterations, seeds and flame
+ *       coefficients and makes sure that each of them is a miss, while
+ *       requesting them again with the same parameters is a hit.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testIFS(std::ostream &log) {
+  using format = math::format::cartesian;
+  geometry::meshCache<double> cache;
+  geometry::parameters<double> params;
+  params.precision = 4;
+
+  params.iterations = 1;
+  const auto gasket1 =
+      cache.get<geometry::sierpinski::gasket, 2, 2>(params, format());
+  params.iterations = 3;
+  const auto gasket3 =
+      cache.get<geometry::sierpinski::gasket, 2, 2>(params, format());
+
+  if (gasket1 == gasket3 ||
+      gasket3->triangles.size() != 9 * gasket1->triangles.size()) {
+    log << "gasket meshes with 1 and 3 iterations have "
+        << gasket1->triangles.size() << " and " << gasket3->triangles.size()
+        << " triangle indices\n";
+    return next_integer();
+  }
+
+  params.iterations = 2;
+  params.seed = 1;
+  const auto affine1 =
+      cache.get<geometry::randomAffineIFS, 3, 3>(params, format());
+  const auto flame1 = cache.get<geometry::flame::random, 2, 3>(params, format());
+  params.seed = 2;
+  const auto affine2 =
+      cache.get<geometry::randomAffineIFS, 3, 3>(params, format());
+  const auto flame2 = cache.get<geometry::flame::random, 2, 3>(params, format());
+  params.flameCoefficients = 1;
+  const auto flame3 = cache.get<geometry::flame::random, 2, 3>(params, format());
+
+  if (affine1 == affine2 || affine1->vertices == affine2->vertices ||
+      flame1 == flame2 || flame2 == flame3) {
+    log << "random IFS meshes with different seeds are shared\n";
+    return next_integer();
+  }
+
+  params.seed = 1;
+  params.flameCoefficients = geometry::parameters<double>().flameCoefficients;
+  if (cache.get<geometry::randomAffineIFS, 3, 3>(params, format()) != affine1 ||
+      cache.get<geometry::flame::random, 2, 3>(params, format()) != flame1 ||
+      cache.hits() != 2 || cache.misses() != 7) {
+    log << "unexpected statistics: " << cache.hits() << " hits, "
+        << cache.misses() << " misses\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test factory lookups.
+ * \test Looks up a model through the model factory twice and makes sure that
+ *       the second lookup is answered from the cache.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testFactory(std::ostream &log) {
+  geometry::meshCache<double> cache;
+  geometry::parameters<double> params;
+  params.precision = 16;
+  geometry::meshCache<double>::request request(cache, params);
+
+  geometry::meshCache<double>::pointer first;
+  for (std::size_t pass = 0; pass < 2; pass++) {
+    geometry::with<double, geometry::functor::mesh, 4>(request, "torus", 2, 3);
+
+    if (!request.result) {
+      log << "factory did not find a torus\n";
+      return next_integer();
+    }
+    if (!first) {
+      first = request.result;
+    }
+  }
+
+  if (request.result != first || cache.hits() != 1 || cache.misses() != 1) {
+    log << "second factory lookup was not a hit\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testHits, testEviction, testIFS, testFactory)
@@ -0,0 +1,165 @@
+/**\file
+ * \brief Test cases for mesh-export.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/mesh-export.h>
+#include <ef.gy/parametric.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Byte counter
+ *
+ * A stream buffer that throws away everything written to it, but counts the
+ * bytes.
+ */
+class countingBuffer : public std::streambuf {
+public:
+  std::size_t bytes = 0;
+
+protected:
+  std::streamsize xsputn(const char *, std::streamsize n) {
+    bytes += n;
+    return n;
+  }
+
+  int_type overflow(int_type c) {
+    bytes++;
+    return c;
+  }
+};
+
+/**\brief Test cube export.
+ * \test Writes a cube in all three formats and makes sure that the headers,
+ *       the counts and the sizes of the files are as expected.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testCube(std::ostream &log) {
+  geometry::parameters<double> params;
+  geometry::cube<double, 3> cube(params);
+
+  std::ostringstream ply;
+  if (geometry::ply(ply, cube) != 6) {
+    log << "PLY exporter did not write 6 faces\n";
+    return next_integer();
+  }
+
+  const std::string p = ply.str();
+  const std::string header = "end_header\n";
+  const auto body = p.find(header);
+  if (p.compare(0, 36, "ply\nformat binary_little_endian 1.0\n") != 0 ||
+      p.find("element vertex 24\n") == std::string::npos ||
+      p.find("element face 6\n") == std::string::npos ||
+      body == std::string::npos ||
+      p.size() - body - header.size() != 24 * 3 * 4 + 6 * (1 + 4 * 4)) {
+    log << "unexpected PLY file:\n" << p.substr(0, body) << "\n";
+    return next_integer();
+  }
+
+  std::ostringstream stl;
+  geometry::stl(stl, cube);
+  const std::string s = stl.str();
+  std::uint32_t triangles;
+  std::memcpy(&triangles, s.data() + 80, 4);
+  if (s.size() != 84 + 12 * 50 || triangles != 12) {
+    log << "unexpected STL file: " << s.size() << " bytes, " << triangles
+        << " triangles\n";
+    return next_integer();
+  }
+
+  float normal[3];
+  std::memcpy(normal, s.data() + 84, sizeof(normal));
+  const float n = normal[0] * normal[0] + normal[1] * normal[1] +
+                  normal[2] * normal[2];
+  if (std::fabs(n - 1) > 1e-6) {
+    log << "first STL normal is not a unit vector\n";
+    return next_integer();
+  }
+
+  std::ostringstream obj;
+  geometry::obj(obj, cube);
+  std::istringstream in(obj.str());
+  std::string line;
+  std::size_t vertices = 0, faces = 0;
+  while (std::getline(in, line)) {
+    if (line.compare(0, 2, "v ") == 0) {
+      vertices++;
+    } else if (line == "f -4 -3 -2 -1") {
+      faces++;
+    }
+  }
+
+  if (vertices != 24 || faces != 6) {
+    log << "unexpected OBJ file:\n" << obj.str() << "\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test export sizes.
+ * \test Streams a torus through each exporter into a stream that only counts
+ *       bytes, and makes sure that all faces are written and that the binary
+ *       files have the expected sizes.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testSizes(std::ostream &log) {
+  geometry::parameters<double> params;
+  params.precision = 20;
+  geometry::parametric<double, 2, geometry::formula::torus> torus(params);
+  const std::size_t faces = torus.size();
+
+  const struct {
+    const char *name;
+    std::size_t (*write)(std::ostream &, decltype(torus) &);
+    std::size_t bytes;
+  } exporters[] = {
+      {"PLY", geometry::ply<decltype(torus)>, faces * (4 * 3 * 4 + 1 + 4 * 4)},
+      {"STL", geometry::stl<decltype(torus)>, 84 + faces * 2 * 50},
+      {"OBJ", geometry::obj<decltype(torus)>, 0},
+  };
+
+  for (const auto &e : exporters) {
+    countingBuffer buffer;
+    std::ostream stream(&buffer);
+
+    const std::size_t n = e.write(stream, torus);
+
+    if (n != faces || !stream) {
+      log << e.name << " exporter wrote " << n << " of " << faces
+          << " faces\n";
+      return next_integer();
+    }
+
+    if (e.bytes != 0 &&
+        (buffer.bytes < e.bytes || buffer.bytes > e.bytes + 512)) {
+      log << e.name << " exporter wrote " << buffer.bytes
+          << " bytes, expected " << e.bytes << " plus a header\n";
+      return next_integer();
+    }
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testCube, testSizes)
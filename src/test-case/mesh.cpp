@@ -0,0 +1,140 @@
+/**\file
+ * \brief Test cases for mesh.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <cmath>
+#include <iostream>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/mesh.h>
+#include <ef.gy/parametric.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Test mesh of a cube.
+ * \test Builds the mesh of a cube, which has 8 corners with 3 different
+ *       normals each, and makes sure that the vertices and index buffers are
+ *       as expected and that the triangles are at the cube's corners.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testCube(std::ostream &log) {
+  geometry::parameters<double> params;
+  geometry::cube<double, 3> cube(params);
+
+  geometry::meshBuilder<float> mesh;
+  mesh.add(cube);
+
+  if (mesh.stride != 7 || mesh.size() != 24) {
+    log << "expected 24 vertices of 7 elements, got " << mesh.size()
+        << " of " << mesh.stride << "\n";
+    return next_integer();
+  }
+
+  if (mesh.triangles.size() != 6 * 2 * 3 || mesh.lines.size() != 6 * 4 * 2) {
+    log << "unexpected index buffer sizes: " << mesh.triangles.size() << ", "
+        << mesh.lines.size() << "\n";
+    return next_integer();
+  }
+
+  for (const auto &i : mesh.triangles) {
+    const float *v = &mesh.vertices[i * mesh.stride];
+    const float n = v[3] * v[3] + v[4] * v[4] + v[5] * v[5];
+    if (std::fabs(std::fabs(v[0]) - 0.5) > 1e-6 ||
+        std::fabs(std::fabs(v[1]) - 0.5) > 1e-6 ||
+        std::fabs(std::fabs(v[2]) - 0.5) > 1e-6 || std::fabs(n - 1) > 1e-6 ||
+        v[6] != 0.5f) {
+      log << "vertex " << i << " is not a cube corner with a unit normal\n";
+      return next_integer();
+    }
+  }
+
+  mesh.add(cube);
+  if (mesh.size() != 24 || mesh.triangles.size() != 2 * 6 * 2 * 3) {
+    log << "adding the same faces again added new vertices\n";
+    return next_integer();
+  }
+
+  mesh.clear();
+  if (mesh.size() != 0 || !mesh.triangles.empty() || !mesh.lines.empty()) {
+    log << "mesh not empty after clear()\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test builder with the model's base type.
+ * \test Builds the mesh of a cube with a builder that uses the same base type
+ *       as the cube, which used to make the polygon overload ambiguous, and
+ *       makes sure it finds the same vertices as a builder with another type.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testSameType(std::ostream &log) {
+  geometry::parameters<double> params;
+  geometry::cube<double, 3> cube(params);
+
+  geometry::meshBuilder<double> mesh;
+  geometry::meshBuilder<float> reference;
+  mesh.add(cube);
+  reference.add(cube);
+
+  if (mesh.size() != reference.size() ||
+      mesh.triangles != reference.triangles || mesh.lines != reference.lines) {
+    log << "double builder found " << mesh.size() << " vertices, float "
+        << "builder found " << reference.size() << "\n";
+    return next_integer();
+  }
+
+  for (std::size_t i = 0; i < mesh.vertices.size(); i++) {
+    if (std::fabs(mesh.vertices[i] - reference.vertices[i]) > 1e-6) {
+      log << "vertex element " << i << " differs: " << mesh.vertices[i]
+          << " vs " << reference.vertices[i] << "\n";
+      return next_integer();
+    }
+  }
+
+  return 0;
+}
+
+/**\brief Test shared vertices.
+ * \test Builds the mesh of an 8x8 grid of coplanar squares, whose corners are
+ *       shared by up to four faces, and makes sure that each corner ends up
+ *       in the vertex buffer exactly once.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testShared(std::ostream &log) {
+  geometry::parameters<double> params;
+  params.precision = 8;
+  geometry::parametric<double, 2, geometry::formula::plane> plane(params);
+
+  geometry::meshBuilder<float> mesh;
+  mesh.add(plane);
+
+  if (mesh.size() != 9 * 9 || mesh.triangles.size() != 8 * 8 * 2 * 3) {
+    log << "expected 81 vertices and 384 triangle indices, got "
+        << mesh.size() << " and " << mesh.triangles.size() << "\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testCube, testSameType, testShared)
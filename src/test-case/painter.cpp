@@ -0,0 +1,188 @@
+/**\file
+ * \brief Test cases for painter.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/painter.h>
+#include <ef.gy/parametric.h>
+#include <ef.gy/prng.h>
+#include <ef.gy/render-svg.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Sort random depths
+ *
+ * Adds single vertex polygons with random depths to a buffer, using the
+ * coordinates to remember the depth and the order they were added in.
+ *
+ * \param[in]  p     The buffer to use.
+ * \param[in]  count The number of polygons to add.
+ * \param[out] runs  The number of temporary files before the flush.
+ *
+ * \returns The coordinates of the polygons, in the order they came back in.
+ */
+static std::vector<std::array<double, 2>>
+sortRandom(render::painter &p, std::size_t count, std::size_t &runs) {
+  prng::splitmix rng(42);
+  for (std::size_t i = 0; i < count; i++) {
+    const double depth = double(rng() % 1000) - 500 + rng.uniform<double>();
+    const double xy[2] = {depth, double(i)};
+    p.add(i % 7 == 0 ? 1.5 : depth, xy, 1);
+  }
+
+  runs = p.runs();
+  std::vector<std::array<double, 2>> r;
+  p.flush([&r](const double *xy, std::size_t) {
+    r.push_back({{xy[0], xy[1]}});
+  });
+  return r;
+}
+
+/**\brief Test depth sorting.
+ * \test Sorts polygons with random depths, both in memory and in chunks that
+ *       are merged from temporary files, and makes sure that they come back
+ *       from the back to the front, that polygons with the same depth keep
+ *       their order and that both ways give the same result.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testSort(std::ostream &log) {
+  const std::size_t count = 100000;
+
+  std::size_t runs;
+  render::painter memory(count, 4);
+  const auto sorted = sortRandom(memory, count, runs);
+
+  if (sorted.size() != count || memory.size() != 0 || runs != 0) {
+    log << "got " << sorted.size() << " of " << count << " polygons back\n";
+    return next_integer();
+  }
+
+  const auto depth = [](const std::array<double, 2> &p) -> double {
+    return std::size_t(p[1]) % 7 == 0 ? 1.5 : p[0];
+  };
+
+  for (std::size_t i = 1; i < count; i++) {
+    const double a = depth(sorted[i - 1]);
+    const double b = depth(sorted[i]);
+    if (float(a) < float(b) ||
+        (float(a) == float(b) && sorted[i - 1][1] > sorted[i][1])) {
+      log << "polygons " << sorted[i - 1][1] << " and " << sorted[i][1]
+          << " are in the wrong order\n";
+      return next_integer();
+    }
+  }
+
+  render::painter chunked(count / 10 + 3, 2);
+  const double xy[2] = {0, 0};
+  chunked.add(0, xy, 1);
+  if (chunked.size() != 1) {
+    log << "unexpected size after adding a polygon\n";
+    return next_integer();
+  }
+  chunked.clear();
+
+  const auto merged = sortRandom(chunked, count, runs);
+  if (runs != 9) {
+    log << "expected 9 temporary files, got " << runs << "\n";
+    return next_integer();
+  }
+
+  if (merged != sorted) {
+    log << "merging sorted chunks gave a different result\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test sorted SVG output.
+ * \test Draws two squares, the nearer one first, and makes sure that sorted
+ *       mode writes the further one first; then writes a torus in sorted mode
+ *       and makes sure that the output has the same size as the unsorted
+ *       output.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testSVG(std::ostream &log) {
+  geometry::transformation::affine<double, 3> transformation;
+  geometry::projection<double, 3> projection({{0, 0, 5}}, {{0, 0, 0}});
+  geometry::transformation::affine<double, 2> transformation2 =
+      geometry::transformation::scale<double, 2>(100);
+  geometry::transformation::projective<double, 2> projection2;
+  render::svg<double, 1> svg1;
+  render::svg<double, 2> svg2(transformation2, projection2, svg1);
+  render::svg<double, 3> svg(transformation, projection, svg2);
+
+  const auto square = [](double z) {
+    return std::array<math::vector<double, 3>, 4>{
+        {{{0, 0, z}}, {{1, 0, z}}, {{1, 1, z}}, {{0, 1, z}}}};
+  };
+
+  svg2.sorted = true;
+  svg.frameStart();
+
+  std::ostringstream near, far, both;
+  svg.draw(near, square(1));
+  svg.draw(far, square(-1));
+  if (!near.str().empty() || !far.str().empty() || svg2.layers.size() != 2) {
+    log << "sorted mode did not buffer polygons\n";
+    return next_integer();
+  }
+  svg2.layers.clear();
+
+  svg2.sorted = false;
+  svg.draw(near, square(1));
+  svg.draw(far, square(-1));
+  svg2.sorted = true;
+  svg.draw(both, square(1));
+  svg.draw(both, square(-1));
+  svg2.flush(both);
+
+  if (both.str() != far.str() + near.str()) {
+    log << "unexpected sorted output: " << both.str() << "\n";
+    return next_integer();
+  }
+
+  geometry::parameters<double> params;
+  params.precision = 30;
+  geometry::parametric<double, 2, geometry::formula::torus> torus(params);
+
+  std::size_t bytes = 0;
+  for (const bool sorted : {false, true}) {
+    svg2.sorted = sorted;
+    svg.frameStart();
+
+    std::ostringstream out;
+    out << svg << torus;
+
+    if (bytes != 0 && out.str().size() != bytes) {
+      log << "sorted output has " << out.str().size() << " bytes instead of "
+          << bytes << "\n";
+      return next_integer();
+    }
+    bytes = out.str().size();
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testSort, testSVG)
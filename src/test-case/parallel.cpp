@@ -0,0 +1,163 @@
+/**\file
+ * \brief Test cases for parallel mesh generation
+ *
+ * Test cases in this file make sure that skipping faces and generating meshes
+ * on multiple threads produce the same faces as plain iteration.
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <iostream>
+#include <vector>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/parallel.h>
+#include <ef.gy/parametric.h>
+#include <ef.gy/ifs.h>
+#include <ef.gy/flame.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Compare faces
+ *
+ * \tparam face The face type.
+ *
+ * \param[in] a The first face.
+ * \param[in] b The second face.
+ *
+ * \returns True if all the vertices of both faces are the same.
+ */
+template <class face> static bool equal(const face &a, const face &b) {
+  for (std::size_t v = 0; v < a.size(); v++) {
+    for (std::size_t j = 0; j < a[v].size(); j++) {
+      if (a[v][j] != b[v][j]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**\brief Get all faces of a model
+ *
+ * \tparam C The model type.
+ *
+ * \param[in] p The model to iterate over.
+ *
+ * \returns The faces of 'p', in iteration order.
+ */
+template <class C> static std::vector<typename C::face> sequential(C &p) {
+  std::vector<typename C::face> faces;
+  for (const auto &f : p) {
+    faces.push_back(f);
+  }
+  return faces;
+}
+
+/**\brief Test skipping faces.
+ * \test Skips to a number of faces of a model, both from the start and from
+ *       the middle of the mesh, and compares the results with the faces that
+ *       plain iteration produces.
+ *
+ * \tparam     C          The model.
+ * \tparam     iterations Number of iterations for IFS models.
+ * \param[out] log        A stream for test cases to log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+template <class C, unsigned int iterations = 3>
+int testSkip(std::ostream &log) {
+  auto params = geometry::parameters<double>();
+  params.iterations = iterations;
+  auto p = C(params, typename C::format());
+  const auto faces = sequential(p);
+
+  if (faces.size() != p.size()) {
+    log << p.id() << ": size() says " << p.size() << " faces, but got "
+        << faces.size() << "\n";
+    return next_integer();
+  }
+
+  const auto begin = p.begin();
+  for (std::size_t i = 0; i < faces.size(); i += 1 + faces.size() / 37) {
+    const auto it = geometry::skip(begin, i);
+    if (!equal(*it, faces[i])) {
+      log << p.id() << ": face " << i << " differs after skipping\n";
+      return next_integer();
+    }
+
+    const std::size_t j = (i + faces.size()) / 2;
+    if (!equal(*geometry::skip(it, j - i), faces[j])) {
+      log << p.id() << ": face " << j << " differs after skipping from face "
+          << i << "\n";
+      return next_integer();
+    }
+  }
+
+  if (geometry::skip(begin, faces.size()) != p.end()) {
+    log << p.id() << ": skipping all faces does not produce end()\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test parallel generation.
+ * \test Generates the mesh of a model with different numbers of threads, and
+ *       compares the output with the faces that plain iteration produces.
+ *
+ * \tparam     C          The model.
+ * \tparam     iterations Number of iterations for IFS models.
+ * \param[out] log        A stream for test cases to log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+template <class C, unsigned int iterations = 3>
+int testGenerate(std::ostream &log) {
+  auto params = geometry::parameters<double>();
+  params.iterations = iterations;
+  auto p = C(params, typename C::format());
+
+  const auto faces = sequential(p);
+
+  for (std::size_t threads : {1, 2, 3, 4, 7, 0}) {
+    std::vector<typename C::face> buffer(p.size());
+
+    const auto end = geometry::generate(p, buffer.begin(), threads);
+
+    if (end != buffer.end()) {
+      log << p.id() << ": " << threads << " threads did not fill the buffer\n";
+      return next_integer();
+    }
+
+    for (std::size_t i = 0; i < faces.size(); i++) {
+      if (!equal(buffer[i], faces[i])) {
+        log << p.id() << ": face " << i << " differs with " << threads
+            << " threads\n";
+        return next_integer();
+      }
+    }
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testSkip<geometry::cube<double, 4>>,
+           testSkip<geometry::plane<double, 2>>,
+           testSkip<geometry::parametric<double, 2, geometry::formula::torus>>,
+           testSkip<geometry::sierpinski::gasket<double, 2>>,
+           testSkip<geometry::sierpinski::carpet<double, 3>, 2>,
+           testSkip<geometry::flame::random<double, 2>, 2>,
+           testGenerate<geometry::cube<double, 5>>,
+           testGenerate<geometry::parametric<double, 3,
+                                             geometry::formula::sphere>>,
+           testGenerate<geometry::sierpinski::gasket<double, 3>, 4>,
+           testGenerate<geometry::sierpinski::carpet<double, 2>, 6>,
+           testGenerate<geometry::flame::random<double, 2>, 3>)
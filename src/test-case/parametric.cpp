@@ -0,0 +1,231 @@
+/**\file
+ * \brief Test cases for parametric.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <cmath>
+#include <iostream>
+#include <map>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/parametric.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Evaluation counter
+ *
+ * Number of times that the counting formula was evaluated.
+ */
+static std::size_t evaluations = 0;
+
+/**\brief Counting formula
+ *
+ * A torus that counts how often its coordinates are calculated.
+ */
+template <typename Q, std::size_t od>
+class countingTorus : public geometry::formula::torus<Q, od> {
+public:
+  static math::vector<Q, 3>
+  getCoordinates(const geometry::parameters<Q> &parameter,
+                 const math::vector<Q, od> &ve) {
+    evaluations++;
+    return geometry::formula::torus<Q, od>::getCoordinates(parameter, ve);
+  }
+};
+
+/**\brief Test grid mesh against the iterator.
+ * \test Creates the grid mesh of a model and makes sure that it evaluates
+ *       every grid point exactly once and that its indexed faces are the same
+ *       as the faces produced by the model's iterator.
+ *
+ * \tparam formula The formula to test.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+template <template <typename, std::size_t> class formula>
+int testGrid(std::ostream &log) {
+  using model = geometry::parametric<double, 2, formula>;
+
+  geometry::parameters<double> params;
+  params.precision = 7;
+  model m(params);
+
+  evaluations = 0;
+  const auto g = m.mesh();
+
+  std::size_t samples = 1;
+  for (const auto &s : g.samples) {
+    samples *= s;
+  }
+
+  if (g.vertices.size() != samples) {
+    log << model::id() << ": expected " << samples << " vertices, got "
+        << g.vertices.size() << "\n";
+    return next_integer();
+  }
+
+  if (evaluations != 0 && evaluations != samples) {
+    log << model::id() << ": " << evaluations << " evaluations for " << samples
+        << " grid points\n";
+    return next_integer();
+  }
+
+  if (g.faces.size() != m.size()) {
+    log << model::id() << ": expected " << m.size() << " faces, got "
+        << g.faces.size() << "\n";
+    return next_integer();
+  }
+
+  std::size_t i = 0;
+  for (const auto &f : m) {
+    for (std::size_t v = 0; v < f.size(); v++) {
+      const auto &p = g.vertices[g.faces[i][v]];
+      for (std::size_t j = 0; j < p.size(); j++) {
+        if (std::fabs(p[j] - f[v][j]) > 1e-9) {
+          log << model::id() << ": face " << i << " vertex " << v
+              << " differs from the iterator's\n";
+          return next_integer();
+        }
+      }
+    }
+    i++;
+  }
+
+  return 0;
+}
+
+/**\brief Test grid normals.
+ * \test Creates the grid mesh of a sphere and makes sure that, away from the
+ *       poles, its normals are unit vectors parallel to the position vectors.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testNormals(std::ostream &log) {
+  geometry::parameters<double> params;
+  params.precision = 24;
+  geometry::parametric<double, 2, geometry::formula::sphere> sphere(params);
+
+  const auto g = sphere.mesh();
+
+  if (g.normals.size() != g.vertices.size()) {
+    log << "expected one normal per vertex\n";
+    return next_integer();
+  }
+
+  std::size_t degenerate = 0;
+  for (std::size_t i = 0; i < g.vertices.size(); i++) {
+    const math::vector<double, 3> p = g.vertices[i];
+    const math::vector<double, 3> n = g.normals[i];
+    const double l = math::length(p);
+    if (math::lengthSquared(n) == 0) {
+      degenerate++;
+      continue;
+    }
+    if (std::fabs(std::fabs(p * n) / l - 1) > 1e-2) {
+      log << "normal at vertex " << i << " is not radial: " << (p * n) / l
+          << "\n";
+      return next_integer();
+    }
+  }
+
+  if (degenerate > 2 * g.samples[0]) {
+    log << degenerate << " vertices without a normal; only the "
+        << 2 * g.samples[0] << " at the poles should be degenerate\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test adaptive tessellation.
+ * \test Tessellates a plane, which should not need any refinement, and a
+ *       torus, which should become a closed mesh where every edge is shared by
+ *       exactly two consistently oriented triangles. Also makes sure that the
+ *       torus gets finer with a lower tolerance, and logs how many vertices it
+ *       has compared to a uniform grid of the finest cells used.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testAdaptive(std::ostream &log) {
+  geometry::parameters<double> params;
+  params.precision = 2;
+
+  geometry::parametric<double, 2, geometry::formula::plane> plane(params);
+  const auto flat = plane.tessellate(1e-3);
+  if (flat.faces.size() != 2 * plane.size() ||
+      flat.vertices.size() != 9) {
+    log << "plane was refined: " << flat.faces.size() << " faces, "
+        << flat.vertices.size() << " vertices\n";
+    return next_integer();
+  }
+
+  geometry::parametric<double, 2, geometry::formula::torus> torus(params);
+  std::size_t previous = 0;
+
+  for (const double tolerance : {1e-1, 1e-2, 1e-3}) {
+    const auto m = torus.tessellate(tolerance);
+
+    std::map<std::pair<std::size_t, std::size_t>, std::size_t> edges;
+    for (const auto &f : m.faces) {
+      for (std::size_t k = 0; k < 3; k++) {
+        edges[{f[k], f[(k + 1) % 3]}]++;
+      }
+    }
+
+    for (const auto &e : edges) {
+      const auto reverse = edges.find({e.first.second, e.first.first});
+      if (e.second != 1 || reverse == edges.end() || reverse->second != 1) {
+        log << "torus mesh at " << tolerance << " has a crack or a bad edge at "
+            << e.first.first << "-" << e.first.second << "\n";
+        return next_integer();
+      }
+    }
+
+    if (m.vertices.size() <= previous) {
+      log << "torus at " << tolerance << " has no more vertices than at a "
+          << "higher tolerance: " << m.vertices.size() << "\n";
+      return next_integer();
+    }
+    previous = m.vertices.size();
+
+    geometry::parameters<double> uniform = params;
+    double shortest = 1e300;
+    for (const auto &f : m.faces) {
+      for (std::size_t k = 0; k < 3; k++) {
+        const auto d = math::vector<double, 3>(m.vertices[f[k]]) -
+                       math::vector<double, 3>(m.vertices[f[(k + 1) % 3]]);
+        shortest = std::min(shortest, math::length(d));
+      }
+    }
+    uniform.precision = std::ceil(M_PI * (params.radius - params.radius2) /
+                                  shortest);
+
+    log << "torus at " << tolerance << ": " << m.vertices.size()
+        << " vertices, " << m.faces.size() << " triangles; a uniform grid of "
+        << "the smallest cells has "
+        << geometry::parametric<double, 2, geometry::formula::torus>(uniform)
+               .mesh()
+               .vertices.size()
+        << " vertices\n";
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testGrid<countingTorus>, testGrid<geometry::formula::sphere>,
+           testGrid<geometry::formula::moebiusStrip>, testNormals,
+           testAdaptive)
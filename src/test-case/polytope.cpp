@@ -13,6 +13,7 @@
  * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
  */
 
+#include <cmath>
 #include <iostream>
 #include <string>
 
@@ -77,6 +78,53 @@ int testPolytopeIteratorNotInfinite(std::ostream &log) {
   return 0;
 }
 
+/**\brief Test case for IFS composition.
+ * \test Iterates through an IFS and compares the result with applying the
+ *       functions of the IFS to the base primitive one at a time.
+ *
+ * \tparam     C          The IFS.
+ * \tparam     iterations Number of iterations for the IFS.
+ * \param[out] log        A stream for test cases to log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+template<class C, std::size_t iterations>
+int testIFSComposition(std::ostream &log) {
+  auto params = geometry::parameters<double>();
+  params.iterations = iterations;
+
+  const auto p = C(params, typename C::format());
+  const auto functions = C::generator::functions(params);
+  typename C::basePrimitive base(params, typename C::format());
+
+  auto it = p.begin();
+  for (std::size_t n = 0; n < std::pow(functions.size(), iterations); n++) {
+    for (const auto &f : base) {
+      const auto g = *it;
+      for (std::size_t v = 0; v < f.size(); v++) {
+        auto e = f[v];
+        for (std::size_t i = 0; i < iterations; i++) {
+          std::size_t m = n;
+          for (std::size_t j = i + 1; j < iterations; j++) {
+            m /= functions.size();
+          }
+          e = functions[m % functions.size()] * e;
+        }
+        for (std::size_t j = 0; j < e.size(); j++) {
+          if (std::fabs(e[j] - g[v][j]) > 1e-9) {
+            log << "vertex " << v << " of face " << n << " differs: " << g[v][j]
+                << " vs. expected: " << e[j] << "\n";
+            return -1;
+          }
+        }
+      }
+      ++it;
+    }
+  }
+
+  return 0;
+}
+
 TEST_BATCH(
     testPolytopeIteratorNotInfinite<geometry::cube<float,2>, 1, 1>,
     testPolytopeIteratorNotInfinite<geometry::cube<float,3>, 6, 6>,
@@ -109,4 +157,9 @@ TEST_BATCH(
         geometry::adapt<float, 5,
             geometry::sierpinski::gasket<float,3>,
             math::format::cartesian>>,
+
+    testIFSComposition<geometry::sierpinski::gasket<double,2>, 4>,
+    testIFSComposition<geometry::sierpinski::gasket<double,2>, 8>,
+    testIFSComposition<geometry::sierpinski::gasket<double,3>, 6>,
+    testIFSComposition<geometry::sierpinski::carpet<double,2>, 5>,
     )
@@ -0,0 +1,116 @@
+/**\file
+ * \brief Test cases for prng.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <iostream>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/prng.h>
+#include <ef.gy/flame.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Test SplitMix64 output.
+ * \test Compares the first numbers of the generator with those of the
+ *       reference implementation, and makes sure that skipping ahead and
+ *       uniform numbers work as expected.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testSplitMix(std::ostream &log) {
+  prng::splitmix rng;
+  const std::uint64_t expected[] = {0xe220a8397b1dcdafull,
+                                    0x6e789e6aa1b965f4ull,
+                                    0x06c45d188009454full};
+
+  for (const auto &e : expected) {
+    const auto v = rng();
+    if (v != e) {
+      log << "unexpected output: " << std::hex << v << " vs. expected " << e
+          << "\n";
+      return next_integer();
+    }
+  }
+
+  prng::splitmix skip;
+  skip.discard(2);
+  if (skip() != expected[2]) {
+    log << "discard() did not skip ahead properly\n";
+    return next_integer();
+  }
+
+  prng::splitmix a = rng.stream(1), b = rng.stream(2);
+  if (a() == b()) {
+    log << "different streams produced the same number\n";
+    return next_integer();
+  }
+
+  for (int i = 0; i < 10000; i++) {
+    const double d = rng.uniform<double>();
+    const float f = rng.uniform<float>();
+    if (d < 0 || d >= 1 || f < 0 || f >= 1) {
+      log << "uniform number out of range: " << d << ", " << f << "\n";
+      return next_integer();
+    }
+  }
+
+  return 0;
+}
+
+/**\brief Test flame reproducibility.
+ * \test Applies a fractal flame transformation with the julia variation, whose
+ *       result depends on a random number, and makes sure that the same input
+ *       and generator state always produce the same result.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testFlame(std::ostream &log) {
+  geometry::transformation::flame<double, 2> f;
+  for (auto &c : f.coefficient) {
+    c = 0;
+  }
+  f.coefficient[13] = 1;
+
+  const math::vector<double, 2> v{{0.3, -0.7}};
+
+  if ((f * v) != (f * v)) {
+    log << "flame results differ for the same input\n";
+    return next_integer();
+  }
+
+  bool flipped = false;
+  prng::splitmix a(5), b(5);
+  for (int i = 0; i < 16; i++) {
+    const auto p = f(v, a);
+    const auto q = f(v, b);
+    if (p != q) {
+      log << "flame results differ for the same generator state\n";
+      return next_integer();
+    }
+    const auto r = f(v, a);
+    b.discard(f.randomNumbers);
+    flipped = flipped || (p[0] != r[0]);
+  }
+
+  if (!flipped) {
+    log << "julia variation never picked the second branch\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testSplitMix, testFlame)
@@ -0,0 +1,191 @@
+/**\file
+ * \brief Test cases for projection.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/render-svg.h>
+#include <ef.gy/prng.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Projection chain
+ *
+ * An SVG renderer for d dimensions with all of its lower renderers, the
+ * transformations and projections they use, and the original way of
+ * projecting points one level at a time to compare the renderer with.
+ *
+ * \tparam d Number of dimensions of the top level.
+ */
+template <unsigned int d> class chain {
+public:
+  chain(void)
+      : projection(eye(), math::vector<double, d>()),
+        renderer(transformation, projection, lower.renderer) {
+    transformation = geometry::transformation::translation<double, d>(shift());
+    combined = transformation * projection;
+  }
+
+  /**\brief Project point one level at a time
+   *
+   * \param[in] v The point to project.
+   *
+   * \returns The point in SVG coordinates.
+   */
+  math::vector<double, 2> operator()(const math::vector<double, d> &v) const {
+    return lower(combined * v);
+  }
+
+  /**\brief Eye position
+   *
+   * \returns The position of the eye for this level.
+   */
+  static math::vector<double, d> eye(void) {
+    math::vector<double, d> r;
+    for (unsigned int i = 0; i < d; i++) {
+      r[i] = 2.5 + 0.5 * i;
+    }
+    return r;
+  }
+
+  /**\brief Translation
+   *
+   * \returns The translation that is applied before the projection.
+   */
+  static math::vector<double, d> shift(void) {
+    math::vector<double, d> r;
+    r[0] = 0.1;
+    r[d - 1] = -0.2;
+    return r;
+  }
+
+  geometry::transformation::affine<double, d> transformation;
+  geometry::projection<double, d> projection;
+  geometry::transformation::projective<double, d> combined;
+  chain<d - 1> lower;
+  render::svg<double, d> renderer;
+};
+
+/**\brief 2D projection chain
+ *
+ * The end of the chain, which only scales and moves points.
+ */
+template <> class chain<2> {
+public:
+  chain(void) : renderer(transformation, projection, lower) {
+    transformation = geometry::transformation::scale<double, 2>(100) *
+                     geometry::transformation::translation<double, 2>(
+                         math::vector<double, 2>{{1, 2}});
+  }
+
+  /**\copydoc chain::operator() */
+  math::vector<double, 2> operator()(const math::vector<double, 2> &v) const {
+    return transformation * v;
+  }
+
+  geometry::transformation::affine<double, 2> transformation;
+  geometry::transformation::projective<double, 2> projection;
+  render::svg<double, 1> lower;
+  render::svg<double, 2> renderer;
+};
+
+/**\brief Random point
+ *
+ * \tparam d Number of dimensions of the point.
+ *
+ * \param[in] rng The random number generator to use.
+ *
+ * \returns A point with all coordinates in [-1,1).
+ */
+template <unsigned int d>
+math::vector<double, d> randomPoint(prng::splitmix &rng) {
+  math::vector<double, d> v;
+  for (unsigned int i = 0; i < d; i++) {
+    v[i] = rng.uniform<double>() * 2 - 1;
+  }
+  return v;
+}
+
+/**\brief Test flattened projection.
+ * \test Composes the projection pipeline of a chain of SVG renderers and
+ *       makes sure that it projects random points around the origin to the
+ *       same positions as projecting them one level at a time, that points
+ *       behind the eye are rejected and that the renderer draws the same
+ *       polygons as before.
+ *
+ * \tparam d Number of dimensions to project from.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+template <unsigned int d> int testPipeline(std::ostream &log) {
+  chain<d> c;
+  c.renderer.frameStart();
+
+  geometry::pipeline<double, d, 2> pipeline;
+  c.renderer.compose(pipeline,
+                     geometry::transformation::affine<double, d>().matrix);
+
+  prng::splitmix rng(d);
+  for (std::size_t n = 0; n < 1000; n++) {
+    const auto v = randomPoint<d>(rng);
+    const auto expected = c(v);
+    math::vector<double, 2> out;
+
+    if (!pipeline(v, out)) {
+      log << d << "D: point " << n << " was rejected\n";
+      return next_integer();
+    }
+
+    for (unsigned int i = 0; i < 2; i++) {
+      if (std::fabs(out[i] - expected[i]) >
+          1e-9 * (1 + std::fabs(expected[i]))) {
+        log << d << "D: point " << n << " projected to " << out[i]
+            << " instead of " << expected[i] << "\n";
+        return next_integer();
+      }
+    }
+  }
+
+  math::vector<double, 2> out;
+  const math::vector<double, d> behind = chain<d>::eye() * 2.0;
+  if (pipeline(behind, out)) {
+    log << d << "D: point behind the eye was not rejected\n";
+    return next_integer();
+  }
+
+  std::array<math::vector<double, d>, 3> face;
+  std::array<math::vector<double, 2>, 3> projected;
+  for (std::size_t i = 0; i < face.size(); i++) {
+    face[i] = randomPoint<d>(rng);
+    projected[i] = c(face[i]);
+  }
+
+  c.renderer.base().encoder.precision(3);
+  std::ostringstream fused, chained;
+  c.renderer.draw(fused, face);
+  c.renderer.base().path(chained, projected);
+  if (fused.str() != chained.str()) {
+    log << d << "D: drew " << fused.str() << " instead of " << chained.str()
+        << "\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testPipeline<3>, testPipeline<4>, testPipeline<5>, testPipeline<7>)
@@ -0,0 +1,248 @@
+/**\file
+ * \brief Test cases for the chaos game renderer
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/render-flame.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Test chaos game histogram.
+ * \test Renders a Sierpinski gasket, which fits inside the default view, with
+ *       different numbers of threads, and makes sure that every sample ends up
+ *       in the histogram, that the results do not depend on the number of
+ *       threads and that the densest pixel is fully opaque.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testGasket(std::ostream &log) {
+  using renderer =
+      render::chaosGame<double, 2, geometry::transformation::affine<double, 2>>;
+
+  geometry::parameters<double> params;
+  const auto functions =
+      geometry::generators::gasket<double, 2, 2>::functions(params);
+  const std::vector<renderer::colour> palette{
+      {{1, 0, 0}}, {{0, 1, 0}}, {{0, 0, 1}}};
+  constexpr unsigned long long samples = 300000;
+
+  renderer reference(64, 48, functions, palette);
+  reference(samples, 1, 1);
+  reference(samples / 3, 2, 1);
+  const auto image = reference.rgba();
+
+  for (std::size_t threads : {2, 3, 8}) {
+    renderer r(64, 48, functions, palette);
+    r(samples, 1, threads);
+    r(samples / 3, 2, threads);
+
+    unsigned long long total = 0;
+    for (const auto &bin : r.histogram()) {
+      total += bin.count;
+    }
+
+    if (total != samples + samples / 3) {
+      log << "expected " << samples + samples / 3
+          << " samples in the histogram with " << threads
+          << " threads, but got " << total << "\n";
+      return next_integer();
+    }
+
+    if (r.rgba() != image) {
+      log << "render with " << threads
+          << " threads differs from the single threaded one\n";
+      return next_integer();
+    }
+  }
+
+  std::uint8_t opaque = 0;
+  for (std::size_t i = 3; i < image.size(); i += 4) {
+    opaque = std::max(opaque, image[i]);
+  }
+
+  if (opaque != 255) {
+    log << "densest pixel should be opaque, but alpha is " << int(opaque)
+        << "\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test fractal flame rendering.
+ * \test Renders a random fractal flame and makes sure that no more samples
+ *       than requested end up in the histogram.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testFlame(std::ostream &log) {
+  using renderer = render::chaosGame<double, 2>;
+
+  geometry::parameters<double> params;
+  const auto functions =
+      geometry::generators::randomFlame<double, 2, 2>::functions(params);
+  const std::vector<renderer::colour> palette{
+      {{1, .5, 0}}, {{.2, .2, 1}}, {{1, 1, 1}}, {{0, 1, .5}}};
+  constexpr unsigned long long samples = 100000;
+
+  renderer r(256, 256, functions, palette);
+  r(samples);
+
+  unsigned long long total = 0;
+  for (const auto &bin : r.histogram()) {
+    total += bin.count;
+  }
+
+  if (total > samples) {
+    log << "histogram has more samples than were plotted: " << total << "\n";
+    return next_integer();
+  }
+
+  if (r.rgba().size() != 256 * 256 * 4) {
+    log << "unexpected image size\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Test divergent flames.
+ * \test Renders a flame whose only function sends every point to infinity,
+ *       which must return instead of restarting the random walk forever, and
+ *       makes sure that nothing was plotted.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testDivergent(std::ostream &log) {
+  using renderer =
+      render::chaosGame<double, 2, geometry::transformation::affine<double, 2>>;
+
+  geometry::transformation::affine<double, 2> blowup;
+  blowup.matrix[0][0] = 1e300;
+  blowup.matrix[1][1] = 1e300;
+
+  renderer r(16, 16, {blowup}, {{{1, 1, 1}}});
+  r(1000, 1, 2);
+
+  for (const auto &bin : r.histogram()) {
+    if (bin.count != 0) {
+      log << "divergent flame plotted a sample\n";
+      return next_integer();
+    }
+  }
+
+  return 0;
+}
+
+/**\brief Post process pixel
+ *
+ * Calculates a pixel the way the fractal flame paper describes it, with the
+ * intensity and colour map lookup of the OpenGL renderer's shader.
+ *
+ * \param[in] post  The post processing settings to use.
+ * \param[in] sum   Index sum of the pixel.
+ * \param[in] count Number of faces of the pixel.
+ *
+ * \returns The colour of the pixel.
+ */
+static std::array<double, 3> reference(const render::postProcess &post,
+                                       double sum, double count) {
+  if (count <= 0) {
+    return {{0, 0, 0}};
+  }
+
+  const double a = 1 - 1 / std::log2(count + 2);
+  const double u = std::min(
+      std::max(std::min(std::max(sum / count, 0.), 1.) *
+                       double(post.colourMap.size()) -
+                   .5,
+               0.),
+      double(post.colourMap.size() - 1));
+  const std::size_t i = std::size_t(u);
+  const std::size_t j = std::min(i + 1, post.colourMap.size() - 1);
+
+  std::array<double, 3> rv;
+  for (std::size_t k = 0; k < 3; k++) {
+    const double c = post.colourMap[i][k] * (1 - (u - double(i))) +
+                     post.colourMap[j][k] * (u - double(i));
+    rv[k] = post.vibrancy * c * std::pow(a, 1 / post.gamma) +
+            (1 - post.vibrancy) * std::pow(c * a, 1 / post.gamma);
+  }
+  return rv;
+}
+
+/**\brief Test fractal flame post processing.
+ * \test Post processes random accumulation buffers with different gamma and
+ *       vibrancy settings, compares the result with a straightforward
+ *       calculation and makes sure that it does not depend on the number of
+ *       threads.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testPostProcess(std::ostream &log) {
+  constexpr std::size_t width = 301, height = 203;
+
+  prng::splitmix rng(7);
+  std::vector<float> sum(width * height), count(width * height);
+  for (std::size_t i = 0; i < sum.size(); i++) {
+    count[i] = i % 5 == 0 ? 0.f : float(rng() % (1 << (i % 17)));
+    sum[i] = count[i] * rng.uniform<float>();
+  }
+
+  render::postProcess post(1);
+  post.setColourMap(3);
+
+  for (const auto &setting : std::vector<std::array<float, 2>>{
+           {{1, 1}}, {{2.2f, 1}}, {{2.2f, 0}}, {{.5f, .3f}}}) {
+    post.gamma = setting[0];
+    post.vibrancy = setting[1];
+    post.threads = 1;
+    const auto image = post(sum, count, width, height);
+
+    for (std::size_t i = 0; i < sum.size(); i++) {
+      const auto c = reference(post, sum[i], count[i]);
+      for (std::size_t k = 0; k < 4; k++) {
+        const int expected =
+            k < 3 ? int(std::min(std::max(c[k], 0.), 1.) * 255 + .5) : 255;
+        if (std::abs(int(image[i * 4 + k]) - expected) > 1) {
+          log << "pixel " << i << " with gamma " << post.gamma
+              << " and vibrancy " << post.vibrancy << " has channel " << k
+              << " " << int(image[i * 4 + k]) << " instead of " << expected
+              << "\n";
+          return next_integer();
+        }
+      }
+    }
+
+    post.threads = 3;
+    if (post(sum, count, width, height) != image) {
+      log << "post processing with 3 threads gave a different image\n";
+      return next_integer();
+    }
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testGasket, testFlame, testDivergent, testPostProcess)
@@ -0,0 +1,358 @@
+/**\file
+ * \brief Test cases for render-raster.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/parametric.h>
+#include <ef.gy/render-raster.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief 8-bit channel value
+ *
+ * \param[in] v A channel value in [0,1].
+ *
+ * \returns The value the rasteriser writes for v.
+ */
+static unsigned int channel(double v) { return (unsigned int)(v * 255 + 0.5); }
+
+/**\brief Test polygon coverage.
+ * \test Draws a square over one quarter of an image and makes sure that
+ *       exactly the pixels in that quarter are covered, then draws a square
+ *       split into two translucent triangles and makes sure that the pixels
+ *       on the shared edge are only drawn once.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testCoverage(std::ostream &log) {
+  geometry::transformation::affine<double, 2> transformation;
+  geometry::transformation::projective<double, 2> projection;
+  render::raster<double, 1> raster1;
+  render::raster<double, 2> raster(transformation, projection, raster1, 40,
+                                   24);
+
+  const unsigned int lit = channel(1 / std::sqrt(2.));
+
+  raster.threads = 3;
+  raster.frameStart();
+  raster.draw(std::array<math::vector<double, 2>, 4>{
+      {{{-1, -1}}, {{0, -1}}, {{0, 0}}, {{-1, 0}}}});
+  raster.frameEnd();
+
+  auto image = raster.rgba();
+  for (std::size_t y = 0; y < raster.height; y++) {
+    for (std::size_t x = 0; x < raster.width; x++) {
+      const bool inside = x < raster.width / 2 && y >= raster.height / 2;
+      const auto *p = &image[(y * raster.width + x) * 4];
+      if (p[0] != (inside ? lit : 0) || p[1] != p[0] || p[2] != p[0] ||
+          p[3] != 255) {
+        log << "unexpected pixel at " << x << ", " << y << ": "
+            << (unsigned int)p[0] << "\n";
+        return next_integer();
+      }
+    }
+  }
+
+  raster.surfaceColour = {{1, 1, 1, 0.5}};
+  raster.frameStart();
+  raster.draw(std::array<math::vector<double, 2>, 3>{
+      {{{-1, -1}}, {{1, -1}}, {{1, 1}}}});
+  raster.draw(std::array<math::vector<double, 2>, 3>{
+      {{{-1, -1}}, {{1, 1}}, {{-1, 1}}}});
+  raster.frameEnd();
+
+  image = raster.rgba();
+  const unsigned int half = channel(0.5 / std::sqrt(2.));
+  for (std::size_t i = 0; i < image.size(); i += 4) {
+    if (image[i] != half) {
+      log << "pixel " << i / 4 << " covered " << (unsigned int)image[i]
+          << " instead of " << half << "\n";
+      return next_integer();
+    }
+  }
+
+  return 0;
+}
+
+/**\brief Test huge triangles.
+ * \test Draws a triangle with a vertex far outside the range of size_t, as
+ *       happens for faces right in front of the eye, and makes sure that it
+ *       covers the whole image.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testHuge(std::ostream &log) {
+  geometry::transformation::affine<double, 2> transformation;
+  geometry::transformation::projective<double, 2> projection;
+  render::raster<double, 1> raster1;
+  render::raster<double, 2> raster(transformation, projection, raster1, 40,
+                                   24);
+
+  raster.frameStart();
+  raster.draw(std::array<math::vector<double, 2>, 3>{
+      {{{-2, -2}}, {{1e25, -2}}, {{-2, 1e25}}}});
+  raster.frameEnd();
+
+  const auto image = raster.rgba();
+  for (std::size_t i = 0; i < image.size(); i += 4) {
+    if (image[i] == 0) {
+      log << "pixel " << i / 4 << " not covered by a huge triangle\n";
+      return next_integer();
+    }
+  }
+
+  return 0;
+}
+
+/**\brief Test depth buffer.
+ * \test Draws two squares in 3D, one in front of the other, in both orders
+ *       and makes sure that the one in front is visible either way; also
+ *       makes sure that squares behind the eye are counted and not drawn.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testDepth(std::ostream &log) {
+  geometry::transformation::affine<double, 3> transformation;
+  geometry::projection<double, 3> projection({{0, 0, 5}}, {{0, 0, 0}});
+  geometry::transformation::affine<double, 2> transformation2;
+  geometry::transformation::projective<double, 2> projection2;
+  render::raster<double, 1> raster1;
+  render::raster<double, 2> raster2(transformation2, projection2, raster1, 32,
+                                    32);
+  render::raster<double, 3> raster(transformation, projection, raster2);
+
+  const auto square = [](double z) {
+    return std::array<math::vector<double, 3>, 4>{
+        {{{-1, -1, z}}, {{1, -1, z}}, {{1, 1, z}}, {{-1, 1, z}}}};
+  };
+  const render::raster<double, 2>::colour red{{1, 0, 0, 1}},
+      green{{0, 1, 0, 1}};
+
+  for (const bool nearFirst : {true, false}) {
+    raster.frameStart();
+    for (const bool near : {nearFirst, !nearFirst}) {
+      raster2.surfaceColour = near ? red : green;
+      raster.draw(square(near ? 1 : -1));
+    }
+    raster.draw(square(7));
+    raster.frameEnd();
+
+    const auto image = raster2.rgba();
+    const auto *p = &image[(16 * raster2.width + 16) * 4];
+    if (p[0] == 0 || p[1] != 0) {
+      log << "square in the back is visible when drawn "
+          << (nearFirst ? "second" : "first") << "\n";
+      return next_integer();
+    }
+
+    if (raster2.cull.behind != 1 || raster2.cull.emitted != 2) {
+      log << "unexpected statistics: " << raster2.cull.emitted << " emitted, "
+          << raster2.cull.behind << " behind\n";
+      return next_integer();
+    }
+  }
+
+  return 0;
+}
+
+/**\brief Test fractal flame colouring.
+ * \test Makes sure that setColourMap() creates the same colour map as that of
+ *       the post processing stage with the same seed, then draws two
+ *       overlapping squares with fractal flame colouring and a single-colour
+ *       map and makes sure that the intensity of each pixel depends on the
+ *       number of squares that cover it.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testFlame(std::ostream &log) {
+  geometry::transformation::affine<double, 2> transformation;
+  geometry::transformation::projective<double, 2> projection;
+  render::raster<double, 1> raster1;
+  render::raster<double, 2> raster(transformation, projection, raster1, 16,
+                                   16);
+
+  render::postProcess post;
+  post.setColourMap(42);
+  raster.setColourMap(42);
+  if (raster.colourMap != post.colourMap) {
+    log << "colour map differs from that of the post processing stage\n";
+    return next_integer();
+  }
+
+  raster.fractalFlameColouring = true;
+  raster.colourMap = {{{1, 1, 1}}};
+  raster.frameStart();
+  raster.draw(std::array<math::vector<double, 2>, 4>{
+                  {{{-1, -1}}, {{0.5, -1}}, {{0.5, 1}}, {{-1, 1}}}},
+              0.2);
+  raster.draw(std::array<math::vector<double, 2>, 4>{
+                  {{{-0.5, -1}}, {{1, -1}}, {{1, 1}}, {{-0.5, 1}}}},
+              0.8);
+  raster.frameEnd();
+
+  const auto image = raster.rgba();
+  const unsigned int once = channel(1 - 1 / std::log2(3.));
+  const unsigned int twice = channel(1 - 1 / std::log2(4.));
+  for (std::size_t x = 0; x < raster.width; x++) {
+    const unsigned int expected = (x < 4 || x >= 12) ? once : twice;
+    if (image[(8 * raster.width + x) * 4] != expected) {
+      log << "pixel " << x << " has intensity "
+          << (unsigned int)image[(8 * raster.width + x) * 4] << " instead of "
+          << expected << "\n";
+      return next_integer();
+    }
+  }
+
+  return 0;
+}
+
+/**\brief Test image output.
+ * \test Writes an image as PPM and PAM and makes sure the headers and sizes
+ *       are right.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testImage(std::ostream &log) {
+  geometry::transformation::affine<double, 2> transformation;
+  geometry::transformation::projective<double, 2> projection;
+  render::raster<double, 1> raster1;
+  render::raster<double, 2> raster(transformation, projection, raster1, 70,
+                                   3);
+
+  raster.background = {{0.2, 0.4, 0.6, 1}};
+  raster.frameStart();
+  raster.frameEnd();
+
+  std::ostringstream ppm, pam;
+  raster.ppm(ppm);
+  raster.pam(pam);
+
+  const std::string ppmHeader = "P6\n70 3\n255\n";
+  const std::string pamHeader = "P7\nWIDTH 70\nHEIGHT 3\nDEPTH 4\nMAXVAL "
+                                "255\nTUPLTYPE RGB_ALPHA\nENDHDR\n";
+
+  if (ppm.str().substr(0, ppmHeader.size()) != ppmHeader ||
+      ppm.str().size() != ppmHeader.size() + 70 * 3 * 3) {
+    log << "unexpected PPM output\n";
+    return next_integer();
+  }
+
+  if (pam.str().substr(0, pamHeader.size()) != pamHeader ||
+      pam.str().size() != pamHeader.size() + 70 * 3 * 4) {
+    log << "unexpected PAM output\n";
+    return next_integer();
+  }
+
+  const std::string pixel = ppm.str().substr(ppmHeader.size(), 3);
+  if ((unsigned char)pixel[0] != channel(0.2) ||
+      (unsigned char)pixel[1] != channel(0.4) ||
+      (unsigned char)pixel[2] != channel(0.6)) {
+    log << "unexpected background colour\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/**\brief Rasterise model
+ *
+ * Renders a model into an image.
+ *
+ * \tparam model The type of the model to render.
+ *
+ * \param[in] render The renderer to use.
+ * \param[in] poly   The model to render.
+ *
+ * \returns The number of faces that were rasterised.
+ */
+template <typename model>
+static std::size_t rasterise(render::raster<double, 3> &render, model &poly) {
+  render.frameStart();
+  for (const auto &p : poly) {
+    std::array<math::vector<double, 3>, model::faceVertices> q;
+    for (std::size_t i = 0; i < model::faceVertices; i++) {
+      q[i] = p[i];
+    }
+    render.draw(q);
+  }
+  render.frameEnd();
+
+  return render.base().cull.emitted;
+}
+
+/**\brief Test rasterising models.
+ * \test Renders a torus and a sphere at increasing precisions and makes sure
+ *       that they cover part of the image.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testModels(std::ostream &log) {
+  geometry::transformation::affine<double, 3> transformation;
+  geometry::projection<double, 3> projection({{1, 2, 5}}, {{0, 0, 0}});
+  geometry::transformation::affine<double, 2> transformation2;
+  geometry::transformation::projective<double, 2> projection2;
+  render::raster<double, 1> raster1;
+  render::raster<double, 2> raster2(transformation2, projection2, raster1,
+                                    640, 480);
+  render::raster<double, 3> raster(transformation, projection, raster2);
+
+  for (const unsigned int precision : {8, 64}) {
+    geometry::parameters<double> params;
+    params.precision = precision;
+    geometry::parametric<double, 2, geometry::formula::torus> torus(params);
+    geometry::parametric<double, 2, geometry::formula::sphere> sphere(params);
+
+    for (const bool flame : {false, true}) {
+      raster2.fractalFlameColouring = flame;
+
+      for (const std::size_t faces :
+           {rasterise(raster, torus), rasterise(raster, sphere)}) {
+        if (faces == 0) {
+          log << "no faces rasterised\n";
+          return next_integer();
+        }
+      }
+
+      std::size_t covered = 0;
+      const auto image = raster2.rgba();
+      for (std::size_t i = 0; i < image.size(); i += 4) {
+        covered += image[i] != 0 || image[i + 1] != 0 || image[i + 2] != 0;
+      }
+      if (covered == 0 || covered == image.size() / 4) {
+        log << "unexpected coverage: " << covered << " pixels\n";
+        return next_integer();
+      }
+    }
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testCoverage, testHuge, testDepth, testFlame, testImage,
+           testModels)
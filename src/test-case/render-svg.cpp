@@ -0,0 +1,121 @@
+/**\file
+ * \brief Test cases for render-svg.h
+ *
+ * \copyright
+ * This file is part of the libefgy project, which is released as open source
+ * under the terms of an MIT/X11-style licence, described in the COPYING file.
+ *
+ * \see Project Documentation: https://ef.gy/documentation/libefgy
+ * \see Project Source Code: https://github.com/ef-gy/libefgy
+ * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
+ */
+
+#include <iostream>
+#include <sstream>
+
+#include <ef.gy/test-case.h>
+#include <ef.gy/render-svg.h>
+#include <ef.gy/prng.h>
+
+using namespace efgy;
+using efgy::test::next_integer;
+
+/**\brief Test SVG path encoding.
+ * \test Encodes a few paths, with and without rounding, and compares them to
+ *       the expected path data.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testPath(std::ostream &log) {
+  render::svgPath path;
+
+  const struct {
+    int decimals;
+    std::vector<std::array<double, 2>> points;
+    const char *expected;
+  } tests[] = {
+      {-1, {{{0, 0}}, {{10, 0}}, {{10, 10}}, {{0, 10}}}, "M0,0H10V10H0Z"},
+      {-1, {{{100, 100}}, {{100.5, 101}}, {{1, 2}}}, "M100,100l0.5,1L1,2Z"},
+      {2, {{{0.004, -0.006}}, {{1.234, 5.678}}}, "M0,-0.01L1.23,5.68Z"},
+      {1, {{{100.1, 100.1}}, {{100.2, 100.3}}}, "M100.1,100.1l0.1,0.2Z"},
+      {0, {{{1, 1}}, {{1.2, 0.8}}, {{2, 2}}}, "M1,1L2,2Z"},
+      {3, {{{-0.0004, 12.5}}, {{250, 12.5}}}, "M0,12.5H250Z"},
+  };
+
+  for (const auto &t : tests) {
+    path.precision(t.decimals);
+    path.clear();
+    for (std::size_t i = 0; i < t.points.size(); i++) {
+      if (i == 0) {
+        path.moveTo(t.points[i][0], t.points[i][1]);
+      } else {
+        path.lineTo(t.points[i][0], t.points[i][1]);
+      }
+    }
+    path.close();
+
+    if (path.str() != t.expected) {
+      log << "unexpected path data: '" << path.str() << "', expected '"
+          << t.expected << "'\n";
+      return next_integer();
+    }
+  }
+
+  return 0;
+}
+
+/**\brief Test SVG polygon output.
+ * \test Draws a square with the 2D renderer, makes sure that the output is the
+ *       expected path element, and that rounding random triangles to two
+ *       decimals makes the output smaller.
+ *
+ * \param[out] log A stream to copy log messages to.
+ *
+ * \return Zero when everything went as expected, nonzero otherwise.
+ */
+int testDraw(std::ostream &log) {
+  geometry::transformation::affine<double, 2> transformation;
+  geometry::transformation::projective<double, 2> projection;
+  render::svg<double, 1> lower;
+  render::svg<double, 2> svg(transformation, projection, lower);
+
+  std::ostringstream out;
+  svg.draw(out, std::array<math::vector<double, 2>, 4>{
+                    {{{0, 0}}, {{1, 0}}, {{1, 1}}, {{0, 1}}}});
+
+  if (out.str() != "<path d='M0,0H1V-1H0Z'/>") {
+    log << "unexpected SVG output: " << out.str() << "\n";
+    return next_integer();
+  }
+
+  prng::splitmix rng(1);
+  std::vector<std::array<math::vector<double, 2>, 3>> triangles(100);
+  for (auto &t : triangles) {
+    for (auto &v : t) {
+      v[0] = rng.uniform<double>() * 1000;
+      v[1] = rng.uniform<double>() * 1000;
+    }
+  }
+
+  std::size_t bytes[2];
+  for (const int decimals : {-1, 2}) {
+    std::ostringstream output;
+    svg.encoder.precision(decimals);
+    for (const auto &t : triangles) {
+      svg.draw(output, t);
+    }
+    bytes[decimals < 0 ? 0 : 1] = output.str().size();
+  }
+
+  if (bytes[1] >= bytes[0]) {
+    log << "rounding to two decimals produced " << bytes[1]
+        << " bytes, full precision " << bytes[0] << "\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testPath, testDraw)
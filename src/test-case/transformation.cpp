@@ -13,7 +13,9 @@
  * \see Licence Terms: https://github.com/ef-gy/libefgy/blob/master/COPYING
  */
 
+#include <cmath>
 #include <iostream>
+#include <type_traits>
 
 #include <ef.gy/test-case.h>
 #include <ef.gy/transformation.h>
@@ -158,4 +160,212 @@ int testAffineConstruction(std::ostream &log) {
   }
 }
 
-TEST_BATCH(testIdentity, testAffineConstruction)
+/**\brief Compare two matrices with a tolerance.
+ *
+ * \param a The first matrix.
+ * \param b The second matrix.
+ *
+ * \returns True if all the cells of a and b are close to each other.
+ */
+template <std::size_t n>
+static bool close(const efgy::math::matrix<double, n, n> &a,
+                  const efgy::math::matrix<double, n, n> &b) {
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t j = 0; j < n; j++) {
+      if (std::fabs(a[i][j] - b[i][j]) > 1e-9) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/* \brief Tests the elementary transformation kinds.
+ *
+ * \test Applies and composes translations, scales and plane rotations with
+ *     the specialised algorithms, and compares the results to those of the
+ *     general matrix code. Also checks the compile-time result kinds.
+ *
+ * \param log Stream for output messages
+ *
+ * \returns Zero if the test is successful, a nonzero integer otherwise.
+ */
+int testElementaryKinds(std::ostream &log) {
+  static_assert(
+      std::is_same<kind::compose<kind::translation, kind::translation>::type,
+                   kind::translation>::value,
+      "translations should compose to a translation");
+  static_assert(std::is_same<kind::compose<kind::scale, kind::rotation>::type,
+                             kind::linear>::value,
+                "scale and rotation should compose to a linear map");
+  static_assert(
+      std::is_same<kind::compose<kind::rotation, kind::translation>::type,
+                   kind::affine>::value,
+      "rotation and translation should compose to an affine map");
+  static_assert(std::is_same<kind::compose<kind::affine, kind::projective>::type,
+                             kind::projective>::value,
+                "projective maps should absorb everything");
+  static_assert(
+      std::is_same<decltype(translation<double, 4>({{1, 2, 3, 4}}) *
+                            translation<double, 4>({{1, 2, 3, 4}})),
+                   translation<double, 4>>::value,
+      "translations should compose to a translation");
+
+  static_assert(
+      std::is_same<decltype(rotation<double, 4>(1, 0, 1) *
+                            rotation<double, 4>(1, 1, 2))::classification,
+                   kind::linear>::value,
+      "rotations should compose to a linear map");
+  static_assert(std::is_same<decltype(scale<double, 4>(2) *
+                                      rotation<double, 4>(1, 0, 1) *
+                                      scale<double, 4>(2))::classification,
+                             kind::linear>::value,
+                "scales and rotations should compose to a linear map");
+  static_assert(
+      std::is_same<decltype(rotation<double, 4>(1, 0, 1) *
+                            translation<double, 4>({{1, 2, 3, 4}})),
+                   affine<double, 4>>::value,
+      "rotation and translation should compose to an affine map");
+
+  const efgy::math::vector<double, 4> v{{1, -2, 3, .5}};
+  const efgy::math::vector<double, 4> t{{.25, 1, -1, 2}};
+
+  const rotation<double, 4> r(0.7, 1, 3);
+  const scale<double, 4> s(1.5);
+  const translation<double, 4> tr(t);
+  affine<double, 4> g;
+  for (int i = 0; i < 4; i++) {
+    for (int k = 0; k < 5; k++) {
+      g.matrix[i][k] = (i == k) ? 2 : i - k * 0.25;
+    }
+  }
+
+  const affine<double, 4> ar = r, as = s, at = tr;
+
+  const auto rv = r * v, arv = ar * v;
+  const auto sv = s * v, asv = as * v;
+  const auto tv = tr * v, atv = at * v;
+
+  for (int i = 0; i < 4; i++) {
+    if (std::fabs(rv[i] - arv[i]) > 1e-9 || std::fabs(sv[i] - asv[i]) > 1e-9 ||
+        std::fabs(tv[i] - atv[i]) > 1e-9) {
+      log << "elementary application differs from matrix application\n";
+      return next_integer();
+    }
+  }
+
+  if (!close((r * g).matrix, (ar * g).matrix) ||
+      !close((g * r).matrix, (g * ar).matrix) ||
+      !close((s * g).matrix, (as * g).matrix) ||
+      !close((g * s).matrix, (g * as).matrix) ||
+      !close((tr * g).matrix, (at * g).matrix) ||
+      !close((g * tr).matrix, (g * at).matrix) ||
+      !close((r * tr).matrix, (ar * at).matrix) ||
+      !close((s * r).matrix, (as * ar).matrix) ||
+      !close((tr * tr).matrix, (at * at).matrix) ||
+      !close((s * s).matrix, (as * as).matrix)) {
+    log << "elementary composition differs from matrix composition\n";
+    return next_integer();
+  }
+
+  rotation<double, 4> edited(0.7, 1, 3);
+  scale<double, 4> doubled(1.5);
+  translation<double, 4> moved(t);
+  edited.matrix = rotation<double, 4>(0.2, 1, 3).matrix;
+  doubled.matrix = scale<double, 4>(2).matrix;
+  moved.matrix = translation<double, 4>(v).matrix;
+  const affine<double, 4> ae = edited, ad = doubled, am = moved;
+  const auto ev = edited * v, aev = ae * v;
+  const auto dv = doubled * v, adv = ad * v;
+  const auto mv = moved * v, amv = am * v;
+  for (int i = 0; i < 4; i++) {
+    if (std::fabs(ev[i] - aev[i]) > 1e-9 || std::fabs(dv[i] - adv[i]) > 1e-9 ||
+        std::fabs(mv[i] - amv[i]) > 1e-9) {
+      log << "elementary application ignores changes to the matrix\n";
+      return next_integer();
+    }
+  }
+  if (!close((edited * g).matrix, (ae * g).matrix) ||
+      !close((g * moved).matrix, (g * am).matrix) ||
+      !close((edited * doubled * edited).matrix, (ae * ad * ae).matrix)) {
+    log << "elementary composition ignores changes to the matrix\n";
+    return next_integer();
+  }
+
+  return 0;
+}
+
+/* \brief Checks inverses of one dimension.
+ *
+ * Creates a projective transformation in d dimensions and makes sure that its
+ * inverse undoes it, and that modifying the matrix of a transformation with a
+ * cached inverse invalidates that inverse.
+ *
+ * \tparam d Number of dimensions.
+ *
+ * \param log A stream for message output.
+ *
+ * \returns True if the inverse behaved as expected.
+ */
+template <std::size_t d> static bool checkInverse(std::ostream &log) {
+  invertible<projective<double, d>> p;
+  for (std::size_t i = 0; i <= d; i++) {
+    for (std::size_t k = 0; k <= d; k++) {
+      p.matrix[i][k] = (i == k) ? d : double((i * 3 + k) % 5) * 0.5 - 1;
+    }
+  }
+
+  efgy::math::matrix<double, d + 1, d + 1> e;
+  for (std::size_t a = 0; a <= d; a++) {
+    for (std::size_t b = 0; b <= d; b++) {
+      e[a][b] = a == b ? 1 : 0;
+    }
+  }
+
+  const projective<double, d> i = p.inverse();
+  if (!close((p * i).matrix, e) || !close(i.matrix, p.inverse().matrix)) {
+    log << "d=" << d << ": inverse does not undo the transformation\n";
+    return false;
+  }
+
+  p.matrix[1][0] = 4;
+  const projective<double, d> j = p.inverse();
+
+  if (close(i.matrix, j.matrix) || !close((p * j).matrix, e) ||
+      !close(j.matrix, projective<double, d>(p).inverse().matrix)) {
+    log << "d=" << d << ": inverse was not updated after modifying the "
+        << "matrix\n";
+    return false;
+  }
+
+  return true;
+}
+
+/* \brief Tests inverse transformations.
+ *
+ * \test Calculates inverses of projective transformations from 3 to 10
+ *     dimensions, and checks that a cached inverse is recalculated after the
+ *     transformation matrix changes.
+ *
+ * \param log A stream for message output.
+ *
+ * \returns Zero if the test was successful, a nonzero integer otherwise.
+ */
+int testInverse(std::ostream &log) {
+  static_assert(std::is_trivially_copyable<projective<double, 3>>::value,
+                "transformations should be trivially copyable");
+  static_assert(sizeof(affine<double, 3>) ==
+                    sizeof(efgy::math::matrix<double, 4, 4>),
+                "transformations should only hold their matrix");
+
+  if (!(checkInverse<3>(log) && checkInverse<4>(log) && checkInverse<5>(log) &&
+        checkInverse<6>(log) && checkInverse<7>(log) && checkInverse<8>(log) &&
+        checkInverse<9>(log) && checkInverse<10>(log))) {
+    return next_integer();
+  }
+
+  return 0;
+}
+
+TEST_BATCH(testIdentity, testAffineConstruction, testElementaryKinds,
+           testInverse)